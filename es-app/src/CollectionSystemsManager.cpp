@@ -38,6 +38,7 @@
 #include <fstream>
 #include <pugixml.hpp>
 #include <random>
+#include <unordered_set>
 
 #define INVALID_COLLECTION_CHARACTERS "*\",./:;<>\\|\n\t\r"
 
@@ -535,6 +536,113 @@ void CollectionSystemsManager::deleteCollectionFiles(FileData* file)
     }
 }
 
+void CollectionSystemsManager::addCollectionFiles(const std::vector<FileData*>& files)
+{
+    if (files.empty())
+        return;
+
+    for (auto& autoSystem : mAutoCollectionSystemsData) {
+        if (!autoSystem.second.isPopulated)
+            continue;
+
+        SystemData* curSys {autoSystem.second.system};
+        FileData* rootFolder {curSys->getRootFolder()};
+        const std::unordered_map<std::string, FileData*>& children {
+            rootFolder->getChildrenByFilename()};
+        bool addedGames {false};
+
+        for (auto file : files) {
+            if (children.find(file->getFullPath()) != children.cend() ||
+                !includeFileInAutoCollection(file, autoSystem.second.decl))
+                continue;
+            CollectionFileData* newGame {new CollectionFileData(file, curSys)};
+            rootFolder->addChild(newGame);
+            curSys->getIndex()->addToIndex(newGame);
+            addedGames = true;
+        }
+
+        if (!addedGames)
+            continue;
+
+        if (rootFolder->getName() == "recent") {
+            rootFolder->sort(rootFolder->getSortTypeFromString("last played, ascending"));
+            trimCollectionCount(rootFolder, LAST_PLAYED_MAX);
+        }
+        else {
+            rootFolder->sort(rootFolder->getSortTypeFromString(rootFolder->getSortTypeString()),
+                             Settings::getInstance()->getBool("FavoritesFirst"));
+        }
+        ViewController::getInstance()->onFileChanged(rootFolder, true);
+    }
+
+#if defined(_WIN64)
+    std::string rompath {Utils::String::replace(FileData::getROMDirectory(), "\\", "/")};
+#else
+    std::string rompath {FileData::getROMDirectory()};
+#endif
+    rompath = Utils::String::replace(rompath, "//", "/");
+
+    for (auto& customSystem : mCustomCollectionSystemsData) {
+        if (!customSystem.second.isPopulated)
+            continue;
+
+        const std::string path {getCustomCollectionConfigPath(customSystem.first)};
+        if (!Utils::FileSystem::exists(path))
+            continue;
+
+        // Read the configuration file once for all the games, in the same manner as when
+        // populating the collection.
+#if defined(_WIN64)
+        std::ifstream input {Utils::String::stringToWideString(path).c_str()};
+#else
+        std::ifstream input {path};
+#endif
+        std::unordered_set<std::string> gameKeys;
+        for (std::string gameKey; getline(input, gameKey);) {
+            gameKey = Utils::String::replace(gameKey, "\r", "");
+            gameKey = Utils::String::replace(gameKey, "%ROMPATH%", rompath);
+            gameKey = Utils::String::replace(gameKey, "//", "/");
+            gameKeys.emplace(gameKey);
+        }
+
+        if (input.is_open())
+            input.close();
+
+        SystemData* curSys {customSystem.second.system};
+        FileData* rootFolder {curSys->getRootFolder()};
+        const std::unordered_map<std::string, FileData*>& children {
+            rootFolder->getChildrenByFilename()};
+        bool addedGames {false};
+
+        for (auto file : files) {
+            if (gameKeys.find(file->getFullPath()) == gameKeys.cend() ||
+                children.find(file->getFullPath()) != children.cend() || !file->getCountAsGame())
+                continue;
+            CollectionFileData* newGame {new CollectionFileData(file, curSys)};
+            rootFolder->addChild(newGame);
+            curSys->getIndex()->addToIndex(newGame);
+            addedGames = true;
+        }
+
+        if (!addedGames)
+            continue;
+
+        const bool favoritesSorting {Settings::getInstance()->getBool("FavFirstCustom")};
+        rootFolder->sort(rootFolder->getSortTypeFromString(rootFolder->getSortTypeString()),
+                         favoritesSorting);
+        // Grouped custom collections are displayed inside the collections bundle.
+        if (curSys->isGroupedCustomCollection()) {
+            rootFolder->getParent()->sort(rootFolder->getParent()->getSortTypeFromString(
+                                              rootFolder->getParent()->getSortTypeString()),
+                                          favoritesSorting);
+            ViewController::getInstance()->onFileChanged(rootFolder->getParent(), true);
+        }
+        else {
+            ViewController::getInstance()->onFileChanged(rootFolder, true);
+        }
+    }
+}
+
 const bool CollectionSystemsManager::isThemeGenericCollectionCompatible(
     bool genericCustomCollections)
 {
@@ -1260,29 +1368,7 @@ void CollectionSystemsManager::populateAutoCollection(CollectionSystemData* sysD
         if ((*sysIt)->isGameSystem() && !(*sysIt)->isCollection()) {
             std::vector<FileData*> files = (*sysIt)->getRootFolder()->getFilesRecursive(GAME);
             for (auto gameIt = files.cbegin(); gameIt != files.cend(); ++gameIt) {
-                bool include {includeFileInAutoCollections((*gameIt))};
-
-                switch (sysDecl.type) {
-                    case AUTO_LAST_PLAYED: {
-                        include = include && (*gameIt)->metadata.get("playcount") > "0";
-                        break;
-                    }
-                    case AUTO_FAVORITES: {
-                        // We may still want to add files we don't want in auto collections
-                        // to "favorites".
-                        include = (*gameIt)->metadata.get("favorite") == "true";
-                        break;
-                    }
-                    default: {
-                        break;
-                    }
-                }
-
-                if (include) {
-                    // Exclude files that are set not to be counted as games.
-                    if (!(*gameIt)->getCountAsGame())
-                        continue;
-
+                if (includeFileInAutoCollection(*gameIt, sysDecl)) {
                     CollectionFileData* newGame {new CollectionFileData(*gameIt, newSys)};
                     rootFolder->addChild(newGame);
                     index->addToIndex(newGame);
@@ -1680,6 +1766,27 @@ const bool CollectionSystemsManager::includeFileInAutoCollections(FileData* file
     return file->getSystem()->isGameSystem();
 }
 
+const bool CollectionSystemsManager::includeFileInAutoCollection(
+    FileData* file, const CollectionSystemDecl& sysDecl)
+{
+    // Exclude files that are set not to be counted as games.
+    if (!file->getCountAsGame())
+        return false;
+
+    switch (sysDecl.type) {
+        case AUTO_LAST_PLAYED: {
+            return includeFileInAutoCollections(file) && file->metadata.get("playcount") > "0";
+        }
+        case AUTO_FAVORITES: {
+            // We may still want to add files we don't want in auto collections to "favorites".
+            return file->metadata.get("favorite") == "true";
+        }
+        default: {
+            return includeFileInAutoCollections(file);
+        }
+    }
+}
+
 std::string CollectionSystemsManager::getCustomCollectionConfigPath(
     const std::string& collectionName)
 {
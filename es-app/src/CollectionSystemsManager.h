@@ -97,6 +97,9 @@ public:
     void updateCollectionSystem(FileData* file, CollectionSystemData sysData);
     // Delete all collection files from all collection systems related to the source file.
     void deleteCollectionFiles(FileData* file);
+    // Add games that have been added to their systems after the collections were populated,
+    // to all populated collections that they belong to.
+    void addCollectionFiles(const std::vector<FileData*>& files);
 
     // Return whether the current theme is compatible with Automatic or Custom Collections.
     const bool isThemeGenericCollectionCompatible(bool genericCustomCollections);
@@ -193,6 +196,8 @@ private:
     // Return whether a specific folder exists in the theme.
     const bool themeFolderExists(const std::string& folder);
     const bool includeFileInAutoCollections(FileData* file);
+    // Whether the game belongs in the automatic collection with the specified declaration.
+    const bool includeFileInAutoCollection(FileData* file, const CollectionSystemDecl& sysDecl);
 
     std::string getCustomCollectionConfigPath(const std::string& collectionName);
     std::string getCollectionsFolder();
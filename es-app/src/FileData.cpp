@@ -16,6 +16,7 @@
 #include "FileSorts.h"
 #include "Log.h"
 #include "MameNames.h"
+#include "MediaManifest.h"
 #include "Scripting.h"
 #include "SystemData.h"
 #include "UIModeController.h"
@@ -51,6 +52,8 @@ FileData::FileData(FileType type,
     , mDeletionFlag {false}
     , mNoLoad {false}
 {
+    metadata.setFileData(this);
+
     // Metadata needs at least a name field (since that's what getName() will return).
     if ((system->hasPlatformId(PlatformIds::ARCADE) ||
          system->hasPlatformId(PlatformIds::SNK_NEO_GEO)) &&
@@ -78,6 +81,16 @@ FileData::~FileData()
         mParent->removeChild(this);
 }
 
+void FileData::invalidateRandomGameCandidates()
+{
+    // Grouped custom collections are placed inside the collections bundle, so the systems
+    // of all the parent folders are affected as well.
+    for (FileData* folder {this}; folder != nullptr; folder = folder->mParent) {
+        if (folder->mSystem != nullptr)
+            folder->mSystem->invalidateRandomGameCandidates();
+    }
+}
+
 const std::string& FileData::getSortName()
 {
     if (mSystem->isCustomCollection() && mType == GAME) {
@@ -219,17 +232,10 @@ const std::string FileData::getMediafilePath(const std::string& subdirectory) co
         subFolders =
             Utils::String::replace(Utils::FileSystem::getParent(mPath), mEnvData->mStartPath, "");
 
-    const std::string tempPath {getMediaDirectory() + mSystemName + "/" + subdirectory +
-                                subFolders + "/" + getDisplayName()};
-
     // Look for an image file in the media directory.
-    for (auto& extension : sImageExtensions) {
-        const std::string mediaPath {tempPath + extension};
-        if (Utils::FileSystem::exists(mediaPath))
-            return mediaPath;
-    }
-
-    return "";
+    return MediaManifest::getInstance().findFile(
+        getMediaDirectory() + mSystemName + "/" + subdirectory + subFolders, getDisplayName(),
+        sImageExtensions);
 }
 
 const std::string FileData::getImagePath() const
@@ -323,17 +329,10 @@ const std::string FileData::getVideoPath() const
         subFolders =
             Utils::String::replace(Utils::FileSystem::getParent(mPath), mEnvData->mStartPath, "");
 
-    const std::string tempPath {getMediaDirectory() + mSystemName + "/videos" + subFolders + "/" +
-                                getDisplayName()};
-
     // Look for media in the media directory.
-    for (auto& extension : sVideoExtensions) {
-        const std::string mediaPath {tempPath + extension};
-        if (Utils::FileSystem::exists(mediaPath))
-            return mediaPath;
-    }
-
-    return "";
+    return MediaManifest::getInstance().findFile(
+        getMediaDirectory() + mSystemName + "/videos" + subFolders, getDisplayName(),
+        sVideoExtensions);
 }
 
 const std::string FileData::getManualPath() const
@@ -346,17 +345,9 @@ const std::string FileData::getManualPath() const
         subFolders =
             Utils::String::replace(Utils::FileSystem::getParent(mPath), mEnvData->mStartPath, "");
 
-    const std::string tempPath {getMediaDirectory() + mSystemName + "/manuals" + subFolders + "/" +
-                                getDisplayName()};
-
     // Look for manuals in the media directory.
-    for (size_t i {0}; i < extList.size(); ++i) {
-        std::string mediaPath {tempPath + extList[i]};
-        if (Utils::FileSystem::exists(mediaPath))
-            return mediaPath;
-    }
-
-    return "";
+    return MediaManifest::getInstance().findFile(
+        getMediaDirectory() + mSystemName + "/manuals" + subFolders, getDisplayName(), extList);
 }
 
 const std::vector<FileData*>& FileData::getChildrenListToDisplay()
@@ -467,6 +458,7 @@ void FileData::addChild(FileData* file)
         mChildrenByFilename[key] = file;
         mChildren.emplace_back(file);
         file->mParent = this;
+        invalidateRandomGameCandidates();
     }
 }
 
@@ -479,6 +471,7 @@ void FileData::removeChild(FileData* file)
         if (*it == file) {
             file->mParent = nullptr;
             mChildren.erase(it);
+            invalidateRandomGameCandidates();
             return;
         }
     }
@@ -508,15 +501,20 @@ void FileData::sort(ComparisonFunction& comparator,
             // Gamelist::parseGamelist() and this code should only run when a user has marked
             // an entry manually as hidden. So upon the next application startup, this game
             // should be filtered already at that earlier point.
-            if ((*it)->getHidden())
+            if ((*it)->getHidden()) {
                 it = mChildren.erase(it);
+                invalidateRandomGameCandidates();
+            }
             // Also hide folders where all its entries have been hidden, unless it's a
             // grouped custom collection.
             else if ((*it)->getType() == FOLDER && (*it)->getChildren().size() == 0 &&
-                     !(*it)->getSystem()->isGroupedCustomCollection())
+                     !(*it)->getSystem()->isGroupedCustomCollection()) {
                 it = mChildren.erase(it);
-            else
+                invalidateRandomGameCandidates();
+            }
+            else {
                 ++it;
+            }
         }
     }
 
@@ -2113,10 +2111,13 @@ returnValue = Utils::Platform::launchGameUnix(command, startDirectory, runInBack
 
     // If the cursor is on a folder then a folder link must have been configured, so set the
     // lastplayed timestamp for this folder to the same as the launched game.
+    std::vector<FileData*> updatedFiles {gameToUpdate};
     FileData* cursor {
         ViewController::getInstance()->getGamelistView(gameToUpdate->getSystem())->getCursor()};
-    if (cursor->getType() == FOLDER)
+    if (cursor->getType() == FOLDER) {
         cursor->metadata.set("lastplayed", gameToUpdate->metadata.get("lastplayed"));
+        updatedFiles.emplace_back(cursor);
+    }
 
     // If the parent is a folder and it's not the root of the system, then update its lastplayed
     // timestamp to the same time as the game that was just launched.
@@ -2124,6 +2125,8 @@ returnValue = Utils::Platform::launchGameUnix(command, startDirectory, runInBack
         gameToUpdate->getParent()->getName() != gameToUpdate->getSystem()->getFullName()) {
         gameToUpdate->getParent()->metadata.set("lastplayed",
                                                 gameToUpdate->metadata.get("lastplayed"));
+        if (gameToUpdate->getParent() != cursor)
+            updatedFiles.emplace_back(gameToUpdate->getParent());
     }
 
     // We make an explicit call to close the launch screen instead of waiting for
@@ -2133,7 +2136,7 @@ returnValue = Utils::Platform::launchGameUnix(command, startDirectory, runInBack
     window->closeLaunchScreen();
 
     CollectionSystemsManager::getInstance()->refreshCollectionSystems(gameToUpdate);
-    gameToUpdate->mSystem->onMetaDataSavePoint();
+    gameToUpdate->mSystem->onStatisticsSavePoint(updatedFiles);
 }
 
 const std::pair<std::string, FileData::findEmulatorResult> FileData::findEmulator(
@@ -101,6 +101,8 @@ public:
     void setNoLoad(bool state) { mNoLoad = state; }
     const bool isPlaceHolder() const { return mType == PLACEHOLDER; }
     void refreshMetadata() { metadata = mSourceFileData->metadata; }
+    // Called when the entry's children or its hidden, kidgame or nogamecount values change.
+    void invalidateRandomGameCandidates();
 
     const std::vector<FileData*>& getChildrenListToDisplay();
     std::vector<FileData*> getFilesRecursive(unsigned int typeMask,
@@ -0,0 +1,121 @@
+//  SPDX-License-Identifier: MIT
+//
+//  ES-DE Frontend
+//  GameDirectoryUpdater.cpp
+//
+//  Reads changed game directories again and applies any added or removed games to the
+//  systems, the collections and the views. Used by the game directory watcher as well as
+//  when rescanning the game directories from the menu.
+//
+
+#include "GameDirectoryUpdater.h"
+
+#include "CollectionSystemsManager.h"
+#include "FileData.h"
+#include "Log.h"
+#include "MediaManifest.h"
+#include "SystemData.h"
+#include "views/ViewController.h"
+
+namespace
+{
+    bool isInsideDirectory(const std::string& path, const std::string& directory)
+    {
+        return path.compare(0, directory.length(), directory) == 0 &&
+               (path.length() == directory.length() || path[directory.length()] == '/');
+    }
+
+} // namespace
+
+namespace GameDirectoryUpdater
+{
+    void updateDirectories(const std::vector<std::string>& changedDirectories)
+    {
+        const std::string& mediaDirectory {FileData::getMediaDirectory()};
+        std::vector<SystemData*> changedSystems;
+        std::vector<SystemData*> changedMediaSystems;
+        std::vector<FileData*> addedGames;
+        std::vector<FileData*> removedFiles;
+
+        for (auto system : SystemData::sSystemVector) {
+            if (system->isCollection())
+                continue;
+
+            const std::string& systemMediaDirectory {mediaDirectory + system->getName()};
+            std::vector<std::string> directories;
+            bool mediaChanged {false};
+
+            for (auto& directory : changedDirectories) {
+                if (isInsideDirectory(directory, system->getStartPath()))
+                    directories.emplace_back(directory);
+                if (isInsideDirectory(directory, systemMediaDirectory)) {
+                    MediaManifest::getInstance().invalidate(directory);
+                    mediaChanged = true;
+                }
+            }
+
+            const size_t addedCount {addedGames.size()};
+            const size_t removedCount {removedFiles.size()};
+
+            if (!directories.empty())
+                system->updateFolders(directories, addedGames, removedFiles);
+
+            if (addedGames.size() != addedCount || removedFiles.size() != removedCount)
+                changedSystems.emplace_back(system);
+            else if (mediaChanged)
+                changedMediaSystems.emplace_back(system);
+        }
+
+        if (changedSystems.empty() && changedMediaSystems.empty())
+            return;
+
+        std::vector<FileData*> removedGames;
+        for (auto file : removedFiles) {
+            if (file->getType() == GAME) {
+                removedGames.emplace_back(file);
+            }
+            else {
+                const std::vector<FileData*>& games {file->getFilesRecursive(GAME)};
+                removedGames.insert(removedGames.end(), games.cbegin(), games.cend());
+            }
+        }
+
+        for (auto game : removedGames)
+            CollectionSystemsManager::getInstance()->deleteCollectionFiles(game);
+        CollectionSystemsManager::getInstance()->addCollectionFiles(addedGames);
+
+        // The gamelist views reference the removed entries until they have been reloaded.
+        for (auto system : changedSystems)
+            ViewController::getInstance()->onFileChanged(system->getRootFolder(), true);
+        for (auto system : changedMediaSystems)
+            ViewController::getInstance()->onFileChanged(system->getRootFolder(), false);
+
+        // The lists of last played and most played games of the collections still contain
+        // the removed collection entries, and the game selectors of the system view could
+        // reference any removed game. The lists of the game systems were updated when sorting.
+        if (!changedSystems.empty()) {
+            std::vector<SystemData*> updatedSystems {changedSystems};
+            for (auto system : SystemData::sSystemVector) {
+                if (!system->isCollection())
+                    continue;
+                system->getRootFolder()->updateLastPlayedList();
+                system->getRootFolder()->updateMostPlayedList();
+                updatedSystems.emplace_back(system);
+            }
+            ViewController::getInstance()->getSystemListView()->refreshGameSelectors(
+                updatedSystems);
+        }
+
+        for (auto file : removedFiles)
+            delete file;
+
+        if (!changedSystems.empty()) {
+            LOG(LogInfo) << "Game directories changed, added " << addedGames.size()
+                         << (addedGames.size() == 1 ? " game" : " games") << " and removed "
+                         << removedGames.size() << (removedGames.size() == 1 ? " game" : " games")
+                         << " in " << changedSystems.size()
+                         << (changedSystems.size() == 1 ? " system" : " systems");
+        }
+    }
+
+} // namespace GameDirectoryUpdater
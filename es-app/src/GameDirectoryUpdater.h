@@ -0,0 +1,27 @@
+//  SPDX-License-Identifier: MIT
+//
+//  ES-DE Frontend
+//  GameDirectoryUpdater.h
+//
+//  Reads changed game directories again and applies any added or removed games to the
+//  systems, the collections and the views. Used by the game directory watcher as well as
+//  when rescanning the game directories from the menu.
+//
+
+#ifndef ES_APP_GAME_DIRECTORY_UPDATER_H
+#define ES_APP_GAME_DIRECTORY_UPDATER_H
+
+#include <string>
+#include <vector>
+
+namespace GameDirectoryUpdater
+{
+    // Brings the systems up to date with the specified directories, which can be game
+    // directories as well as media directories. The removed entries are deleted only after
+    // they are no longer referenced by the collections, the gamelist views or the game
+    // selectors of the system view.
+    void updateDirectories(const std::vector<std::string>& changedDirectories);
+
+} // namespace GameDirectoryUpdater
+
+#endif // ES_APP_GAME_DIRECTORY_UPDATER_H
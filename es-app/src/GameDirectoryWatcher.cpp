@@ -0,0 +1,125 @@
+//  SPDX-License-Identifier: MIT
+//
+//  ES-DE Frontend
+//  GameDirectoryWatcher.cpp
+//
+//  Watches the game system directories and the game media directories while the application
+//  is running, and updates the affected systems, collections and gamelist views when games or
+//  media files are added or removed. This avoids having to rescan the ROM directory.
+//
+
+#include "GameDirectoryWatcher.h"
+
+#include "FileData.h"
+#include "GameDirectoryUpdater.h"
+#include "Log.h"
+#include "SystemData.h"
+#include "Window.h"
+#include "views/ViewController.h"
+
+#include <algorithm>
+
+namespace
+{
+    // How often to check for changes.
+    constexpr int POLL_INTERVAL {250};
+    // Copying a number of files generates a burst of changes, so these are applied together
+    // once no further changes have been made for this long.
+    constexpr int SETTLE_TIME {500};
+    // The number of directories to start watching per frame, as reading the game directories
+    // would otherwise stall the application for a while with large collections.
+    constexpr size_t WATCHES_PER_UPDATE {32};
+
+} // namespace
+
+GameDirectoryWatcher::GameDirectoryWatcher()
+    : mWatchesQueued {false}
+    , mWatchesAdded {false}
+    , mPollTimer {0}
+    , mQuietTime {0}
+{
+}
+
+void GameDirectoryWatcher::update(int deltaTime)
+{
+    if (!mWatchesQueued) {
+        // Adding the watches requires reading all the game directories, so it's done once
+        // the application has started rather than delaying the startup.
+        if (ViewController::getInstance()->getState().viewing ==
+            ViewController::ViewMode::NOTHING)
+            return;
+        queueWatches();
+        mWatchesQueued = true;
+    }
+
+    // This also adds the watches for the subdirectories of newly created directories.
+    if (mFileWatcher.addPendingDirectories(WATCHES_PER_UPDATE) && !mWatchesAdded) {
+        LOG(LogInfo) << "Watching the game system and media directories for changes";
+        mWatchesAdded = true;
+    }
+
+    if (!mWatchesAdded)
+        return;
+
+    mPollTimer += deltaTime;
+    if (mPollTimer < POLL_INTERVAL)
+        return;
+
+    const std::vector<std::string>& changedDirectories {mFileWatcher.getChangedDirectories()};
+
+    if (changedDirectories.empty()) {
+        mQuietTime = std::min(mQuietTime + mPollTimer, SETTLE_TIME);
+    }
+    else {
+        mChangedDirectories.insert(mChangedDirectories.end(), changedDirectories.cbegin(),
+                                   changedDirectories.cend());
+        std::sort(mChangedDirectories.begin(), mChangedDirectories.end());
+        mChangedDirectories.erase(
+            std::unique(mChangedDirectories.begin(), mChangedDirectories.end()),
+            mChangedDirectories.end());
+        mQuietTime = 0;
+    }
+
+    mPollTimer = 0;
+
+    if (mChangedDirectories.empty() || mQuietTime < SETTLE_TIME || !isIdle())
+        return;
+
+    applyChanges();
+}
+
+void GameDirectoryWatcher::queueWatches()
+{
+    for (auto system : SystemData::sSystemVector) {
+        if (!system->isCollection())
+            mFileWatcher.addDirectory(system->getStartPath());
+    }
+
+    // The whole media directory is watched as the directories for the individual systems
+    // are normally not created until media has been scraped.
+    const std::string& mediaDirectory {FileData::getMediaDirectory()};
+    mFileWatcher.addDirectory(mediaDirectory.substr(0, mediaDirectory.length() - 1));
+}
+
+const bool GameDirectoryWatcher::isIdle()
+{
+    Window* window {Window::getInstance()};
+    ViewController* viewController {ViewController::getInstance()};
+
+    // Any menu or dialog that is open could reference the entries that are about to be
+    // removed, so the changes are only applied when only the ViewController is shown. The
+    // game selectors of the system view reference the entries as well, so a gamelist has
+    // to be shown.
+    return window->getGuiStackSize() == 1 && !window->isScreensaverActive() &&
+           !window->isMediaViewerActive() && !window->isPDFViewerActive() &&
+           !window->isLaunchScreenDisplayed() && !window->getGameLaunchedState() &&
+           !viewController->isAnimating() &&
+           viewController->getState().viewing == ViewController::ViewMode::GAMELIST;
+}
+
+void GameDirectoryWatcher::applyChanges()
+{
+    std::vector<std::string> changedDirectories;
+    changedDirectories.swap(mChangedDirectories);
+    GameDirectoryUpdater::updateDirectories(changedDirectories);
+}
@@ -0,0 +1,42 @@
+//  SPDX-License-Identifier: MIT
+//
+//  ES-DE Frontend
+//  GameDirectoryWatcher.h
+//
+//  Watches the game system directories and the game media directories while the application
+//  is running, and updates the affected systems, collections and gamelist views when games or
+//  media files are added or removed. This avoids having to rescan the ROM directory.
+//
+
+#ifndef ES_APP_GAME_DIRECTORY_WATCHER_H
+#define ES_APP_GAME_DIRECTORY_WATCHER_H
+
+#include "FileWatcher.h"
+
+#include <string>
+#include <vector>
+
+class GameDirectoryWatcher
+{
+public:
+    GameDirectoryWatcher();
+
+    // Polls for changes and applies them once no more changes have been made for a short
+    // while and a gamelist is shown without anything on top of it, i.e. when the changes
+    // will not disturb the user.
+    void update(int deltaTime);
+
+private:
+    void queueWatches();
+    const bool isIdle();
+    void applyChanges();
+
+    FileWatcher mFileWatcher;
+    std::vector<std::string> mChangedDirectories;
+    bool mWatchesQueued;
+    bool mWatchesAdded;
+    int mPollTimer;
+    int mQuietTime;
+};
+
+#endif // ES_APP_GAME_DIRECTORY_WATCHER_H
@@ -17,6 +17,938 @@
 
 #include <pugixml.hpp>
 
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+namespace
+{
+    // The journal is compacted into gamelist.xml when it has grown to this many records.
+    constexpr int MAX_JOURNAL_RECORDS {100};
+
+    // The number of records appended to each journal since it was last compacted.
+    std::map<std::string, int> journalRecords;
+
+    std::string getJournalPath(const std::string& gamelistPath)
+    {
+        return Utils::FileSystem::getParent(gamelistPath) + "/gamelist_statistics.journal";
+    }
+
+    // The journal is moved to this file when a gamelist.xml write is queued, and it's removed
+    // once the write has completed so that no records are lost if the application crashes.
+    std::string getPendingJournalPath(const std::string& journalPath)
+    {
+        return journalPath + ".pending";
+    }
+
+    struct GamelistEntry {
+        std::string path;
+        std::string tag;
+        // An empty node means that the entry is only removed from the gamelist.xml file.
+        pugi::xml_node node;
+        bool deleted;
+    };
+
+    // The changes for a single gamelist.xml file, these are copied from the FileData objects
+    // on the main thread so the writer thread never needs to access them.
+    struct GamelistUpdate {
+        std::string systemName;
+        std::string startPath;
+        std::string readPath;
+        std::string writePath;
+        bool updateAlternativeEmulator;
+        std::string alternativeEmulator;
+        std::string defaultEmulator;
+        std::string journalPath;
+        pugi::xml_document nodes;
+        std::vector<GamelistEntry> entries;
+    };
+
+    class GamelistWriter
+    {
+    public:
+        GamelistWriter()
+        {
+            // The writer lives until the application exits, see getWriter().
+            std::thread(&GamelistWriter::writerThread, this).detach();
+        }
+
+        void queueUpdate(std::unique_ptr<GamelistUpdate> update)
+        {
+            std::unique_lock<std::mutex> lock {mMutex};
+
+            // This is done while holding the lock so the writer thread can't remove the pending
+            // journal in between.
+            if (update->journalPath != "")
+                rotateJournal(update->journalPath);
+
+            const std::string writePath {update->writePath};
+            auto it = mQueue.find(writePath);
+            if (it == mQueue.end()) {
+                mQueue[writePath] = std::move(update);
+                mQueueCondition.notify_one();
+                return;
+            }
+
+            // Coalesce the save points that were not written yet, the newest entry wins.
+            GamelistUpdate& queued {*(*it).second};
+            std::unordered_map<std::string, size_t> entryIndex;
+            for (size_t i {0}; i < queued.entries.size(); ++i)
+                entryIndex[queued.entries[i].path] = i;
+
+            for (auto& entry : update->entries) {
+                pugi::xml_node node;
+                if (entry.node)
+                    node = queued.nodes.append_copy(entry.node);
+
+                auto indexIt = entryIndex.find(entry.path);
+                if (indexIt == entryIndex.end()) {
+                    entryIndex[entry.path] = queued.entries.size();
+                    queued.entries.emplace_back(
+                        GamelistEntry {entry.path, entry.tag, node, entry.deleted});
+                    continue;
+                }
+
+                GamelistEntry& queuedEntry {queued.entries[(*indexIt).second]};
+                if (queuedEntry.node)
+                    queued.nodes.remove_child(queuedEntry.node);
+                queuedEntry.tag = entry.tag;
+                queuedEntry.node = node;
+                queuedEntry.deleted = entry.deleted;
+            }
+
+            queued.systemName = update->systemName;
+            queued.journalPath = update->journalPath;
+            queued.startPath = update->startPath;
+            queued.readPath = update->readPath;
+            if (update->updateAlternativeEmulator) {
+                queued.updateAlternativeEmulator = true;
+                queued.alternativeEmulator = update->alternativeEmulator;
+                queued.defaultEmulator = update->defaultEmulator;
+            }
+        }
+
+        // Waits for all queued writes, or only for the write to writePath if it's not empty.
+        void flush(const std::string& writePath = "")
+        {
+            std::unique_lock<std::mutex> lock {mMutex};
+            mWrittenCondition.wait(lock, [this, &writePath] {
+                if (writePath == "")
+                    return mQueue.empty() && mWritingPath == "";
+                return mQueue.find(writePath) == mQueue.cend() && mWritingPath != writePath;
+            });
+        }
+
+    private:
+        void writerThread()
+        {
+            while (true) {
+                std::unique_ptr<GamelistUpdate> update;
+                {
+                    std::unique_lock<std::mutex> lock {mMutex};
+                    mQueueCondition.wait(lock, [this] { return !mQueue.empty(); });
+                    update = std::move((*mQueue.begin()).second);
+                    mQueue.erase(mQueue.begin());
+                    mWritingPath = update->writePath;
+                }
+
+                const bool success {writeGamelist(*update)};
+
+                std::unique_lock<std::mutex> lock {mMutex};
+                // If another update has been queued for the same file then the pending journal
+                // also contains records that have not been written yet.
+                if (success && update->journalPath != "" &&
+                    mQueue.find(update->writePath) == mQueue.cend()) {
+                    const std::string pendingPath {getPendingJournalPath(update->journalPath)};
+                    if (Utils::FileSystem::exists(pendingPath))
+                        Utils::FileSystem::removeFile(pendingPath);
+                }
+                mWritingPath = "";
+                mWrittenCondition.notify_all();
+            }
+        }
+
+        void rotateJournal(const std::string& journalPath)
+        {
+            if (!Utils::FileSystem::exists(journalPath))
+                return;
+
+            if (Utils::FileSystem::getFileSize(journalPath) == 0) {
+                Utils::FileSystem::removeFile(journalPath);
+                return;
+            }
+
+            const std::string pendingPath {getPendingJournalPath(journalPath)};
+
+            if (!Utils::FileSystem::exists(pendingPath)) {
+                if (Utils::FileSystem::renameFile(journalPath, pendingPath, false)) {
+                    LOG(LogError) << "Couldn't rename statistics journal \"" << journalPath
+                                  << "\"";
+                }
+                return;
+            }
+
+            // A previous write has not completed yet, so add the records to its journal.
+            std::ifstream journal;
+            std::ofstream pendingJournal;
+#if defined(_WIN64)
+            journal.open(Utils::String::stringToWideString(journalPath).c_str(),
+                         std::ios::binary);
+            pendingJournal.open(Utils::String::stringToWideString(pendingPath).c_str(),
+                                std::ios::binary | std::ios::app);
+#else
+            journal.open(journalPath.c_str(), std::ios::binary);
+            pendingJournal.open(pendingPath.c_str(), std::ios::binary | std::ios::app);
+#endif
+            if (journal.good() && pendingJournal.good()) {
+                pendingJournal << journal.rdbuf();
+                pendingJournal.close();
+                journal.close();
+                if (!pendingJournal.fail())
+                    Utils::FileSystem::removeFile(journalPath);
+            }
+        }
+
+        bool writeGamelist(const GamelistUpdate& update)
+        {
+            pugi::xml_document doc;
+            pugi::xml_node root;
+            bool hasAlternativeEmulatorTag {false};
+
+            if (Utils::FileSystem::exists(update.readPath) &&
+                Utils::FileSystem::getFileSize(update.readPath) != 0) {
+                // Parse an existing file first.
+
+#if defined(_WIN64)
+                const pugi::xml_parse_result& result {
+                    doc.load_file(Utils::String::stringToWideString(update.readPath).c_str())};
+#else
+                const pugi::xml_parse_result& result {doc.load_file(update.readPath.c_str())};
+#endif
+
+                if (!result) {
+                    LOG(LogError) << "Error parsing gamelist file \"" << update.readPath
+                                  << "\": " << result.description();
+                    return false;
+                }
+
+                root = doc.child("gameList");
+                if (!root) {
+                    LOG(LogError) << "Couldn't find <gameList> node in gamelist \""
+                                  << update.readPath << "\"";
+                    return false;
+                }
+                if (update.updateAlternativeEmulator) {
+                    pugi::xml_node alternativeEmulator {doc.child("alternativeEmulator")};
+
+                    if (alternativeEmulator)
+                        hasAlternativeEmulatorTag = true;
+
+                    if (update.alternativeEmulator != "") {
+                        if (!alternativeEmulator) {
+                            doc.prepend_child("alternativeEmulator");
+                            alternativeEmulator = doc.child("alternativeEmulator");
+                        }
+
+                        const pugi::xml_node& label {alternativeEmulator.child("label")};
+
+                        if (label && update.alternativeEmulator !=
+                                         alternativeEmulator.child("label").text().get()) {
+                            alternativeEmulator.remove_child(label);
+                            alternativeEmulator.prepend_child("label").text().set(
+                                update.alternativeEmulator.c_str());
+                        }
+                        else if (!label) {
+                            alternativeEmulator.prepend_child("label").text().set(
+                                update.alternativeEmulator.c_str());
+                        }
+                    }
+                    else if (alternativeEmulator) {
+                        doc.remove_child("alternativeEmulator");
+                    }
+                }
+            }
+            else {
+                if (update.updateAlternativeEmulator && update.alternativeEmulator != "") {
+                    pugi::xml_node alternativeEmulator {doc.prepend_child("alternativeEmulator")};
+                    alternativeEmulator.prepend_child("label").text().set(
+                        update.alternativeEmulator.c_str());
+                }
+                // Set up an empty gamelist to append to.
+                root = doc.append_child("gameList");
+            }
+
+            int numUpdated {0};
+
+            for (auto& entry : update.entries) {
+                const std::string& gamePath {Utils::FileSystem::getCanonicalPath(entry.path)};
+
+                // Check if the file already exists in the XML file.
+                // If it does, remove the entry before adding it back.
+                for (pugi::xml_node fileNode {root.child(entry.tag.c_str())}; fileNode;
+                     fileNode = fileNode.next_sibling(entry.tag.c_str())) {
+                    const pugi::xml_node& pathNode {fileNode.child("path")};
+                    if (!pathNode) {
+                        LOG(LogError) << "<" << entry.tag << "> node contains no <path> child";
+                        continue;
+                    }
+
+                    const std::string& nodePath {
+                        Utils::FileSystem::getCanonicalPath(Utils::FileSystem::resolveRelativePath(
+                            pathNode.text().get(), update.startPath, true))};
+
+                    if (nodePath == gamePath) {
+                        // Found it
+                        root.remove_child(fileNode);
+                        if (entry.deleted)
+                            ++numUpdated;
+                        break;
+                    }
+                }
+
+                if (!entry.deleted) {
+                    if (entry.node)
+                        root.append_copy(entry.node);
+                    ++numUpdated;
+                }
+            }
+
+            // Now write the file.
+            if (numUpdated == 0 && !update.updateAlternativeEmulator)
+                return true;
+
+            // Make sure the folders leading up to this path exist (or the write will fail).
+            Utils::FileSystem::createDirectory(Utils::FileSystem::getParent(update.writePath));
+
+            if (update.updateAlternativeEmulator) {
+                if (hasAlternativeEmulatorTag && update.alternativeEmulator == "") {
+                    LOG(LogDebug) << "GamelistFileParser::updateGamelist(): Removed the "
+                                     "alternativeEmulator tag for system \""
+                                  << update.systemName << "\" as the default emulator \""
+                                  << update.defaultEmulator << "\" was selected";
+                }
+                else if (update.alternativeEmulator != "") {
+                    LOG(LogDebug) << "GamelistFileParser::updateGamelist(): "
+                                     "Added/updated the alternativeEmulator tag for system \""
+                                  << update.systemName << "\" to \""
+                                  << update.alternativeEmulator << "\"";
+                }
+            }
+            if (numUpdated > 0) {
+                LOG(LogDebug) << "GamelistFileParser::updateGamelist(): Added/updated "
+                              << numUpdated
+                              << (numUpdated == 1 ? " entity in \"" : " entities in \"")
+#if defined(_WIN64)
+                              << Utils::String::replace(update.writePath, "/", "\\") << "\"";
+#else
+                              << update.writePath << "\"";
+#endif
+            }
+#if defined(_WIN64)
+            if (!doc.save_file(Utils::String::stringToWideString(update.writePath).c_str())) {
+#else
+            if (!doc.save_file(update.writePath.c_str())) {
+#endif
+                LOG(LogError) << "Error saving gamelist.xml to \"" << update.writePath
+                              << "\" (for system " << update.systemName << ")";
+                return false;
+            }
+
+            return true;
+        }
+
+        std::mutex mMutex;
+        std::condition_variable mQueueCondition;
+        std::condition_variable mWrittenCondition;
+        // The pending updates keyed by the gamelist.xml file they will be written to.
+        std::map<std::string, std::unique_ptr<GamelistUpdate>> mQueue;
+        // The file that the writer thread is currently writing, if any.
+        std::string mWritingPath;
+    };
+
+    GamelistWriter& getWriter()
+    {
+        // This is intentionally never deleted as the detached writer thread may still be
+        // running when the application exits, flushGamelistWrites() is called before that.
+        static GamelistWriter* writer {new GamelistWriter};
+        return *writer;
+    }
+
+    // Reads the gamelist.xml entries without building a DOM. The whole file is read into a
+    // single buffer and the element values are decoded in place, so the parsed values are only
+    // views into that buffer. Only the flat layout written by ES-DE and the scrapers is
+    // supported, for anything else read() returns false and the pugixml parser is used instead.
+    class GamelistReader
+    {
+    public:
+        using Value = std::pair<std::string_view, std::string_view>;
+
+        struct Entry {
+            FileType type;
+            size_t firstValue;
+            size_t valueCount;
+        };
+
+        GamelistReader()
+            : mPos {nullptr}
+            , mEnd {nullptr}
+            , mFoundGameList {false}
+            , mFoundAlternativeEmulator {false}
+        {
+        }
+
+        bool read(const std::string& path)
+        {
+            std::ifstream file;
+#if defined(_WIN64)
+            file.open(Utils::String::stringToWideString(path).c_str(),
+                      std::ios::binary | std::ios::ate);
+#else
+            file.open(path.c_str(), std::ios::binary | std::ios::ate);
+#endif
+            if (!file.good())
+                return false;
+
+            const std::streamoff fileSize {file.tellg()};
+            if (fileSize <= 0)
+                return false;
+
+            mBuffer.resize(static_cast<size_t>(fileSize));
+            file.seekg(0);
+            if (!file.read(&mBuffer[0], fileSize))
+                return false;
+
+            return parse();
+        }
+
+        bool getFoundGameList() const { return mFoundGameList; }
+        std::string_view getAlternativeEmulator() const { return mAlternativeEmulator; }
+        const std::vector<Entry>& getEntries() const { return mEntries; }
+        const Value* getValues(const Entry& entry) const
+        {
+            return mValues.data() + entry.firstValue;
+        }
+
+        std::string_view getValue(const Entry& entry, const std::string_view key) const
+        {
+            const Value* value {findValue(entry, key)};
+            return value != nullptr ? value->second : std::string_view {};
+        }
+
+    private:
+        const Value* findValue(const Entry& entry, const std::string_view key) const
+        {
+            for (size_t i {entry.firstValue}; i < entry.firstValue + entry.valueCount; ++i) {
+                if (mValues[i].first == key)
+                    return &mValues[i];
+            }
+            return nullptr;
+        }
+
+        // Elements nested deeper than this are not part of any valid gamelist.xml file.
+        static constexpr int MAX_DEPTH {32};
+
+        static bool isWhitespace(const char character)
+        {
+            return character == ' ' || character == '\t' || character == '\r' ||
+                   character == '\n';
+        }
+
+        static bool isNameChar(const char character)
+        {
+            const unsigned char value {static_cast<unsigned char>(character)};
+            return (value >= 'a' && value <= 'z') || (value >= 'A' && value <= 'Z') ||
+                   (value >= '0' && value <= '9') || value == '_' || value == '-' ||
+                   value == '.' || value == ':' || value >= 0x80;
+        }
+
+        bool startsWith(const char* string) const
+        {
+            const size_t length {strlen(string)};
+            return static_cast<size_t>(mEnd - mPos) >= length &&
+                   memcmp(mPos, string, length) == 0;
+        }
+
+        bool skipPast(const char* string)
+        {
+            const std::string_view remaining {mPos, static_cast<size_t>(mEnd - mPos)};
+            const size_t found {remaining.find(string)};
+            if (found == std::string_view::npos)
+                return false;
+            mPos += found + strlen(string);
+            return true;
+        }
+
+        void skipWhitespace()
+        {
+            while (mPos != mEnd && isWhitespace(*mPos))
+                ++mPos;
+        }
+
+        // Moves to the next markup, returns false if the end of the buffer was reached.
+        bool skipText()
+        {
+            while (mPos != mEnd && *mPos != '<')
+                ++mPos;
+            return mPos != mEnd;
+        }
+
+        // Skips comments, processing instructions and the document type declaration. Returns
+        // false if the current position is not at such markup or if it's malformed.
+        bool skipMarkup()
+        {
+            if (startsWith("<?"))
+                return skipPast("?>");
+            if (startsWith("<!--"))
+                return skipPast("-->");
+            if (startsWith("<!DOCTYPE")) {
+                // An internal subset could declare entities that would then need to be expanded.
+                while (mPos != mEnd && *mPos != '>') {
+                    if (*mPos == '[')
+                        return false;
+                    ++mPos;
+                }
+                if (mPos == mEnd)
+                    return false;
+                ++mPos;
+                return true;
+            }
+            return false;
+        }
+
+        bool readStartTag(std::string_view& name, bool& empty)
+        {
+            const char* nameStart {++mPos};
+            while (mPos != mEnd && isNameChar(*mPos))
+                ++mPos;
+            if (mPos == nameStart)
+                return false;
+            name = std::string_view {nameStart, static_cast<size_t>(mPos - nameStart)};
+
+            // The attributes are not used for anything.
+            while (true) {
+                skipWhitespace();
+                if (mPos == mEnd)
+                    return false;
+                if (*mPos == '>') {
+                    ++mPos;
+                    empty = false;
+                    return true;
+                }
+                if (startsWith("/>")) {
+                    mPos += 2;
+                    empty = true;
+                    return true;
+                }
+                const char* attributeStart {mPos};
+                while (mPos != mEnd && isNameChar(*mPos))
+                    ++mPos;
+                if (mPos == attributeStart)
+                    return false;
+                skipWhitespace();
+                if (mPos == mEnd || *mPos != '=')
+                    return false;
+                ++mPos;
+                skipWhitespace();
+                if (mPos == mEnd || (*mPos != '"' && *mPos != '\''))
+                    return false;
+                const char quote {*mPos++};
+                while (mPos != mEnd && *mPos != quote)
+                    ++mPos;
+                if (mPos == mEnd)
+                    return false;
+                ++mPos;
+            }
+        }
+
+        bool readEndTag(const std::string_view name)
+        {
+            mPos += 2;
+            if (static_cast<size_t>(mEnd - mPos) < name.size() ||
+                std::string_view {mPos, name.size()} != name)
+                return false;
+            mPos += name.size();
+            skipWhitespace();
+            return mPos != mEnd && *mPos++ == '>';
+        }
+
+        // Skips the contents and the end tag of an element that is not used.
+        bool skipElement(const std::string_view name, const int depth)
+        {
+            if (depth > MAX_DEPTH)
+                return false;
+
+            while (skipText()) {
+                if (startsWith("<![CDATA[")) {
+                    if (!skipPast("]]>"))
+                        return false;
+                }
+                else if (startsWith("</")) {
+                    return readEndTag(name);
+                }
+                else if (startsWith("<?") || startsWith("<!")) {
+                    if (!skipMarkup())
+                        return false;
+                }
+                else {
+                    std::string_view childName;
+                    bool empty {false};
+                    if (!readStartTag(childName, empty))
+                        return false;
+                    if (!empty && !skipElement(childName, depth + 1))
+                        return false;
+                }
+            }
+            return false;
+        }
+
+        // Decodes the line endings and the character and entity references the same way as
+        // pugixml does. The decoded text is never longer than the original text.
+        static char* decodeText(char* start, const char* end, const bool references)
+        {
+            char* output {start};
+            for (const char* input {start}; input != end;) {
+                if (*input == '\r') {
+                    *output++ = '\n';
+                    if (++input != end && *input == '\n')
+                        ++input;
+                    continue;
+                }
+                if (references && *input == '&') {
+                    const size_t length {decodeReference(input, end, output)};
+                    if (length != 0) {
+                        input += length;
+                        continue;
+                    }
+                }
+                *output++ = *input++;
+            }
+            return output;
+        }
+
+        // Returns the length of the reference or zero if it's not a valid reference, in which
+        // case it's kept as is.
+        static size_t decodeReference(const char* input, const char* end, char*& output)
+        {
+            const char* semicolon {input + 1};
+            while (semicolon != end && *semicolon != ';' && semicolon - input < 12)
+                ++semicolon;
+            if (semicolon == end || *semicolon != ';')
+                return 0;
+
+            const std::string_view name {input + 1, static_cast<size_t>(semicolon - input - 1)};
+            const size_t length {name.size() + 2};
+
+            if (name == "lt")
+                *output++ = '<';
+            else if (name == "gt")
+                *output++ = '>';
+            else if (name == "amp")
+                *output++ = '&';
+            else if (name == "apos")
+                *output++ = '\'';
+            else if (name == "quot")
+                *output++ = '"';
+            else if (name.size() > 1 && name[0] == '#') {
+                const bool hex {name[1] == 'x'};
+                const std::string_view digits {name.substr(hex ? 2 : 1)};
+                if (digits.empty())
+                    return 0;
+                unsigned int codePoint {0};
+                for (const char digit : digits) {
+                    unsigned int value;
+                    if (digit >= '0' && digit <= '9')
+                        value = digit - '0';
+                    else if (hex && digit >= 'a' && digit <= 'f')
+                        value = digit - 'a' + 10;
+                    else if (hex && digit >= 'A' && digit <= 'F')
+                        value = digit - 'A' + 10;
+                    else
+                        return 0;
+                    codePoint = codePoint * (hex ? 16 : 10) + value;
+                    if (codePoint > 0x10FFFF)
+                        return 0;
+                }
+                if (codePoint == 0)
+                    return 0;
+                if (codePoint < 0x80) {
+                    *output++ = static_cast<char>(codePoint);
+                }
+                else if (codePoint < 0x800) {
+                    *output++ = static_cast<char>(0xC0 | (codePoint >> 6));
+                    *output++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+                }
+                else if (codePoint < 0x10000) {
+                    *output++ = static_cast<char>(0xE0 | (codePoint >> 12));
+                    *output++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                    *output++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+                }
+                else {
+                    *output++ = static_cast<char>(0xF0 | (codePoint >> 18));
+                    *output++ = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+                    *output++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                    *output++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+                }
+            }
+            else {
+                return 0;
+            }
+
+            return length;
+        }
+
+        // Reads the text of an element which must not contain any child elements. Like the
+        // pugixml text() function this is the first text or CDATA section, but as the values
+        // are never split in practice anything more than one section is not supported.
+        bool readValue(const std::string_view name, std::string_view& value)
+        {
+            int sections {0};
+            value = {};
+
+            while (true) {
+                char* textStart {mPos};
+                if (!skipText())
+                    return false;
+
+                const char* textEnd {mPos};
+                if (std::find_if_not(const_cast<const char*>(textStart), textEnd,
+                                     isWhitespace) != textEnd) {
+                    char* decodedEnd {decodeText(textStart, textEnd, true)};
+                    value = std::string_view {textStart,
+                                              static_cast<size_t>(decodedEnd - textStart)};
+                    ++sections;
+                }
+
+                if (startsWith("<![CDATA[")) {
+                    char* cdataStart {mPos + 9};
+                    mPos = cdataStart;
+                    if (!skipPast("]]>"))
+                        return false;
+                    char* decodedEnd {decodeText(cdataStart, mPos - 3, false)};
+                    value = std::string_view {cdataStart,
+                                              static_cast<size_t>(decodedEnd - cdataStart)};
+                    ++sections;
+                }
+                else if (startsWith("</")) {
+                    return sections <= 1 && readEndTag(name);
+                }
+                else {
+                    return false;
+                }
+            }
+        }
+
+        bool readEntry(const std::string_view name, const FileType type)
+        {
+            Entry entry {type, mValues.size(), 0};
+
+            while (skipText()) {
+                if (startsWith("</")) {
+                    if (!readEndTag(name))
+                        return false;
+                    mEntries.emplace_back(entry);
+                    return true;
+                }
+                if (startsWith("<?") || startsWith("<!--")) {
+                    if (!skipMarkup())
+                        return false;
+                    continue;
+                }
+
+                Value value;
+                bool empty {false};
+                if (!readStartTag(value.first, empty))
+                    return false;
+                if (!empty && !readValue(value.first, value.second))
+                    return false;
+
+                // Only the first value is used if a key is repeated, as for pugixml child().
+                if (findValue(entry, value.first) == nullptr) {
+                    mValues.emplace_back(value);
+                    ++entry.valueCount;
+                }
+            }
+            return false;
+        }
+
+        bool readGameList()
+        {
+            while (skipText()) {
+                if (startsWith("</"))
+                    return readEndTag("gameList");
+                if (startsWith("<?") || startsWith("<!")) {
+                    if (!skipMarkup())
+                        return false;
+                    continue;
+                }
+
+                std::string_view name;
+                bool empty {false};
+                if (!readStartTag(name, empty))
+                    return false;
+
+                if (name == "game" || name == "folder") {
+                    const FileType type {name == "game" ? GAME : FOLDER};
+                    if (empty)
+                        mEntries.emplace_back(Entry {type, mValues.size(), 0});
+                    else if (!readEntry(name, type))
+                        return false;
+                }
+                else if (!empty && !skipElement(name, 1)) {
+                    return false;
+                }
+            }
+            return false;
+        }
+
+        bool readAlternativeEmulator()
+        {
+            bool foundLabel {false};
+
+            while (skipText()) {
+                if (startsWith("</"))
+                    return readEndTag("alternativeEmulator");
+                if (startsWith("<?") || startsWith("<!")) {
+                    if (!skipMarkup())
+                        return false;
+                    continue;
+                }
+
+                std::string_view name;
+                bool empty {false};
+                if (!readStartTag(name, empty))
+                    return false;
+                if (name == "label" && !foundLabel) {
+                    foundLabel = true;
+                    if (!empty && !readValue(name, mAlternativeEmulator))
+                        return false;
+                }
+                else if (empty) {
+                    continue;
+                }
+                else if (!skipElement(name, 1)) {
+                    return false;
+                }
+            }
+            return false;
+        }
+
+        bool parse()
+        {
+            // Files with other encodings than UTF-8 are left to pugixml.
+            if (memchr(mBuffer.data(), '\0', mBuffer.size()) != nullptr)
+                return false;
+
+            mPos = &mBuffer[0];
+            mEnd = mPos + mBuffer.size();
+
+            if (startsWith("\xEF\xBB\xBF"))
+                mPos += 3;
+
+            // Any other encoding defined by the XML declaration is also left to pugixml.
+            if (startsWith("<?xml")) {
+                const size_t declarationEnd {
+                    std::string_view {mPos, static_cast<size_t>(mEnd - mPos)}.find("?>")};
+                if (declarationEnd == std::string_view::npos)
+                    return false;
+                const std::string_view declaration {mPos, declarationEnd};
+                const size_t encodingPos {declaration.find("encoding")};
+                if (encodingPos != std::string_view::npos) {
+                    const std::string encoding {Utils::String::toLower(std::string {
+                        declaration.substr(encodingPos + 8, 16)})};
+                    if (encoding.find("utf-8") == std::string::npos &&
+                        encoding.find("utf8") == std::string::npos)
+                        return false;
+                }
+            }
+
+            while (true) {
+                skipWhitespace();
+                if (mPos == mEnd)
+                    return true;
+                if (*mPos != '<')
+                    return false;
+                if (startsWith("<?") || startsWith("<!")) {
+                    if (!skipMarkup())
+                        return false;
+                    continue;
+                }
+
+                std::string_view name;
+                bool empty {false};
+                if (!readStartTag(name, empty))
+                    return false;
+                if (empty) {
+                    mFoundGameList = mFoundGameList || name == "gameList";
+                    mFoundAlternativeEmulator =
+                        mFoundAlternativeEmulator || name == "alternativeEmulator";
+                    continue;
+                }
+
+                // As for pugixml child() only the first element with each name is used.
+                bool success {false};
+                if (name == "gameList" && !mFoundGameList) {
+                    mFoundGameList = true;
+                    success = readGameList();
+                }
+                else if (name == "alternativeEmulator" && !mFoundAlternativeEmulator) {
+                    mFoundAlternativeEmulator = true;
+                    success = readAlternativeEmulator();
+                }
+                else {
+                    success = skipElement(name, 1);
+                }
+
+                if (!success)
+                    return false;
+            }
+        }
+
+        std::string mBuffer;
+        char* mPos;
+        char* mEnd;
+
+        std::vector<Entry> mEntries;
+        std::vector<Value> mValues;
+        std::string_view mAlternativeEmulator;
+        bool mFoundGameList;
+        bool mFoundAlternativeEmulator;
+    };
+
+    void setAlternativeEmulator(SystemData* system, const std::string& label)
+    {
+        if (label == "")
+            return;
+
+        bool validLabel {false};
+        for (auto& command : system->getSystemEnvData()->mLaunchCommands) {
+            if (command.second == label)
+                validLabel = true;
+        }
+        if (validLabel) {
+            system->setAlternativeEmulator(label);
+            LOG(LogDebug) << "GamelistFileParser::parseGamelist(): System \"" << system->getName()
+                          << "\" has a valid alternativeEmulator entry: \"" << label << "\"";
+        }
+        else {
+            system->setAlternativeEmulator("<INVALID>" + label);
+            LOG(LogWarning) << "System \"" << system->getName()
+                            << "\" has an invalid alternativeEmulator entry that does "
+                               "not match any command tag in es_systems.xml: \""
+                            << label << "\"";
+        }
+    }
+
+} // namespace
+
 namespace GamelistFileParser
 {
     FileData* findOrCreateFile(SystemData* system, const std::string& path, FileType type)
@@ -32,6 +964,16 @@ namespace GamelistFileParser
             return nullptr;
         }
 
+        // Most entries are located directly in the system directory, in which case the path
+        // doesn't need to be split.
+        if (relative.find('/') == std::string::npos) {
+            const std::unordered_map<std::string, FileData*>& children {
+                root->getChildrenByFilename()};
+            auto child = children.find(relative);
+            if (child != children.cend())
+                return (*child).second;
+        }
+
         const Utils::FileSystem::StringList& pathList {Utils::FileSystem::getPathList(relative)};
         auto path_it = pathList.begin();
         FileData* treeNode {root};
@@ -129,7 +1071,7 @@ namespace GamelistFileParser
         return nullptr;
     }
 
-    void parseGamelist(SystemData* system)
+    void parseGamelistFile(SystemData* system, const std::unordered_set<std::string>* paths)
     {
         const bool trustGamelist {Settings::getInstance()->getBool("ParseGamelistOnly")};
         const std::string& xmlpath {system->getGamelistPath(false)};
@@ -162,6 +1104,143 @@ namespace GamelistFileParser
         LOG(LogInfo) << "Parsing gamelist file \"" << xmlpath << "\"...";
 #endif
 
+        const std::string& relativeTo {system->getStartPath()};
+        const bool showHiddenFiles {Settings::getInstance()->getBool("ShowHiddenFiles")};
+        const bool showHiddenGames {Settings::getInstance()->getBool("ShowHiddenGames")};
+
+        auto processEntry = [&](const FileType type, const std::string& pathValue,
+                                const std::function<MetaDataList(MetaDataListType)>& metadata) {
+            const std::string& path {
+                Utils::FileSystem::resolveRelativePath(pathValue, relativeTo, false)};
+
+            if (paths != nullptr && paths->find(path) == paths->cend())
+                return;
+
+            if (!trustGamelist && !Utils::FileSystem::exists(path)) {
+#if defined(_WIN64)
+                LOG(LogWarning) << (type == GAME ? "File \"" : "Folder \"")
+                                << Utils::String::replace(path, "/", "\\")
+#else
+                LOG(LogWarning) << (type == GAME ? "File \"" : "Folder \"") << path
+#endif
+                                << "\" does not exist, skipping entry";
+                return;
+            }
+
+            // Skip hidden files, check both the file itself and the directory in which
+            // it is located.
+            if (!showHiddenFiles &&
+                (Utils::FileSystem::isHidden(path) ||
+                 Utils::FileSystem::isHidden(Utils::FileSystem::getParent(path)))) {
+                LOG(LogDebug) << "GamelistFileParser::parseGamelist(): Skipping hidden file \""
+                              << path << "\"";
+                return;
+            }
+
+            FileData* file {findOrCreateFile(system, path, type)};
+
+            if (file != nullptr && file->getNoLoad())
+                return;
+
+            // Don't load entries with the wrong type. This should very rarely (if ever) happen.
+            if (file != nullptr && file->getType() != type) {
+                LOG(LogWarning) << "Game/folder mismatch for \"" << path << "\", skipping entry";
+                return;
+            }
+
+            if (!file) {
+                if (!Utils::FileSystem::exists(path + "/noload.txt")) {
+#if defined(_WIN64)
+                    LOG(LogWarning) << "Couldn't process \""
+                                    << Utils::String::replace(path, "/", "\\")
+                                    << "\", skipping entry";
+#else
+                    LOG(LogWarning) << "Couldn't process \"" << path << "\", skipping entry";
+#endif
+                }
+                return;
+            }
+            else if (!file->isArcadeAsset()) {
+                const std::string defaultName {file->metadata.get("name")};
+                file->metadata = metadata(type == FOLDER ? FOLDER_METADATA : GAME_METADATA);
+
+                // Make sure a name gets set if one doesn't exist.
+                if (file->metadata.get("name").empty())
+                    file->metadata.set("name", defaultName);
+
+                file->metadata.resetChangedFlag();
+            }
+            else {
+                // Skip arcade asset entries as these will not be used in any way inside
+                // the application.
+                LOG(LogDebug) << "GamelistFileParser::parseGamelist(): Skipping arcade asset \""
+                              << file->getName() << "\"";
+                delete file;
+                return;
+            }
+            // If the game is flagged as hidden and the option has not been set to show hidden
+            // games, then delete the entry. This leaves no trace of the entry at all in ES
+            // but that is fine as the option to show hidden files is defined as requiring an
+            // application restart.
+            if (!showHiddenGames) {
+                if (file->getHidden()) {
+                    LOG(LogDebug) << "GamelistFileParser::parseGamelist(): Skipping hidden "
+                                  << (type == GAME ? "file" : "folder") << " entry \""
+                                  << file->getName() << "\"" << " (\"" << file->getPath()
+                                  << "\")";
+                    FileData* parent {file->getParent()};
+                    delete file;
+                    // In case there are no entries left in the folder.
+                    if (parent != system->getRootFolder() && parent->getChildren().empty())
+                        delete parent;
+                }
+                // Also delete any folders which are empty, i.e. all their entries are hidden.
+                else if (file->getType() == FOLDER && file->getChildren().size() == 0) {
+                    delete file;
+                }
+            }
+        };
+
+        const FileType typeList[2] = {GAME, FOLDER};
+
+        // The file is normally streamed by the GamelistReader, and pugixml is only used if it
+        // contains anything that the reader doesn't support, or to report parsing errors.
+        GamelistReader reader;
+        if (reader.read(xmlpath)) {
+            if (!reader.getFoundGameList()) {
+                LOG(LogError) << "Couldn't find <gameList> node in gamelist \"" << xmlpath
+                              << "\"";
+                return;
+            }
+
+            if (paths == nullptr)
+                setAlternativeEmulator(system, std::string {reader.getAlternativeEmulator()});
+
+            // The games are processed before the folders as the folders are created when
+            // the games inside them are added.
+            for (int i {0}; i < 2; ++i) {
+                for (auto& entry : reader.getEntries()) {
+                    if (entry.type != typeList[i])
+                        continue;
+                    processEntry(entry.type, std::string {reader.getValue(entry, "path")},
+                                 [&reader, &entry, &relativeTo](MetaDataListType listType) {
+                                     return MetaDataList::createFromValues(
+                                         listType, reader.getValues(entry), entry.valueCount,
+                                         relativeTo);
+                                 });
+                }
+                // Get rid of any orphaned noload.txt folder entries.
+                for (auto child : system->getRootFolder()->getChildrenRecursive()) {
+                    if (child->getNoLoad())
+                        delete child;
+                }
+            }
+            return;
+        }
+
+        LOG(LogDebug) << "GamelistFileParser::parseGamelist(): Using the DOM parser for \""
+                      << xmlpath << "\"";
+
         pugi::xml_document doc;
 #if defined(_WIN64)
         const pugi::xml_parse_result& result {
@@ -183,146 +1262,125 @@ namespace GamelistFileParser
         }
 
         const pugi::xml_node& alternativeEmulator {doc.child("alternativeEmulator")};
-        if (alternativeEmulator) {
-            const std::string& label {alternativeEmulator.child("label").text().get()};
-            if (label != "") {
-                bool validLabel {false};
-                for (auto& command : system->getSystemEnvData()->mLaunchCommands) {
-                    if (command.second == label)
-                        validLabel = true;
-                }
-                if (validLabel) {
-                    system->setAlternativeEmulator(label);
-                    LOG(LogDebug) << "GamelistFileParser::parseGamelist(): System \""
-                                  << system->getName()
-                                  << "\" has a valid alternativeEmulator entry: \"" << label
-                                  << "\"";
-                }
-                else {
-                    system->setAlternativeEmulator("<INVALID>" + label);
-                    LOG(LogWarning) << "System \"" << system->getName()
-                                    << "\" has an invalid alternativeEmulator entry that does "
-                                       "not match any command tag in es_systems.xml: \""
-                                    << label << "\"";
-                }
-            }
-        }
-
-        const std::string& relativeTo {system->getStartPath()};
-        const bool showHiddenFiles {Settings::getInstance()->getBool("ShowHiddenFiles")};
+        if (alternativeEmulator && paths == nullptr)
+            setAlternativeEmulator(system, alternativeEmulator.child("label").text().get());
 
         const std::vector<std::string> tagList {"game", "folder"};
-        const FileType typeList[2] = {GAME, FOLDER};
 
         for (int i {0}; i < 2; ++i) {
             std::string tag {tagList[i]};
             FileType type {typeList[i]};
             for (pugi::xml_node fileNode {root.child(tag.c_str())}; fileNode;
                  fileNode = fileNode.next_sibling(tag.c_str())) {
-                const std::string& path {Utils::FileSystem::resolveRelativePath(
-                    fileNode.child("path").text().get(), relativeTo, false)};
+                processEntry(type, fileNode.child("path").text().get(),
+                             [&fileNode, &relativeTo](MetaDataListType listType) {
+                                 return MetaDataList::createFromXML(listType, fileNode,
+                                                                    relativeTo);
+                             });
+            }
+            // Get rid of any orphaned noload.txt folder entries.
+            for (auto child : system->getRootFolder()->getChildrenRecursive()) {
+                if (child->getNoLoad())
+                    delete child;
+            }
+        }
+    }
 
-                if (!trustGamelist && !Utils::FileSystem::exists(path)) {
+    int replayStatisticsJournal(SystemData* system, const std::string& journalPath)
+    {
+        std::ifstream journal;
 #if defined(_WIN64)
-                    LOG(LogWarning) << (type == GAME ? "File \"" : "Folder \"")
-                                    << Utils::String::replace(path, "/", "\\")
+        journal.open(Utils::String::stringToWideString(journalPath).c_str(), std::ios::binary);
 #else
-                    LOG(LogWarning) << (type == GAME ? "File \"" : "Folder \"") << path
+        journal.open(journalPath.c_str(), std::ios::binary);
 #endif
-                                    << "\" does not exist, skipping entry";
-                    continue;
-                }
+        if (!journal.good()) {
+            LOG(LogError) << "Couldn't open statistics journal \"" << journalPath << "\"";
+            return 0;
+        }
 
-                // Skip hidden files, check both the file itself and the directory in which
-                // it is located.
-                if (!showHiddenFiles &&
-                    (Utils::FileSystem::isHidden(path) ||
-                     Utils::FileSystem::isHidden(Utils::FileSystem::getParent(path)))) {
-                    LOG(LogDebug) << "GamelistFileParser::parseGamelist(): Skipping hidden file \""
-                                  << path << "\"";
-                    continue;
-                }
+        std::unordered_map<std::string, FileData*> files;
+        for (auto file : system->getRootFolder()->getFilesRecursive(GAME | FOLDER))
+            files[file->getPath()] = file;
+
+        int numReplayed {0};
+        std::string line;
+
+        // Each record consists of the tag, path, playcount and lastplayed values separated by
+        // tabs. The values are absolute so replaying a record more than once is harmless.
+        while (std::getline(journal, line)) {
+            // An unterminated record could have been cut short by a crash.
+            if (journal.eof())
+                break;
+
+            std::vector<std::string> fields;
+            for (size_t start {0};;) {
+                const size_t tabPos {line.find('\t', start)};
+                fields.emplace_back(line.substr(start, tabPos - start));
+                if (tabPos == std::string::npos)
+                    break;
+                start = tabPos + 1;
+            }
 
-                FileData* file {findOrCreateFile(system, path, type)};
+            if (fields.size() != 4) {
+                LOG(LogWarning) << "Invalid record in statistics journal \"" << journalPath
+                                << "\"";
+                continue;
+            }
 
-                if (file != nullptr && file->getNoLoad())
-                    continue;
+            auto it = files.find(Utils::FileSystem::resolveRelativePath(
+                fields[1], system->getStartPath(), false));
+            if (it == files.end())
+                continue;
 
-                // Don't load entries with the wrong type. This should very rarely (if ever) happen.
-                if (file != nullptr && ((tag == "game" && file->getType() == FOLDER) ||
-                                        (tag == "folder" && file->getType() == GAME))) {
-                    LOG(LogWarning)
-                        << "Game/folder mismatch for \"" << path << "\", skipping entry";
-                    continue;
-                }
+            FileData* file {(*it).second};
+            if ((fields[0] == "game") != (file->getType() == GAME))
+                continue;
 
-                if (!file) {
-                    if (!Utils::FileSystem::exists(path + "/noload.txt")) {
-#if defined(_WIN64)
-                        LOG(LogWarning)
-                            << "Couldn't process \"" << Utils::String::replace(path, "/", "\\")
-                            << "\", skipping entry";
-#else
-                        LOG(LogWarning) << "Couldn't process \"" << path << "\", skipping entry";
-#endif
-                    }
-                    continue;
-                }
-                else if (!file->isArcadeAsset()) {
-                    const std::string defaultName {file->metadata.get("name")};
-                    if (file->getType() == FOLDER) {
-                        file->metadata =
-                            MetaDataList::createFromXML(FOLDER_METADATA, fileNode, relativeTo);
-                    }
-                    else {
-                        file->metadata =
-                            MetaDataList::createFromXML(GAME_METADATA, fileNode, relativeTo);
-                    }
+            if (file->getType() == GAME)
+                file->metadata.set("playcount", fields[2]);
+            file->metadata.set("lastplayed", fields[3]);
+            ++numReplayed;
+        }
 
-                    // Make sure a name gets set if one doesn't exist.
-                    if (file->metadata.get("name").empty())
-                        file->metadata.set("name", defaultName);
+        return numReplayed;
+    }
 
-                    file->metadata.resetChangedFlag();
-                }
-                else {
-                    // Skip arcade asset entries as these will not be used in any way inside
-                    // the application.
-                    LOG(LogDebug) << "GamelistFileParser::parseGamelist(): Skipping arcade asset \""
-                                  << file->getName() << "\"";
-                    delete file;
-                    continue;
-                }
-                // If the game is flagged as hidden and the option has not been set to show hidden
-                // games, then delete the entry. This leaves no trace of the entry at all in ES
-                // but that is fine as the option to show hidden files is defined as requiring an
-                // application restart.
-                if (!Settings::getInstance()->getBool("ShowHiddenGames")) {
-                    if (file->getHidden()) {
-                        LOG(LogDebug)
-                            << "GamelistFileParser::parseGamelist(): Skipping hidden "
-                            << (type == GAME ? "file" : "folder") << " entry \"" << file->getName()
-                            << "\"" << " (\"" << file->getPath() << "\")";
-                        FileData* parent {file->getParent()};
-                        delete file;
-                        // In case there are no entries left in the folder.
-                        if (parent != system->getRootFolder() && parent->getChildren().empty())
-                            delete parent;
-                    }
-                    // Also delete any folders which are empty, i.e. all their entries are hidden.
-                    else if (file->getType() == FOLDER && file->getChildren().size() == 0) {
-                        delete file;
-                    }
-                }
-            }
-            // Get rid of any orphaned noload.txt folder entries.
-            for (auto child : system->getRootFolder()->getChildrenRecursive()) {
-                if (child->getNoLoad())
-                    delete child;
-            }
+    void parseGamelist(SystemData* system)
+    {
+        // Make sure that any changes that are still queued for writing are not lost. Only the
+        // write for this system is waited for, so that the writes that are queued after the
+        // journal replays below don't hold up the loading of the other systems on startup.
+        getWriter().flush(system->getGamelistPath(true));
+
+        parseGamelistFile(system, nullptr);
+
+        // Apply any launch statistics that have not yet been written to gamelist.xml.
+        const std::string& journalPath {getJournalPath(system->getGamelistPath(true))};
+        int numReplayed {0};
+
+        for (auto& path : {getPendingJournalPath(journalPath), journalPath}) {
+            if (Utils::FileSystem::exists(path))
+                numReplayed += replayStatisticsJournal(system, path);
+        }
+
+        if (numReplayed > 0) {
+            LOG(LogDebug) << "GamelistFileParser::parseGamelist(): Replayed " << numReplayed
+                          << (numReplayed == 1 ? " statistics record" : " statistics records")
+                          << " for system \"" << system->getName() << "\"";
+            if (Settings::getInstance()->getString("SaveGamelistsMode") != "never")
+                updateGamelist(system);
         }
     }
 
+    void parseGamelist(SystemData* system, const std::unordered_set<std::string>& paths)
+    {
+        getWriter().flush(system->getGamelistPath(true));
+        // The statistics journal is not replayed as it's only relevant for games that
+        // were already loaded, and those have their statistics set already.
+        parseGamelistFile(system, &paths);
+    }
+
     void addFileDataNode(pugi::xml_node& parent,
                          const FileData* file,
                          const std::string& tag,
@@ -361,172 +1419,100 @@ namespace GamelistFileParser
         // because there might be information missing in our systemdata which we would otherwise
         // miss in the new XML file. We have the complete information for every game though, so
         // we can simply remove a game we already have in the system from the XML, and then add
-        // it back from its GameData information.
+        // it back from its GameData information. As this can take a while for large gamelist.xml
+        // files, the changed entries are copied here and the rest is done by the writer thread.
         if (Settings::getInstance()->getBool("IgnoreGamelist"))
             return;
 
-        pugi::xml_document doc;
-        pugi::xml_node root;
-        const std::string& xmlReadPath {system->getGamelistPath(false)};
-        bool hasAlternativeEmulatorTag {false};
+        FileData* rootFolder {system->getRootFolder()};
+        if (rootFolder == nullptr) {
+            LOG(LogError) << "Found no root folder for system \"" << system->getName() << "\"";
+            return;
+        }
 
-        if (Utils::FileSystem::exists(xmlReadPath) &&
-            Utils::FileSystem::getFileSize(xmlReadPath) != 0) {
-            // Parse an existing file first.
+        std::unique_ptr<GamelistUpdate> update {std::make_unique<GamelistUpdate>()};
+        update->systemName = system->getName();
+        update->startPath = system->getStartPath();
+        update->updateAlternativeEmulator = updateAlternativeEmulator;
 
-#if defined(_WIN64)
-            const pugi::xml_parse_result& result {
-                doc.load_file(Utils::String::stringToWideString(xmlReadPath).c_str())};
-#else
-            const pugi::xml_parse_result& result {doc.load_file(xmlReadPath.c_str())};
-#endif
-
-            if (!result) {
-                LOG(LogError) << "Error parsing gamelist file \"" << xmlReadPath
-                              << "\": " << result.description();
-                return;
-            }
+        if (updateAlternativeEmulator) {
+            update->alternativeEmulator = system->getAlternativeEmulator();
+            update->defaultEmulator = system->getSystemEnvData()->mLaunchCommands.front().second;
+        }
 
-            root = doc.child("gameList");
-            if (!root) {
-                LOG(LogError) << "Couldn't find <gameList> node in gamelist \"" << xmlReadPath
-                              << "\"";
-                return;
+        // Get only files, no folders.
+        std::vector<FileData*> files {rootFolder->getFilesRecursive(GAME | FOLDER)};
+        for (auto file : files) {
+            // Do not touch if it wasn't changed and is not flagged for deletion.
+            if (!file->metadata.wasChanged() && !file->getDeletionFlag())
+                continue;
+
+            const std::string& tag {(file->getType() == GAME) ? "game" : "folder"};
+            pugi::xml_node node;
+
+            // Add the game to the file, unless it's flagged for deletion.
+            if (!file->getDeletionFlag()) {
+                const pugi::xml_node lastNode {update->nodes.last_child()};
+                addFileDataNode(update->nodes, file, tag, system);
+                if (update->nodes.last_child() != lastNode)
+                    node = update->nodes.last_child();
+                file->metadata.resetChangedFlag();
             }
-            if (updateAlternativeEmulator) {
-                pugi::xml_node alternativeEmulator {doc.child("alternativeEmulator")};
 
-                if (alternativeEmulator)
-                    hasAlternativeEmulatorTag = true;
-
-                if (system->getAlternativeEmulator() != "") {
-                    if (!alternativeEmulator) {
-                        doc.prepend_child("alternativeEmulator");
-                        alternativeEmulator = doc.child("alternativeEmulator");
-                    }
-
-                    const pugi::xml_node& label {alternativeEmulator.child("label")};
-
-                    if (label && system->getAlternativeEmulator() !=
-                                     alternativeEmulator.child("label").text().get()) {
-                        alternativeEmulator.remove_child(label);
-                        alternativeEmulator.prepend_child("label").text().set(
-                            system->getAlternativeEmulator().c_str());
-                    }
-                    else if (!label) {
-                        alternativeEmulator.prepend_child("label").text().set(
-                            system->getAlternativeEmulator().c_str());
-                    }
-                }
-                else if (alternativeEmulator) {
-                    doc.remove_child("alternativeEmulator");
-                }
-            }
+            update->entries.emplace_back(
+                GamelistEntry {file->getPath(), tag, node, file->getDeletionFlag()});
         }
-        else {
-            if (updateAlternativeEmulator && system->getAlternativeEmulator() != "") {
-                pugi::xml_node alternativeEmulator {doc.prepend_child("alternativeEmulator")};
-                alternativeEmulator.prepend_child("label").text().set(
-                    system->getAlternativeEmulator().c_str());
-            }
-            // Set up an empty gamelist to append to.
-            root = doc.append_child("gameList");
-        }
-
-        // Now we have all the information from the XML file, so iterate
-        // through all our games and add the information from there.
-        FileData* rootFolder {system->getRootFolder()};
-        if (rootFolder != nullptr) {
-            int numUpdated {0};
-
-            // Get only files, no folders.
-            std::vector<FileData*> files {rootFolder->getFilesRecursive(GAME | FOLDER)};
-            // Iterate through all files, checking if they're already in the XML file.
-            for (std::vector<FileData*>::const_iterator fit {files.cbegin()}; // Line break.
-                 fit != files.cend(); ++fit) {
-                const std::string& tag {((*fit)->getType() == GAME) ? "game" : "folder"};
 
-                // Do not touch if it wasn't changed and is not flagged for deletion.
-                if (!(*fit)->metadata.wasChanged() && !(*fit)->getDeletionFlag())
-                    continue;
+        if (update->entries.empty() && !updateAlternativeEmulator)
+            return;
 
-                // Check if the file already exists in the XML file.
-                // If it does, remove the entry before adding it back.
-                for (pugi::xml_node fileNode {root.child(tag.c_str())}; fileNode;
-                     fileNode = fileNode.next_sibling(tag.c_str())) {
-                    const pugi::xml_node& pathNode {fileNode.child("path")};
-                    if (!pathNode) {
-                        LOG(LogError) << "<" << tag << "> node contains no <path> child";
-                        continue;
-                    }
+        update->readPath = system->getGamelistPath(false);
+        update->writePath = system->getGamelistPath(true);
+        // All journaled statistics are part of the changed entries so the journal gets compacted.
+        update->journalPath = getJournalPath(update->writePath);
+        journalRecords.erase(update->journalPath);
+        getWriter().queueUpdate(std::move(update));
+    }
 
-                    const std::string& nodePath {
-                        Utils::FileSystem::getCanonicalPath(Utils::FileSystem::resolveRelativePath(
-                            pathNode.text().get(), system->getStartPath(), true))};
-                    const std::string& gamePath {
-                        Utils::FileSystem::getCanonicalPath((*fit)->getPath())};
+    void flushGamelistWrites() { getWriter().flush(); }
 
-                    if (nodePath == gamePath) {
-                        // Found it
-                        root.remove_child(fileNode);
-                        if ((*fit)->getDeletionFlag())
-                            ++numUpdated;
-                        break;
-                    }
-                }
-
-                // Add the game to the file, unless it's flagged for deletion.
-                if (!(*fit)->getDeletionFlag()) {
-                    addFileDataNode(root, *fit, tag, system);
-                    (*fit)->metadata.resetChangedFlag();
-                    ++numUpdated;
-                }
-            }
+    void appendStatistics(SystemData* system, const std::vector<FileData*>& files)
+    {
+        const std::string& journalPath {getJournalPath(system->getGamelistPath(true))};
+        Utils::FileSystem::createDirectory(Utils::FileSystem::getParent(journalPath));
 
-            // Now write the file.
-            if (numUpdated > 0 || updateAlternativeEmulator) {
-                // Make sure the folders leading up to this path exist (or the write will fail).
-                const std::string& xmlWritePath {system->getGamelistPath(true)};
-                Utils::FileSystem::createDirectory(Utils::FileSystem::getParent(xmlWritePath));
-
-                if (updateAlternativeEmulator) {
-                    if (hasAlternativeEmulatorTag && system->getAlternativeEmulator() == "") {
-                        LOG(LogDebug) << "GamelistFileParser::updateGamelist(): Removed the "
-                                         "alternativeEmulator tag for system \""
-                                      << system->getName() << "\" as the default emulator \""
-                                      << system->getSystemEnvData()->mLaunchCommands.front().second
-                                      << "\" was selected";
-                    }
-                    else if (system->getAlternativeEmulator() != "") {
-                        LOG(LogDebug) << "GamelistFileParser::updateGamelist(): "
-                                         "Added/updated the alternativeEmulator tag for system \""
-                                      << system->getName() << "\" to \""
-                                      << system->getAlternativeEmulator() << "\"";
-                    }
-                }
-                if (numUpdated > 0) {
-                    LOG(LogDebug) << "GamelistFileParser::updateGamelist(): Added/updated "
-                                  << numUpdated
-                                  << (numUpdated == 1 ? " entity in \"" : " entities in \"")
+        std::ofstream journal;
 #if defined(_WIN64)
-                                  << Utils::String::replace(xmlWritePath, "/", "\\") << "\"";
+        journal.open(Utils::String::stringToWideString(journalPath).c_str(),
+                     std::ios::binary | std::ios::app);
 #else
-                                  << xmlWritePath << "\"";
+        journal.open(journalPath.c_str(), std::ios::binary | std::ios::app);
 #endif
-                }
-#if defined(_WIN64)
-                if (!doc.save_file(Utils::String::stringToWideString(xmlWritePath).c_str())) {
-#else
-                if (!doc.save_file(xmlWritePath.c_str())) {
-#endif
-                    LOG(LogError) << "Error saving gamelist.xml to \"" << xmlWritePath
-                                  << "\" (for system " << system->getName() << ")";
-                }
+
+        int numRecords {0};
+        if (journal.good()) {
+            for (auto file : files) {
+                if (file->getSystem() != system)
+                    continue;
+                journal << (file->getType() == GAME ? "game" : "folder") << "\t"
+                        << Utils::FileSystem::createRelativePath(file->getPath(),
+                                                                 system->getStartPath(), false)
+                        << "\t" << (file->getType() == GAME ? file->metadata.get("playcount") : "")
+                        << "\t" << file->metadata.get("lastplayed") << "\n";
+                ++numRecords;
             }
+            journal.close();
         }
-        else {
-            LOG(LogError) << "Found no root folder for system \"" << system->getName() << "\"";
+
+        if (!journal.good()) {
+            LOG(LogError) << "Couldn't write to statistics journal \"" << journalPath
+                          << "\", updating gamelist.xml instead";
+            updateGamelist(system);
+            return;
         }
+
+        if ((journalRecords[journalPath] += numRecords) >= MAX_JOURNAL_RECORDS)
+            updateGamelist(system);
     }
 
 } // namespace GamelistFileParser
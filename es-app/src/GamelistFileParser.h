@@ -9,16 +9,33 @@
 #ifndef ES_APP_GAMELIST_FILE_PARSER_H
 #define ES_APP_GAMELIST_FILE_PARSER_H
 
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+class FileData;
 class SystemData;
 
 namespace GamelistFileParser
 {
     // Loads gamelist.xml data into a SystemData.
     void parseGamelist(SystemData* system);
+    // Only loads the entries for the specified file and folder paths, used when games have
+    // been added to the system after it was populated.
+    void parseGamelist(SystemData* system, const std::unordered_set<std::string>& paths);
 
-    // Writes currently loaded metadata for a SystemData to gamelist.xml.
+    // Writes currently loaded metadata for a SystemData to gamelist.xml. The changed entries
+    // are copied and the file is then written on a background thread.
     void updateGamelist(SystemData* system, bool updateAlternativeEmulator = false);
 
+    // Waits for all queued gamelist.xml writes to complete.
+    void flushGamelistWrites();
+
+    // Appends the playcount and lastplayed values to the statistics journal for the system
+    // instead of writing the whole gamelist.xml file. The journal is replayed by parseGamelist()
+    // and it's compacted into gamelist.xml when it grows too large.
+    void appendStatistics(SystemData* system, const std::vector<FileData*>& files);
+
 } // namespace GamelistFileParser
 
 #endif // ES_APP_GAMELIST_FILE_PARSER_H
@@ -0,0 +1,468 @@
+//  SPDX-License-Identifier: MIT
+//
+//  ES-DE Frontend
+//  HeadlessMode.cpp
+//
+//  Command line batch modes that run without initializing the window and renderer,
+//  such as miximage generation, orphaned data cleanup and cache warm-up.
+//  Progress is printed to stdout and the application exits when done.
+//
+
+#include "HeadlessMode.h"
+
+#include "CollectionSystemsManager.h"
+#include "Log.h"
+#include "MiximageGenerator.h"
+#include "OrphanedDataCleanup.h"
+#include "Settings.h"
+#include "StartupTimer.h"
+#include "SystemData.h"
+#include "utils/FileSystemUtil.h"
+#include "utils/StringUtil.h"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace
+{
+    unsigned int getThreadCount(const size_t entries)
+    {
+        const unsigned int threads {std::max(1u, std::thread::hardware_concurrency())};
+        return static_cast<unsigned int>(std::max(std::min(entries, size_t {threads}), size_t {1}));
+    }
+
+    std::vector<FileData*> getAllGames()
+    {
+        std::vector<FileData*> games;
+        for (auto system : SystemData::sSystemVector) {
+            if (system->isCollection())
+                continue;
+            for (auto game : system->getRootFolder()->getChildrenRecursive())
+                games.emplace_back(game);
+        }
+        return games;
+    }
+
+    // Runs the process function for all games using the defined number of worker threads,
+    // while the calling thread prints the progress to stdout.
+    void processGames(const std::vector<FileData*>& games,
+                      const unsigned int threadCount,
+                      const std::string& taskName,
+                      const std::function<void(FileData*)>& processFunc)
+    {
+        std::atomic<size_t> nextGame {0};
+        std::atomic<size_t> processedGames {0};
+        std::vector<std::thread> workers;
+
+        std::cout << taskName << " for " << games.size() << (games.size() == 1 ? " game" : " games")
+                  << " using " << threadCount << (threadCount == 1 ? " thread" : " threads")
+                  << std::endl;
+
+        for (unsigned int i {0}; i < threadCount; ++i) {
+            workers.emplace_back([&] {
+                size_t index;
+                while ((index = nextGame++) < games.size()) {
+                    processFunc(games[index]);
+                    ++processedGames;
+                }
+            });
+        }
+
+        // Print the progress once per second, but only if it has changed.
+        size_t lastPercentage {0};
+        while (processedGames < games.size()) {
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            const size_t processed {processedGames};
+            const size_t percentage {processed * 100 / games.size()};
+            if (percentage != lastPercentage && processed != games.size()) {
+                std::cout << "Processed " << processed << " of " << games.size() << " games ("
+                          << percentage << "%)" << std::endl;
+                lastPercentage = percentage;
+            }
+        }
+
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+    bool generateMiximages()
+    {
+        const std::vector<FileData*> games {getAllGames()};
+        const bool overwrite {Settings::getInstance()->getBool("MiximageOverwrite")};
+        const int threadSetting {
+            Settings::getInstance()->getInt("MiximageOfflineGeneratorThreads")};
+        const unsigned int threadCount {
+            threadSetting > 0 ?
+                std::min(static_cast<unsigned int>(threadSetting), getThreadCount(games.size())) :
+                getThreadCount(games.size())};
+
+        std::atomic<int> generated {0};
+        std::atomic<int> overwritten {0};
+        std::atomic<int> skipped {0};
+        std::atomic<int> failed {0};
+        std::mutex outputMutex;
+
+        LOG(LogInfo) << "HeadlessMode: Generating miximages for " << games.size() << " games";
+
+        processGames(games, threadCount, "Generating miximages", [&](FileData* game) {
+            const bool existingImage {game->getMiximagePath() != ""};
+            if (existingImage && !overwrite) {
+                ++skipped;
+                return;
+            }
+
+            std::string resultMessage;
+            std::promise<bool> miximagePromise;
+            std::future<bool> miximageFuture {miximagePromise.get_future()};
+            MiximageGenerator generator {game, resultMessage};
+            generator.startThread(&miximagePromise);
+
+            if (!miximageFuture.get()) {
+                ++generated;
+                if (existingImage)
+                    ++overwritten;
+            }
+            else {
+                ++failed;
+                const std::string errorMessage {
+                    resultMessage + " (" + game->getName() + " [" +
+                    Utils::String::toUpper(game->getSystem()->getName()) + "])"};
+                LOG(LogInfo) << "HeadlessMode: " << errorMessage;
+                std::unique_lock<std::mutex> lock {outputMutex};
+                std::cout << errorMessage << std::endl;
+            }
+        });
+
+        std::cout << "Completed miximage generation: " << generated << " generated ("
+                  << overwritten << " overwritten), " << skipped << " skipped, " << failed
+                  << " failed" << std::endl;
+        LOG(LogInfo) << "HeadlessMode: Completed miximage generation (" << generated
+                     << " generated, " << overwritten << " overwritten, " << skipped
+                     << " skipped, " << failed << " failed)";
+
+        return failed == 0;
+    }
+
+    bool cleanupOrphanedData(const HeadlessMode::Task task)
+    {
+        OrphanedDataCleanup cleanup {0};
+        std::string taskName;
+        void (OrphanedDataCleanup::*cleanupFunc)() {nullptr};
+
+        if (task == HeadlessMode::Task::CLEANUP_MEDIA) {
+            taskName = "media";
+            cleanupFunc = &OrphanedDataCleanup::cleanupMediaFiles;
+        }
+        else if (task == HeadlessMode::Task::CLEANUP_GAMELISTS) {
+            taskName = "gamelists";
+            cleanupFunc = &OrphanedDataCleanup::cleanupGamelists;
+            // Write any gamelist.xml changes before proceeding with the cleanup.
+            if (Settings::getInstance()->getString("SaveGamelistsMode") == "on exit") {
+                for (auto system : SystemData::sSystemVector)
+                    system->writeMetaData();
+            }
+        }
+        else {
+            taskName = "collections";
+            cleanupFunc = &OrphanedDataCleanup::cleanupCollections;
+            if (!cleanup.getHasCustomCollections()) {
+                std::cout << "There are no enabled custom collections, skipping collections cleanup"
+                          << std::endl;
+                return true;
+            }
+        }
+
+        std::cout << "Running " << taskName << " cleanup" << std::endl;
+
+        cleanup.reset();
+        std::future<void> cleanupFuture {
+            std::async(std::launch::async, [&cleanup, cleanupFunc] { (cleanup.*cleanupFunc)(); })};
+
+        std::string lastSystem;
+        auto printSystem = [&] {
+            const std::string currentSystem {cleanup.getCurrentSystem()};
+            if (currentSystem != "" && currentSystem != lastSystem) {
+                std::cout << "Processing \"" << currentSystem << "\"" << std::endl;
+                lastSystem = currentSystem;
+            }
+        };
+
+        while (cleanupFuture.wait_for(std::chrono::milliseconds(100)) !=
+               std::future_status::ready)
+            printSystem();
+
+        printSystem();
+        cleanupFuture.get();
+
+        if (cleanup.getFailed()) {
+            std::cerr << "Error: The " << taskName
+                      << " cleanup failed: " << cleanup.getErrorMessage() << std::endl;
+            return false;
+        }
+
+        const int processedCount {cleanup.getProcessedCount()};
+        std::cout << "Completed " << taskName << " cleanup, removed " << processedCount
+                  << (task == HeadlessMode::Task::CLEANUP_MEDIA ?
+                          (processedCount == 1 ? " file" : " files") :
+                          (processedCount == 1 ? " entry" : " entries"))
+                  << std::endl;
+
+        return true;
+    }
+
+    bool warmCaches()
+    {
+        const std::vector<FileData*> games {getAllGames()};
+        std::atomic<size_t> fileCount {0};
+        std::atomic<size_t> byteCount {0};
+        std::atomic<size_t> failedCount {0};
+
+        LOG(LogInfo) << "HeadlessMode: Warming up caches for " << games.size() << " games";
+
+        processGames(games, getThreadCount(games.size()), "Warming up caches", [&](FileData* game) {
+            // Resolving the media paths populates the filesystem metadata caches, and the image
+            // files are read in full so they're in the page cache when first displayed.
+            const std::vector<std::string> imagePaths {
+                game->get3DBoxPath(),        game->getBackCoverPath(),
+                game->getCoverPath(),        game->getFanArtPath(),
+                game->getMarqueePath(),      game->getPhysicalMediaPath(),
+                game->getMiximagePath(),     game->getScreenshotPath(),
+                game->getTitleScreenPath(),  game->getCustomImagePath()};
+            game->getVideoPath();
+            game->getManualPath();
+
+            std::vector<char> buffer(65536);
+            for (auto& path : imagePaths) {
+                if (path == "")
+                    continue;
+#if defined(_WIN64)
+                std::ifstream file {Utils::String::stringToWideString(path).c_str(),
+                                    std::ios::binary};
+#else
+                std::ifstream file {path, std::ios::binary};
+#endif
+                if (!file.good()) {
+                    ++failedCount;
+                    continue;
+                }
+                while (file.read(buffer.data(), buffer.size()) || file.gcount() > 0)
+                    byteCount += static_cast<size_t>(file.gcount());
+                if (file.bad()) {
+                    ++failedCount;
+                    continue;
+                }
+                ++fileCount;
+            }
+        });
+
+        std::cout << "Completed cache warm-up, read " << fileCount
+                  << (fileCount == 1 ? " file" : " files") << " ("
+                  << byteCount / (1024 * 1024) << " MiB), " << failedCount << " failed"
+                  << std::endl;
+        LOG(LogInfo) << "HeadlessMode: Completed cache warm-up, read " << fileCount
+                     << " files, " << failedCount << " failed";
+
+        return failedCount == 0;
+    }
+
+    // Creates the game files and a gamelist.xml file with realistic metadata for the startup
+    // benchmark. A fixed seed is used so that the results are comparable between runs.
+    bool createBenchmarkSystem(const std::string& romPath,
+                               const std::string& gamelistPath,
+                               const unsigned int entries)
+    {
+        const std::vector<std::string> titles {
+            "Attack from Mars", "Medieval Madness", "The Addams Family", "Twilight Zone",
+            "Monster Bash",     "Theatre of Magic", "Cirqus Voltaire",   "Black Knight 2000",
+            "Funhouse",         "Tales of the Arabian Nights"};
+        const std::vector<std::string> manufacturers {"Bally", "Williams", "Gottlieb", "Stern",
+                                                      "Data East"};
+        const std::vector<std::string> genres {"Pinball", "Pinball / Sci-Fi", "Pinball / Fantasy",
+                                               "Pinball / Horror", "Pinball / Licensed"};
+        std::mt19937 generator {1};
+
+        if (!Utils::FileSystem::createDirectory(romPath) ||
+            !Utils::FileSystem::createDirectory(gamelistPath)) {
+            std::cerr << "Error: Couldn't create the benchmark directories" << std::endl;
+            return false;
+        }
+
+#if defined(_WIN64)
+        std::ofstream gamelistFile {
+            Utils::String::stringToWideString(gamelistPath + "/gamelist.xml").c_str()};
+#else
+        std::ofstream gamelistFile {gamelistPath + "/gamelist.xml"};
+#endif
+        gamelistFile << "<?xml version=\"1.0\"?>\n<gameList>\n";
+
+        for (unsigned int i {0}; i < entries; ++i) {
+            const std::string manufacturer {manufacturers[generator() % manufacturers.size()]};
+            const std::string year {std::to_string(1970 + generator() % 50)};
+            const std::string name {titles[generator() % titles.size()] + " (" + manufacturer +
+                                    " " + year + ") v" + std::to_string(i)};
+            const std::string fileName {"table" + std::to_string(i) + ".vpx"};
+
+#if defined(_WIN64)
+            std::ofstream gameFile {
+                Utils::String::stringToWideString(romPath + "/" + fileName).c_str()};
+#else
+            std::ofstream gameFile {romPath + "/" + fileName};
+#endif
+            if (!gameFile.is_open()) {
+                std::cerr << "Error: Couldn't create the benchmark game files" << std::endl;
+                return false;
+            }
+
+            gamelistFile << "\t<game>\n\t\t<path>./" << fileName << "</path>\n\t\t<name>"
+                         << name << "</name>\n\t\t<desc>A " << year
+                         << " pinball table manufactured by " << manufacturer
+                         << ", recreated for Visual Pinball X with a full playfield, "
+                            "lighting and sound package.</desc>\n\t\t<rating>"
+                         << (generator() % 11) / 10.0f << "</rating>\n\t\t<releasedate>"
+                         << year << "0101T000000</releasedate>\n\t\t<developer>"
+                         << manufacturer << "</developer>\n\t\t<publisher>" << manufacturer
+                         << "</publisher>\n\t\t<genre>" << genres[generator() % genres.size()]
+                         << "</genre>\n\t\t<players>1-4</players>\n";
+            if (i % 3 == 0)
+                gamelistFile << "\t\t<favorite>true</favorite>\n";
+            if (i % 2 == 0) {
+                gamelistFile << "\t\t<playcount>" << generator() % 50
+                             << "</playcount>\n\t\t<lastplayed>20240101T120000</lastplayed>\n";
+            }
+            gamelistFile << "\t</game>\n";
+        }
+
+        gamelistFile << "</gameList>\n";
+        gamelistFile.close();
+
+        if (gamelistFile.fail()) {
+            std::cerr << "Error: Couldn't write the benchmark gamelist.xml file" << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+} // namespace
+
+namespace HeadlessMode
+{
+    int run(const std::vector<Task>& tasks)
+    {
+        const auto startTime {std::chrono::system_clock::now()};
+
+        SystemData::sHeadlessMode = true;
+        // There is no window so there is no splash screen, this setting is never saved.
+        Settings::getInstance()->setBool("SplashScreen", false);
+
+        LOG(LogInfo) << "Running in headless mode";
+        std::cout << "Loading systems..." << std::endl;
+
+        if (SystemData::loadConfig()) {
+            std::cerr << "Error: Couldn't load the systems configuration file" << std::endl;
+            return 1;
+        }
+
+        if (SystemData::sSystemVector.empty()) {
+            std::cerr << "Error: No game files were found, make sure that the system directories "
+                         "are setup correctly and that the file extensions are supported"
+                      << std::endl;
+            return 1;
+        }
+
+        bool failed {false};
+
+        // The remaining tasks are still run if a task fails, but the exit code reports it.
+        for (auto task : tasks) {
+            bool succeeded {false};
+            if (task == Task::GENERATE_MIXIMAGES)
+                succeeded = generateMiximages();
+            else if (task == Task::WARM_CACHES)
+                succeeded = warmCaches();
+            else
+                succeeded = cleanupOrphanedData(task);
+
+            if (!succeeded)
+                failed = true;
+        }
+
+        CollectionSystemsManager::getInstance()->deinit(true);
+        SystemData::deleteSystems();
+
+        const auto elapsed {std::chrono::duration_cast<std::chrono::seconds>(
+                                std::chrono::system_clock::now() - startTime)
+                                .count()};
+        std::cout << (failed ? "Finished with errors" : "Done") << " after " << elapsed
+                  << " seconds" << std::endl;
+        LOG(LogInfo) << "HeadlessMode: " << (failed ? "Finished with errors" : "Completed")
+                     << " after " << elapsed << " seconds";
+
+        return failed ? 1 : 0;
+    }
+
+    int runStartupBenchmark(const unsigned int entries)
+    {
+        const std::string systemName {"startupbenchmark"};
+        const std::string romPath {Utils::FileSystem::getAppDataDirectory() + "/" + systemName};
+        const std::string gamelistPath {Utils::FileSystem::getAppDataDirectory() +
+                                        "/gamelists/" + systemName};
+
+        SystemData::sHeadlessMode = true;
+        // None of these settings are saved as there is no way to change the settings in
+        // headless mode. The generated gamelist.xml file should never be written back.
+        Settings::getInstance()->setBool("SplashScreen", false);
+        Settings::getInstance()->setString("SaveGamelistsMode", "never");
+
+        LOG(LogInfo) << "HeadlessMode: Running startup benchmark with " << entries << " games";
+        std::cout << "Generating benchmark system with " << entries
+                  << (entries == 1 ? " game" : " games") << "..." << std::endl;
+
+        if (Utils::FileSystem::exists(romPath) || Utils::FileSystem::exists(gamelistPath)) {
+            std::cerr << "Error: The benchmark directory \"" << romPath << "\" or \""
+                      << gamelistPath << "\" already exists" << std::endl;
+            return 1;
+        }
+
+        const bool created {createBenchmarkSystem(romPath, gamelistPath, entries)};
+
+        if (created) {
+            std::cout << "Loading benchmark system..." << std::endl;
+            StartupTimer::reset();
+            {
+                StartupTimer::Phase phase {"systems"};
+                SystemEnvironmentData* envData {new SystemEnvironmentData};
+                envData->mStartPath = romPath;
+                envData->mSearchExtensions.emplace_back(".vpx");
+                SystemData* system {new SystemData(systemName, "Startup benchmark",
+                                                   systemName, envData, systemName)};
+                delete system;
+            }
+
+            // As there is no window, only the scan, parse and sort phases are measured.
+            for (auto& phase : StartupTimer::getPhases()) {
+                std::cout << std::left << std::setw(10) << phase.name << std::right << std::fixed
+                          << std::setprecision(1) << std::setw(10)
+                          << static_cast<double>(phase.wallTime) / 1000.0 << " ms  (CPU "
+                          << static_cast<double>(phase.cpuTime) / 1000.0 << " ms)"
+                          << std::endl;
+            }
+
+            if (Settings::getInstance()->getBool("StartupReport"))
+                StartupTimer::writeReport(StartupTimer::getReportPath());
+        }
+
+        Utils::FileSystem::removeDirectory(romPath, true);
+        Utils::FileSystem::removeDirectory(gamelistPath, true);
+
+        return created ? 0 : 1;
+    }
+
+} // namespace HeadlessMode
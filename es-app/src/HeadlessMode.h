@@ -0,0 +1,38 @@
+//  SPDX-License-Identifier: MIT
+//
+//  ES-DE Frontend
+//  HeadlessMode.h
+//
+//  Command line batch modes that run without initializing the window and renderer,
+//  such as miximage generation, orphaned data cleanup and cache warm-up.
+//  Progress is printed to stdout and the application exits when done.
+//
+
+#ifndef ES_APP_HEADLESS_MODE_H
+#define ES_APP_HEADLESS_MODE_H
+
+#include <string>
+#include <vector>
+
+namespace HeadlessMode
+{
+    enum class Task {
+        GENERATE_MIXIMAGES,
+        CLEANUP_MEDIA,
+        CLEANUP_GAMELISTS,
+        CLEANUP_COLLECTIONS,
+        WARM_CACHES
+    };
+
+    // Loads the systems and then runs the tasks in the order they were defined.
+    // Returns the application exit code, which is non-zero if any task failed.
+    int run(const std::vector<Task>& tasks);
+
+    // Times the startup phases for a generated system with the defined number of games,
+    // which makes it possible to compare the startup performance between builds without
+    // relying on the game collection that happens to be installed.
+    int runStartupBenchmark(const unsigned int entries);
+
+} // namespace HeadlessMode
+
+#endif // ES_APP_HEADLESS_MODE_H
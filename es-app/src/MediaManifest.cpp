@@ -0,0 +1,198 @@
+//  SPDX-License-Identifier: MIT
+//
+//  ES-DE Frontend
+//  MediaManifest.cpp
+//
+//  Cached listings of the game media directories, shared by the FileData media getters,
+//  the screensaver, the media viewer and the orphaned data cleanup. Every directory is read
+//  once and is then only read again if its modification time has changed, which avoids
+//  checking the existence of each media file and extension separately. This makes a large
+//  difference on network mounts and on platforms with slow disk I/O such as Android.
+//
+
+#include "MediaManifest.h"
+
+#include "Log.h"
+#include "utils/FileSystemUtil.h"
+#include "utils/StringUtil.h"
+
+#include <algorithm>
+
+namespace
+{
+    // How often the modification time of a cached directory is checked.
+    constexpr std::chrono::milliseconds CHECK_INTERVAL {1000};
+    // Some filesystems only store the modification time with a resolution of one or two
+    // seconds, so a directory modified within this period may change again without its
+    // modification time changing.
+    constexpr std::chrono::seconds MODIFICATION_TIME_RESOLUTION {2};
+
+} // namespace
+
+MediaManifest& MediaManifest::getInstance()
+{
+    static MediaManifest instance;
+    return instance;
+}
+
+std::string MediaManifest::findFile(const std::string& directory,
+                                    const std::string& stem,
+                                    const std::vector<std::string>& extensions)
+{
+    std::unique_lock<std::mutex> lock {mMutex};
+    const Directory& cachedDirectory {
+        getDirectory(Utils::FileSystem::getGenericPath(directory), false)};
+
+    for (auto& extension : extensions) {
+        if (cachedDirectory.foldedFileNames.find(foldFileName(stem + extension)) !=
+            cachedDirectory.foldedFileNames.cend())
+            return directory + "/" + stem + extension;
+    }
+
+    return "";
+}
+
+std::vector<std::string> MediaManifest::getFilesRecursive(const std::string& directory)
+{
+    std::vector<std::string> files;
+    {
+        std::unique_lock<std::mutex> lock {mMutex};
+        getFilesRecursive(Utils::FileSystem::getGenericPath(directory), files);
+    }
+
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+void MediaManifest::invalidate(const std::string& path)
+{
+    const std::string genericPath {Utils::FileSystem::getGenericPath(path)};
+    const std::string parentPath {Utils::FileSystem::getParent(genericPath)};
+
+    std::unique_lock<std::mutex> lock {mMutex};
+
+    for (auto it = mDirectories.begin(); it != mDirectories.end();) {
+        const std::string& cachedPath {(*it).first};
+        if (cachedPath == parentPath || cachedPath == genericPath ||
+            (cachedPath.length() > genericPath.length() &&
+             cachedPath[genericPath.length()] == '/' &&
+             cachedPath.compare(0, genericPath.length(), genericPath) == 0))
+            it = mDirectories.erase(it);
+        else
+            ++it;
+    }
+}
+
+void MediaManifest::clear()
+{
+    std::unique_lock<std::mutex> lock {mMutex};
+    mDirectories.clear();
+}
+
+const MediaManifest::Directory& MediaManifest::getDirectory(const std::string& genericPath,
+                                                            const bool forceCheck)
+{
+    const auto currentTime {std::chrono::steady_clock::now()};
+    auto it = mDirectories.find(genericPath);
+
+    if (it == mDirectories.end()) {
+        it = mDirectories.emplace(genericPath, Directory {}).first;
+        readDirectory(genericPath, (*it).second);
+    }
+    else if (forceCheck || currentTime - (*it).second.lastChecked > CHECK_INTERVAL) {
+        // A changed modification time means that entries have been added, removed or renamed.
+        if ((*it).second.recentlyModified ||
+            Utils::FileSystem::getLastWriteTime(genericPath) != (*it).second.lastWriteTime)
+            readDirectory(genericPath, (*it).second);
+        else
+            (*it).second.lastChecked = currentTime;
+    }
+
+    return (*it).second;
+}
+
+void MediaManifest::readDirectory(const std::string& genericPath, Directory& directory)
+{
+    directory.lastWriteTime = Utils::FileSystem::getLastWriteTime(genericPath);
+    directory.lastChecked = std::chrono::steady_clock::now();
+    directory.fileNames.clear();
+    directory.foldedFileNames.clear();
+    directory.subdirectories.clear();
+
+    // Most media directories don't exist, such as the ones for game subfolders without media.
+    if (directory.lastWriteTime == std::filesystem::file_time_type::min()) {
+        directory.recentlyModified = false;
+        return;
+    }
+
+    directory.recentlyModified = std::filesystem::file_time_type::clock::now() -
+                                     directory.lastWriteTime <
+                                 MODIFICATION_TIME_RESOLUTION;
+
+    try {
+#if defined(_WIN64)
+        for (auto& entry : std::filesystem::directory_iterator(
+                 Utils::String::stringToWideString(genericPath))) {
+            const std::string fileName {
+                Utils::String::wideStringToString(entry.path().filename().generic_wstring())};
+#else
+        for (auto& entry : std::filesystem::directory_iterator(genericPath)) {
+            const std::string fileName {entry.path().filename().generic_string()};
+#endif
+            // The entry types are normally known from the directory listing, only symlinks
+            // need to be resolved. Symlinked directories are not recursed into, the same as
+            // for Utils::FileSystem::getDirContent().
+            std::error_code errorCode;
+            if (entry.is_symlink(errorCode)) {
+                if (!entry.is_directory(errorCode)) {
+                    directory.fileNames.emplace_back(fileName);
+                    directory.foldedFileNames.emplace(foldFileName(fileName));
+                }
+            }
+            else if (entry.is_directory(errorCode)) {
+                directory.subdirectories.emplace_back(fileName);
+            }
+            else {
+                directory.fileNames.emplace_back(fileName);
+                directory.foldedFileNames.emplace(foldFileName(fileName));
+            }
+        }
+    }
+    catch (...) {
+#if defined(_WIN64)
+        LOG(LogError) << "MediaManifest::readDirectory(): Couldn't read directory \""
+                      << Utils::String::replace(genericPath, "/", "\\")
+                      << "\", permission problems?";
+#else
+        LOG(LogError) << "MediaManifest::readDirectory(): Couldn't read directory \""
+                      << genericPath << "\", permission problems?";
+#endif
+        directory.fileNames.clear();
+        directory.foldedFileNames.clear();
+        directory.subdirectories.clear();
+    }
+}
+
+void MediaManifest::getFilesRecursive(const std::string& genericPath,
+                                      std::vector<std::string>& files)
+{
+    // References to the map elements remain valid when new directories are inserted.
+    const Directory& cachedDirectory {getDirectory(genericPath, true)};
+
+    for (auto& fileName : cachedDirectory.fileNames)
+        files.emplace_back(genericPath + "/" + fileName);
+
+    for (auto& subdirectory : cachedDirectory.subdirectories)
+        getFilesRecursive(genericPath + "/" + subdirectory, files);
+}
+
+std::string MediaManifest::foldFileName(const std::string& fileName)
+{
+#if defined(_WIN64) || defined(__APPLE__) || defined(__ANDROID__)
+    // Although macOS may have filesystem case-sensitivity enabled it's rare and the impact
+    // would not be severe in this case anyway.
+    return Utils::String::toLower(fileName);
+#else
+    return fileName;
+#endif
+}
@@ -0,0 +1,69 @@
+//  SPDX-License-Identifier: MIT
+//
+//  ES-DE Frontend
+//  MediaManifest.h
+//
+//  Cached listings of the game media directories, shared by the FileData media getters,
+//  the screensaver, the media viewer and the orphaned data cleanup. Every directory is read
+//  once and is then only read again if its modification time has changed, which avoids
+//  checking the existence of each media file and extension separately. This makes a large
+//  difference on network mounts and on platforms with slow disk I/O such as Android.
+//
+
+#ifndef ES_APP_MEDIA_MANIFEST_H
+#define ES_APP_MEDIA_MANIFEST_H
+
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class MediaManifest
+{
+public:
+    static MediaManifest& getInstance();
+
+    // Returns directory + "/" + stem + extension for the first extension for which there is
+    // a file in the directory, or an empty string if there is no such file.
+    std::string findFile(const std::string& directory,
+                         const std::string& stem,
+                         const std::vector<std::string>& extensions);
+    // Returns the paths of all files in the directory and its subdirectories, sorted.
+    std::vector<std::string> getFilesRecursive(const std::string& directory);
+
+    // Discards the cached listings of the path, of everything below it and of its parent
+    // directory. This needs to be called whenever ES-DE itself adds or removes media files
+    // as the directory modification times have too coarse granularity to reliably detect
+    // changes done in quick succession.
+    void invalidate(const std::string& path);
+    void clear();
+
+private:
+    struct Directory {
+        std::filesystem::file_time_type lastWriteTime;
+        std::chrono::steady_clock::time_point lastChecked;
+        // Read again at the next check regardless of the modification time.
+        bool recentlyModified;
+        std::vector<std::string> fileNames;
+        // Lowercase on platforms with case-insensitive filesystems.
+        std::unordered_set<std::string> foldedFileNames;
+        std::vector<std::string> subdirectories;
+    };
+
+    MediaManifest() {}
+
+    // The mutex must be held when calling these functions.
+    const Directory& getDirectory(const std::string& genericPath, const bool forceCheck);
+    void readDirectory(const std::string& genericPath, Directory& directory);
+    void getFilesRecursive(const std::string& genericPath, std::vector<std::string>& files);
+
+    static std::string foldFileName(const std::string& fileName);
+
+    std::mutex mMutex;
+    std::unordered_map<std::string, Directory> mDirectories;
+};
+
+#endif // ES_APP_MEDIA_MANIFEST_H
@@ -9,6 +9,7 @@
 
 #include "MetaData.h"
 
+#include "FileData.h"
 #include "Log.h"
 #include "utils/FileSystemUtil.h"
 #include "utils/LocalizationUtil.h"
@@ -91,7 +92,8 @@ const std::vector<MetaDataDecl>& getMDDByType(MetaDataListType type)
 }
 
 MetaDataList::MetaDataList(MetaDataListType type)
-    : mType(type)
+    : mFileData {nullptr}
+    , mType(type)
     , mWasChanged(false)
 {
     const std::vector<MetaDataDecl>& mdd = getMDD();
@@ -99,6 +101,54 @@ MetaDataList::MetaDataList(MetaDataListType type)
         set(it->key, it->defaultValue);
 }
 
+MetaDataList::MetaDataList(const MetaDataList& other)
+    : mFileData {nullptr}
+    , mType {other.mType}
+    , mMap {other.mMap}
+    , mWasChanged {other.mWasChanged}
+{
+}
+
+MetaDataList::MetaDataList(MetaDataList&& other)
+    : mFileData {nullptr}
+    , mType {other.mType}
+    , mMap {std::move(other.mMap)}
+    , mWasChanged {other.mWasChanged}
+{
+}
+
+MetaDataList& MetaDataList::operator=(const MetaDataList& other)
+{
+    if (this == &other)
+        return *this;
+
+    const bool flagsChanged {mFileData != nullptr && !hasSameRandomGameFlags(other)};
+    mType = other.mType;
+    mMap = other.mMap;
+    mWasChanged = other.mWasChanged;
+
+    if (flagsChanged)
+        mFileData->invalidateRandomGameCandidates();
+
+    return *this;
+}
+
+MetaDataList& MetaDataList::operator=(MetaDataList&& other)
+{
+    if (this == &other)
+        return *this;
+
+    const bool flagsChanged {mFileData != nullptr && !hasSameRandomGameFlags(other)};
+    mType = other.mType;
+    mMap = std::move(other.mMap);
+    mWasChanged = other.mWasChanged;
+
+    if (flagsChanged)
+        mFileData->invalidateRandomGameCandidates();
+
+    return *this;
+}
+
 MetaDataList MetaDataList::createFromXML(MetaDataListType type,
                                          pugi::xml_node& node,
                                          const std::string& relativeTo)
@@ -123,6 +173,33 @@ MetaDataList MetaDataList::createFromXML(MetaDataListType type,
     return mdl;
 }
 
+MetaDataList MetaDataList::createFromValues(
+    MetaDataListType type,
+    const std::pair<std::string_view, std::string_view>* values,
+    const size_t valueCount,
+    const std::string& relativeTo)
+{
+    // The constructor has already set all the default values.
+    MetaDataList mdl(type);
+
+    const std::vector<MetaDataDecl>& mdd = mdl.getMDD();
+
+    for (auto it = mdd.cbegin(); it != mdd.cend(); ++it) {
+        for (size_t i {0}; i < valueCount; ++i) {
+            if (values[i].first != it->key)
+                continue;
+            if (!values[i].second.empty()) {
+                std::string value {values[i].second};
+                if (it->type == MD_PATH)
+                    value = Utils::FileSystem::resolveRelativePath(value, relativeTo, true);
+                mdl.set(it->key, value);
+            }
+            break;
+        }
+    }
+    return mdl;
+}
+
 void MetaDataList::appendToXML(pugi::xml_node& parent,
                                bool ignoreDefaults,
                                const std::string& relativeTo) const
@@ -149,8 +226,15 @@ void MetaDataList::appendToXML(pugi::xml_node& parent,
 
 void MetaDataList::set(const std::string& key, const std::string& value)
 {
-    mMap[key] = value;
+    std::string& storedValue {mMap[key]};
+    const bool flagChanged {mFileData != nullptr && storedValue != value &&
+                            (key == "hidden" || key == "kidgame" || key == "nogamecount")};
+
+    storedValue = value;
     mWasChanged = true;
+
+    if (flagChanged)
+        mFileData->invalidateRandomGameCandidates();
 }
 
 const std::string& MetaDataList::get(const std::string& key) const
@@ -180,6 +264,12 @@ bool MetaDataList::wasChanged() const
     return mWasChanged;
 }
 
+const bool MetaDataList::hasSameRandomGameFlags(const MetaDataList& other) const
+{
+    return get("hidden") == other.get("hidden") && get("kidgame") == other.get("kidgame") &&
+           get("nogamecount") == other.get("nogamecount");
+}
+
 void MetaDataList::resetChangedFlag()
 {
     // Reset the change flag.
@@ -16,6 +16,8 @@
 
 #include <map>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 namespace pugi
@@ -23,6 +25,8 @@ namespace pugi
     class xml_node;
 }
 
+class FileData;
+
 enum MetaDataType {
     // Generic types.
     MD_STRING,
@@ -68,11 +72,27 @@ public:
     static MetaDataList createFromXML(MetaDataListType type,
                                       pugi::xml_node& node,
                                       const std::string& relativeTo);
+    // Same as createFromXML() but for key and value pairs that have already been parsed from
+    // the gamelist.xml file. Values which are missing or empty are set to their defaults.
+    static MetaDataList createFromValues(
+        MetaDataListType type,
+        const std::pair<std::string_view, std::string_view>* values,
+        const size_t valueCount,
+        const std::string& relativeTo);
     void appendToXML(pugi::xml_node& parent,
                      bool ignoreDefaults,
                      const std::string& relativeTo) const;
 
     MetaDataList(MetaDataListType type);
+    // Only the values are copied, not the entry that the list belongs to.
+    MetaDataList(const MetaDataList& other);
+    MetaDataList(MetaDataList&& other);
+    MetaDataList& operator=(const MetaDataList& other);
+    MetaDataList& operator=(MetaDataList&& other);
+
+    // Changes to the hidden, kidgame and nogamecount values are reported to the entry so that
+    // the cached random game candidates of its systems can be invalidated.
+    void setFileData(FileData* file) { mFileData = file; }
 
     void set(const std::string& key, const std::string& value);
 
@@ -91,6 +111,9 @@ public:
     }
 
 private:
+    const bool hasSameRandomGameFlags(const MetaDataList& other) const;
+
+    FileData* mFileData;
     MetaDataListType mType;
     std::map<std::string, std::string> mMap;
     std::string mNoResult = "";
@@ -10,6 +10,7 @@
 #include "MiximageGenerator.h"
 
 #include "Log.h"
+#include "MediaManifest.h"
 #include "Settings.h"
 #include "SystemData.h"
 #include "utils/LocalizationUtil.h"
@@ -743,14 +744,14 @@ bool MiximageGenerator::generateImage()
     canvasImage.draw_image(xPosScreenshot, yPosScreenshot, screenshotImage);
 
     if (mMarquee)
-        canvasImage.draw_image(xPosMarquee, yPosMarquee, marqueeImageRGB, marqueeImageAlpha, 1,
-                               255);
+        Utils::CImg::alphaBlend(canvasImage, marqueeImageRGB, marqueeImageAlpha, xPosMarquee,
+                                yPosMarquee);
     if (mBox3D || mCover)
-        canvasImage.draw_image(xPosBox, yPosBox, boxImageRGB, boxImageAlpha, 1, 255);
+        Utils::CImg::alphaBlend(canvasImage, boxImageRGB, boxImageAlpha, xPosBox, yPosBox);
 
     if (mPhysicalMedia)
-        canvasImage.draw_image(xPosPhysicalMedia, yPosPhysicalMedia, physicalMediaImageRGB,
-                               physicalMediaImageAlpha, 1, 255);
+        Utils::CImg::alphaBlend(canvasImage, physicalMediaImageRGB, physicalMediaImageAlpha,
+                                xPosPhysicalMedia, yPosPhysicalMedia);
 
     std::vector<unsigned char> canvasVector;
 
@@ -773,6 +774,9 @@ bool MiximageGenerator::generateImage()
     if (!savedImage) {
         LOG(LogError) << "Couldn't save miximage, permission problems or disk full?";
     }
+    else {
+        MediaManifest::getInstance().invalidate(getSavePath());
+    }
 
     FreeImage_Unload(screenshotFile);
     FreeImage_Unload(marqueeFile);
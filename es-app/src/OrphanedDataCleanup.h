@@ -0,0 +1,69 @@
+//  SPDX-License-Identifier: MIT
+//
+//  ES-DE Frontend
+//  OrphanedDataCleanup.h
+//
+//  Removes orphaned game media, gamelist.xml entries and custom collections entries.
+//  Used by GuiOrphanedDataCleanup and by the command line (headless) mode.
+//
+
+#ifndef ES_APP_ORPHANED_DATA_CLEANUP_H
+#define ES_APP_ORPHANED_DATA_CLEANUP_H
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class OrphanedDataCleanup
+{
+public:
+    // The system delay is a pause after each processed system so that the progress can be
+    // followed when running from the GUI.
+    OrphanedDataCleanup(const int systemDelay);
+
+    // These functions are blocking and are normally run from a separate thread, the progress
+    // can be monitored using the getter functions below.
+    void cleanupMediaFiles();
+    void cleanupGamelists();
+    void cleanupCollections();
+
+    // Resets all state and flags the cleanup as processing, this needs to be called before
+    // starting a new cleanup run.
+    void reset();
+    void stop() { mStopProcessing = true; }
+
+    bool getIsProcessing() const { return mIsProcessing; }
+    bool getStopProcessing() const { return mStopProcessing; }
+    bool getCompleted() const { return mCompleted; }
+    bool getFailed() const { return mFailed; }
+    bool getNeedsReloading() const { return mNeedsReloading; }
+    bool getHasCustomCollections() const { return mHasCustomCollections; }
+    int getProcessedCount() const { return mProcessedCount; }
+    void clearCompleted() { mCompleted = false; }
+    void clearFailed() { mFailed = false; }
+
+    std::string getCurrentSystem();
+    std::string getErrorMessage();
+
+private:
+    std::mutex mMutex;
+
+    std::string mCurrentSystem;
+    std::string mErrorMessage;
+
+    std::string mMediaDirectory;
+    std::vector<std::string> mMediaTypes;
+
+    std::atomic<bool> mIsProcessing;
+    std::atomic<bool> mStopProcessing;
+    std::atomic<bool> mCompleted;
+    std::atomic<bool> mFailed;
+    std::atomic<bool> mNeedsReloading;
+    std::atomic<int> mProcessedCount;
+    bool mHasCustomCollections;
+    bool mCaseSensitiveFilesystem;
+    int mSystemDelay;
+};
+
+#endif // ES_APP_ORPHANED_DATA_CLEANUP_H
@@ -373,6 +373,20 @@ void Screensaver::renderScreensaver()
     }
 }
 
+bool Screensaver::isAnimating()
+{
+    if (mFallbackScreensaver || mScreensaverType == "dim")
+        return mDimValue > 0.4f || mSaturationAmount > 0.0f;
+    else if (mScreensaverType == "black")
+        return mDimValue > 0.0f;
+    else if (mScreensaverType == "video")
+        return true;
+
+    // Slideshow, fade-in of the image and the game info overlay.
+    return mOpacity < 1.0f ||
+           (Settings::getInstance()->getBool("ScreensaverSlideshowGameInfo") && mTextFadeIn < 255);
+}
+
 void Screensaver::update(int deltaTime)
 {
     // Update the timer that swaps the media, unless the swap time is set to 0 (only
@@ -410,70 +424,9 @@ void Screensaver::generateImageList()
         if (!(*it)->isGameSystem() || (*it)->isCollection())
             continue;
 
-#if defined(_WIN64)
-        const std::string mediaBaseDir {
-            Utils::String::replace(FileData::getMediaDirectory(), "\\", "/")};
-#else
-        const std::string mediaBaseDir {FileData::getMediaDirectory()};
-#endif
-        const std::string mediaDirMiximages {
-            mediaBaseDir + (*it)->getRootFolder()->getSystemName() + "/miximages"};
-        const std::string mediaDirScreenshots {
-            mediaBaseDir + (*it)->getRootFolder()->getSystemName() + "/screenshots"};
-        const std::string mediaDirTitlescreens {
-            mediaBaseDir + (*it)->getRootFolder()->getSystemName() + "/titlescreens"};
-        const std::string mediaDirCovers {mediaBaseDir + (*it)->getRootFolder()->getSystemName() +
-                                          "/covers"};
-
-        Utils::FileSystem::StringList dirContentMiximages;
-        Utils::FileSystem::StringList dirContentScreenshots;
-        Utils::FileSystem::StringList dirContentTitlescreens;
-        Utils::FileSystem::StringList dirContentCovers;
-
-        // This method of building an inventory of all image files isn't pretty, but to use the
-        // FileData::getImagePath() function leads to unacceptable performance issues on some
-        // platforms like Android that offer very poor disk I/O performance. To instead list
-        // all files recursively is much faster as this avoids stat() function calls which are
-        // very expensive on such problematic platforms.
-
-#if defined(_WIN64) || defined(__APPLE__) || defined(__ANDROID__)
-        // Although macOS may have filesystem case-sensitivity enabled it's rare and the impact
-        // would not be severe in this case anyway.
-        const bool caseSensitiveFilesystem {false};
-#else
-        const bool caseSensitiveFilesystem {true};
-#endif
-
-        for (auto& entry : Utils::FileSystem::getDirContent(mediaDirMiximages, true)) {
-            if (caseSensitiveFilesystem)
-                dirContentMiximages.emplace_back(entry);
-            else
-                dirContentMiximages.emplace_back(Utils::String::toLower(entry));
-        }
-
-        for (auto& entry : Utils::FileSystem::getDirContent(mediaDirScreenshots, true)) {
-            if (caseSensitiveFilesystem)
-                dirContentScreenshots.emplace_back(entry);
-            else
-                dirContentScreenshots.emplace_back(Utils::String::toLower(entry));
-        }
-
-        for (auto& entry : Utils::FileSystem::getDirContent(mediaDirTitlescreens, true)) {
-            if (caseSensitiveFilesystem)
-                dirContentTitlescreens.emplace_back(entry);
-            else
-                dirContentTitlescreens.emplace_back(Utils::String::toLower(entry));
-        }
-
-        for (auto& entry : Utils::FileSystem::getDirContent(mediaDirCovers, true)) {
-            if (caseSensitiveFilesystem)
-                dirContentCovers.emplace_back(entry);
-            else
-                dirContentCovers.emplace_back(Utils::String::toLower(entry));
-        }
-
-        std::string subFolders;
-
+        // The media files are looked up in the media manifest which lists each media directory
+        // only once, so this is fast also on platforms like Android that offer very poor disk
+        // I/O performance and where calling stat() for every game would be very expensive.
         std::vector<FileData*> allFiles {(*it)->getRootFolder()->getFilesRecursive(GAME, true)};
         for (auto it2 = allFiles.cbegin(); it2 != allFiles.cend(); ++it2) {
             // Only include games suitable for children if we're in Kid UI mode.
@@ -483,47 +436,8 @@ void Screensaver::generateImageList()
             if (favoritesOnly && (*it2)->metadata.get("favorite") != "true")
                 continue;
 
-            subFolders = Utils::String::replace(Utils::FileSystem::getParent((*it2)->getPath()),
-                                                (*it)->getStartPath(), "");
-            const std::string gamePath {subFolders + "/" + (*it2)->getDisplayName()};
-
-            for (auto& extension : FileData::sImageExtensions) {
-                if (std::find(
-                        dirContentMiximages.cbegin(), dirContentMiximages.cend(),
-                        (caseSensitiveFilesystem ?
-                             mediaDirMiximages + gamePath + extension :
-                             Utils::String::toLower(mediaDirMiximages + gamePath + extension))) !=
-                    dirContentMiximages.cend()) {
-                    mImageFiles.push_back((*it2));
-                    break;
-                }
-                if (std::find(
-                        dirContentScreenshots.cbegin(), dirContentScreenshots.cend(),
-                        (caseSensitiveFilesystem ?
-                             mediaDirScreenshots + gamePath + extension :
-                             Utils::String::toLower(mediaDirScreenshots + gamePath + extension))) !=
-                    dirContentScreenshots.cend()) {
-                    mImageFiles.push_back((*it2));
-                    break;
-                }
-                if (std::find(dirContentTitlescreens.cbegin(), dirContentTitlescreens.cend(),
-                              (caseSensitiveFilesystem ?
-                                   mediaDirTitlescreens + gamePath + extension :
-                                   Utils::String::toLower(mediaDirTitlescreens + gamePath +
-                                                          extension))) !=
-                    dirContentTitlescreens.cend()) {
-                    mImageFiles.push_back((*it2));
-                    break;
-                }
-                if (std::find(dirContentCovers.cbegin(), dirContentCovers.cend(),
-                              (caseSensitiveFilesystem ?
-                                   mediaDirCovers + gamePath + extension :
-                                   Utils::String::toLower(mediaDirCovers + gamePath +
-                                                          extension))) != dirContentCovers.cend()) {
-                    mImageFiles.push_back((*it2));
-                    break;
-                }
-            }
+            if ((*it2)->getImagePath() != "")
+                mImageFiles.push_back((*it2));
         }
     }
 
@@ -540,38 +454,7 @@ void Screensaver::generateVideoList()
         if (!(*it)->isGameSystem() || (*it)->isCollection())
             continue;
 
-#if defined(_WIN64)
-        const std::string mediaBaseDir {
-            Utils::String::replace(FileData::getMediaDirectory(), "\\", "/")};
-#else
-        const std::string mediaBaseDir {FileData::getMediaDirectory()};
-#endif
-        const std::string mediaDir {mediaBaseDir + (*it)->getRootFolder()->getSystemName() +
-                                    "/videos"};
-        Utils::FileSystem::StringList dirContent;
-
-        // This method of building an inventory of all video files isn't pretty, but to use the
-        // FileData::getVideoPath() function leads to unacceptable performance issues on some
-        // platforms like Android that offer very poor disk I/O performance. To instead list
-        // all files recursively is much faster as this avoids stat() function calls which are
-        // very expensive on such problematic platforms.
-
-#if defined(_WIN64) || defined(__APPLE__) || defined(__ANDROID__)
-        // Although macOS may have filesystem case-sensitivity enabled it's rare and the impact
-        // would not be severe in this case anyway.
-        const bool caseSensitiveFilesystem {false};
-#else
-        const bool caseSensitiveFilesystem {true};
-#endif
-        for (auto& entry : Utils::FileSystem::getDirContent(mediaDir, true)) {
-            if (caseSensitiveFilesystem)
-                dirContent.emplace_back(entry);
-            else
-                dirContent.emplace_back(Utils::String::toLower(entry));
-        }
-
-        std::string subFolders;
-
+        // See the comment in generateImageList() regarding the media manifest.
         std::vector<FileData*> allFiles {(*it)->getRootFolder()->getFilesRecursive(GAME, true)};
         for (auto it2 = allFiles.cbegin(); it2 != allFiles.cend(); ++it2) {
             // Only include games suitable for children if we're in Kid UI mode.
@@ -581,20 +464,8 @@ void Screensaver::generateVideoList()
             if (favoritesOnly && (*it2)->metadata.get("favorite") != "true")
                 continue;
 
-            subFolders = Utils::String::replace(Utils::FileSystem::getParent((*it2)->getPath()),
-                                                (*it)->getStartPath(), "");
-            const std::string gamePath {subFolders + "/" + (*it2)->getDisplayName()};
-
-            for (auto& extension : FileData::sVideoExtensions) {
-                if (std::find(dirContent.cbegin(), dirContent.cend(),
-                              (caseSensitiveFilesystem ?
-                                   mediaDir + gamePath + extension :
-                                   Utils::String::toLower(mediaDir + gamePath + extension))) !=
-                    dirContent.cend()) {
-                    mVideoFiles.push_back((*it2));
-                    break;
-                }
-            }
+            if ((*it2)->getVideoPath() != "")
+                mVideoFiles.push_back((*it2));
         }
     }
 
@@ -31,6 +31,7 @@ public:
 
     virtual void renderScreensaver();
     virtual void update(int deltaTime);
+    virtual bool isAnimating();
 
     virtual FileData* getCurrentGame() { return mCurrentGame; }
     virtual void triggerNextGame() { mTriggerNextGame = true; }
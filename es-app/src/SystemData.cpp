@@ -18,6 +18,7 @@
 #include "InputManager.h"
 #include "Log.h"
 #include "Settings.h"
+#include "StartupTimer.h"
 #include "ThemeData.h"
 #include "UIModeController.h"
 #include "resources/ResourceManager.h"
@@ -33,6 +34,17 @@
 #include <fstream>
 #include <pugixml.hpp>
 #include <random>
+#include <unordered_set>
+
+namespace
+{
+    std::mt19937& getRandomEngine()
+    {
+        // Mersenne Twister pseudorandom number generator, seeded once.
+        static std::mt19937 engine {std::random_device {}()};
+        return engine;
+    }
+} // namespace
 
 FindRules::FindRules()
 {
@@ -231,6 +243,7 @@ SystemData::SystemData(const std::string& name,
     , mScrapeFlag {false}
     , mFlattenFolders {false}
     , mPlaceholder {nullptr}
+    , mRandomGameCandidatesValid {false}
 {
     mFilterIndex = new FileFilterIndex();
 
@@ -240,15 +253,19 @@ SystemData::SystemData(const std::string& name,
         mRootFolder->metadata.set("name", mFullName);
 
         if (!Settings::getInstance()->getBool("ParseGamelistOnly")) {
+            StartupTimer::Phase phase {"scan", mName};
             // If there was an error populating the folder or if there were no games found,
             // then don't continue with any additional process steps for this system.
             if (!populateFolder(mRootFolder))
                 return;
         }
 
-        if (!Settings::getInstance()->getBool("IgnoreGamelist"))
+        if (!Settings::getInstance()->getBool("IgnoreGamelist")) {
+            StartupTimer::Phase phase {"parse", mName};
             GamelistFileParser::parseGamelist(this);
+        }
 
+        StartupTimer::Phase phase {"sort", mName};
         setupSystemSortType(mRootFolder);
 
         mRootFolder->sort(mRootFolder->getSortTypeFromString(mRootFolder->getSortTypeString()),
@@ -268,6 +285,8 @@ SystemData::SystemData(const std::string& name,
         new FileData(PLACEHOLDER, "<" + _("No Entries Found") + ">", getSystemEnvData(), this);
 
     setIsGameSystemStatus();
+
+    StartupTimer::Phase phase {"theme", mName};
     loadTheme(ThemeTriggers::TriggerType::NONE);
 }
 
@@ -285,6 +304,24 @@ SystemData::~SystemData()
     delete mFilterIndex;
 }
 
+std::vector<FileData*>& SystemData::getRandomGameCandidates()
+{
+    if (!mRandomGameCandidatesValid) {
+        mRandomGameCandidates = mRootFolder->getFilesRecursive(GAME, false, false);
+        mRandomKidGameCandidates.clear();
+        for (auto game : mRandomGameCandidates) {
+            if (game->getKidgame())
+                mRandomKidGameCandidates.emplace_back(game);
+        }
+        mRandomGameCandidatesValid = true;
+    }
+
+    if (Settings::getInstance()->getString("UIMode") == "kid")
+        return mRandomKidGameCandidates;
+    else
+        return mRandomGameCandidates;
+}
+
 void SystemData::setIsGameSystemStatus()
 {
     // Reserved for future use, could be used to exclude certain systems from some operations,
@@ -297,12 +334,9 @@ bool SystemData::populateFolder(FileData* folder)
     if (mSymlinkMaxDepthReached)
         return false;
 
-    std::string filePath;
-    std::string extension;
     const std::string& folderPath {folder->getPath()};
     const bool showHiddenFiles {Settings::getInstance()->getBool("ShowHiddenFiles")};
     const Utils::FileSystem::StringList& dirContent {Utils::FileSystem::getDirContent(folderPath)};
-    bool isGame {false};
 
     // If system directory exists but contains no games, return as error.
     if (dirContent.size() == 0)
@@ -321,139 +355,323 @@ bool SystemData::populateFolder(FileData* folder)
         mFlattenFolders = true;
     }
 
-    for (Utils::FileSystem::StringList::const_iterator it {dirContent.cbegin()};
-         it != dirContent.cend(); ++it) {
-        filePath = *it;
-        const bool isDirectory {Utils::FileSystem::isDirectory(filePath)};
+    for (auto& filePath : dirContent) {
+        if (!populateEntry(folder, filePath, showHiddenFiles))
+            return false;
+    }
+    return true;
+}
 
-        // Skip any recursive symlinks as those would hang the application at various places.
-        if (Utils::FileSystem::isSymlink(filePath)) {
-            if (Utils::FileSystem::resolveSymlink(filePath) ==
-                Utils::FileSystem::getFileName(filePath)) {
-                LOG(LogWarning) << "Skipped \"" << filePath << "\" as it's a recursive symlink";
-                continue;
-            }
-        }
+bool SystemData::populateEntry(FileData* folder,
+                               const std::string& filePath,
+                               const bool showHiddenFiles)
+{
+    const bool isDirectory {Utils::FileSystem::isDirectory(filePath)};
 
-        // Skip hidden files and folders.
-        if (!showHiddenFiles && Utils::FileSystem::isHidden(filePath)) {
-            LOG(LogDebug) << "SystemData::populateFolder(): Skipping hidden "
-                          << (isDirectory ? "directory \"" : "file \"") << filePath << "\"";
-            continue;
+    // Skip any recursive symlinks as those would hang the application at various places.
+    if (Utils::FileSystem::isSymlink(filePath)) {
+        if (Utils::FileSystem::resolveSymlink(filePath) ==
+            Utils::FileSystem::getFileName(filePath)) {
+            LOG(LogWarning) << "Skipped \"" << filePath << "\" as it's a recursive symlink";
+            return true;
         }
+    }
 
-        // This is a little complicated because we allow a list
-        // of extensions to be defined (delimited with a space).
-        // We first get the extension of the file itself:
-        extension = Utils::FileSystem::getExtension(filePath);
+    // Skip hidden files and folders.
+    if (!showHiddenFiles && Utils::FileSystem::isHidden(filePath)) {
+        LOG(LogDebug) << "SystemData::populateEntry(): Skipping hidden "
+                      << (isDirectory ? "directory \"" : "file \"") << filePath << "\"";
+        return true;
+    }
 
-        isGame = false;
+    // This is a little complicated because we allow a list
+    // of extensions to be defined (delimited with a space).
+    // We first get the extension of the file itself:
+    const std::string extension {Utils::FileSystem::getExtension(filePath)};
+    bool isGame {false};
 
-        if (std::find(mEnvData->mSearchExtensions.cbegin(), mEnvData->mSearchExtensions.cend(),
-                      extension) != mEnvData->mSearchExtensions.cend() &&
-            !(isDirectory && extension == ".")) {
-            FileData* newGame {new FileData(GAME, filePath, mEnvData, this)};
+    if (std::find(mEnvData->mSearchExtensions.cbegin(), mEnvData->mSearchExtensions.cend(),
+                  extension) != mEnvData->mSearchExtensions.cend() &&
+        !(isDirectory && extension == ".")) {
+        FileData* newGame {new FileData(GAME, filePath, mEnvData, this)};
 
-            if (newGame->metadata.get("name") == "") {
-                LOG(LogWarning) << "Skipped \"" << filePath << "\" as it has no filename";
-                delete newGame;
-                continue;
-            }
+        if (newGame->metadata.get("name") == "") {
+            LOG(LogWarning) << "Skipped \"" << filePath << "\" as it has no filename";
+            delete newGame;
+            return true;
+        }
 
-            // If adding a configured file extension to a directory it will get interpreted as
-            // a regular file. This is useful for displaying multi-file/multi-disc games as single
-            // entries or for emulators that can get directories passed to them as command line
-            // parameters instead of regular files. In these instances we remove the extension
-            // from the metadata name so it does not show up in the gamelists and similar.
-            if (isDirectory && extension != ".") {
-                const std::string folderName {newGame->metadata.get("name")};
-                newGame->metadata.set(
-                    "name", folderName.substr(0, folderName.length() - extension.length()));
-            }
+        // If adding a configured file extension to a directory it will get interpreted as
+        // a regular file. This is useful for displaying multi-file/multi-disc games as single
+        // entries or for emulators that can get directories passed to them as command line
+        // parameters instead of regular files. In these instances we remove the extension
+        // from the metadata name so it does not show up in the gamelists and similar.
+        if (isDirectory && extension != ".") {
+            const std::string folderName {newGame->metadata.get("name")};
+            newGame->metadata.set(
+                "name", folderName.substr(0, folderName.length() - extension.length()));
+        }
 
-            // Prevent new arcade assets from being added.
-            if (!newGame->isArcadeAsset()) {
-                folder->addChild(newGame);
-                isGame = true;
-            }
-            else {
-                delete newGame;
-            }
+        // Prevent new arcade assets from being added.
+        if (!newGame->isArcadeAsset()) {
+            folder->addChild(newGame);
+            isGame = true;
         }
+        else {
+            delete newGame;
+        }
+    }
 
-        // Add directories that also do not match an extension as folders.
-        if (!isGame && isDirectory) {
-            // Make sure that it's not a recursive symlink as the application would run into a
-            // loop trying to resolve the link.
-            if (Utils::FileSystem::isSymlink(filePath)) {
-                bool recursiveSymlink {false};
-                const std::string& canonicalPath {Utils::FileSystem::getCanonicalPath(filePath)};
-                const std::string& canonicalStartPath {
-                    Utils::FileSystem::getCanonicalPath(mEnvData->mStartPath)};
-                // Last resort hack to prevent recursive symlinks in some really unusual situations.
-                if (filePath.length() > canonicalStartPath.length() + 100) {
-                    int folderDepth {0};
-                    const std::string& path {filePath.substr(canonicalStartPath.length())};
-                    for (char character : path) {
-                        if (character == '/') {
-                            ++folderDepth;
-                            if (folderDepth == 20) {
-                                LOG(LogWarning) << "Skipped \"" << filePath
-                                                << "\" as it seems to be a recursive symlink";
-                                mSymlinkMaxDepthReached = true;
-                                return false;
-                            }
+    // Add directories that also do not match an extension as folders.
+    if (!isGame && isDirectory) {
+        // Make sure that it's not a recursive symlink as the application would run into a
+        // loop trying to resolve the link.
+        if (Utils::FileSystem::isSymlink(filePath)) {
+            bool recursiveSymlink {false};
+            const std::string& canonicalPath {Utils::FileSystem::getCanonicalPath(filePath)};
+            const std::string& canonicalStartPath {
+                Utils::FileSystem::getCanonicalPath(mEnvData->mStartPath)};
+            // Last resort hack to prevent recursive symlinks in some really unusual situations.
+            if (filePath.length() > canonicalStartPath.length() + 100) {
+                int folderDepth {0};
+                const std::string& path {filePath.substr(canonicalStartPath.length())};
+                for (char character : path) {
+                    if (character == '/') {
+                        ++folderDepth;
+                        if (folderDepth == 20) {
+                            LOG(LogWarning) << "Skipped \"" << filePath
+                                            << "\" as it seems to be a recursive symlink";
+                            mSymlinkMaxDepthReached = true;
+                            return false;
                         }
                     }
                 }
-                if (canonicalStartPath.find(canonicalPath) != std::string::npos)
+            }
+            if (canonicalStartPath.find(canonicalPath) != std::string::npos)
+                recursiveSymlink = true;
+            else if (canonicalPath.size() >= canonicalStartPath.size() &&
+                     canonicalPath.find(canonicalStartPath) != std::string::npos) {
+                const std::string& combinedPath {
+                    mEnvData->mStartPath +
+                    canonicalPath.substr(canonicalStartPath.size(),
+                                         canonicalStartPath.size() - canonicalPath.size())};
+                if (Utils::FileSystem::getParent(filePath).find(combinedPath) == 0)
                     recursiveSymlink = true;
-                else if (canonicalPath.size() >= canonicalStartPath.size() &&
-                         canonicalPath.find(canonicalStartPath) != std::string::npos) {
-                    const std::string& combinedPath {
-                        mEnvData->mStartPath +
-                        canonicalPath.substr(canonicalStartPath.size(),
-                                             canonicalStartPath.size() - canonicalPath.size())};
-                    if (Utils::FileSystem::getParent(filePath).find(combinedPath) == 0)
-                        recursiveSymlink = true;
-                }
-                if (recursiveSymlink) {
-                    LOG(LogWarning) << "Skipped \"" << filePath << "\" as it's a recursive symlink";
-                    continue;
-                }
             }
+            if (recursiveSymlink) {
+                LOG(LogWarning) << "Skipped \"" << filePath << "\" as it's a recursive symlink";
+                return true;
+            }
+        }
 
-            if (Utils::FileSystem::exists(filePath + "/noload.txt")) {
+        if (Utils::FileSystem::exists(filePath + "/noload.txt")) {
 #if defined(_WIN64)
-                LOG(LogInfo) << "Skipped folder \"" << Utils::String::replace(filePath, "/", "\\")
-                             << "\" as a noload.txt file is present";
+            LOG(LogInfo) << "Skipped folder \"" << Utils::String::replace(filePath, "/", "\\")
+                         << "\" as a noload.txt file is present";
 #else
-                LOG(LogInfo) << "Skipped folder \"" << filePath
-                             << "\" as a noload.txt file is present";
+            LOG(LogInfo) << "Skipped folder \"" << filePath
+                         << "\" as a noload.txt file is present";
 #endif
-                FileData* newFolder {new FileData(FOLDER, filePath, mEnvData, this)};
-                newFolder->setNoLoad(true);
+            FileData* newFolder {new FileData(FOLDER, filePath, mEnvData, this)};
+            newFolder->setNoLoad(true);
+            folder->addChild(newFolder);
+            return true;
+        }
+
+        FileData* newFolder {new FileData(FOLDER, filePath, mEnvData, this)};
+        populateFolder(newFolder);
+
+        if (mFlattenFolders) {
+            for (auto& entry : newFolder->getChildrenByFilename())
+                folder->addChild(entry.second);
+        }
+        else {
+            // Ignore folders that do not contain games.
+            if (newFolder->getChildrenByFilename().size() == 0)
+                delete newFolder;
+            else
                 folder->addChild(newFolder);
-                continue;
+        }
+    }
+    return true;
+}
+
+void SystemData::updateFolders(const std::vector<std::string>& directories,
+                               std::vector<FileData*>& addedGames,
+                               std::vector<FileData*>& removedFiles)
+{
+    // With flattened folders the tree doesn't correspond to the directories.
+    if (mIsCollectionSystem || mFlattenFolders)
+        return;
+
+    const bool showHiddenFiles {Settings::getInstance()->getBool("ShowHiddenFiles")};
+    std::vector<FileData*> addedFiles;
+    std::vector<FileData*> detachedFiles;
+
+    for (auto& directory : directories) {
+        FileData* folder {findEntry(directory)};
+
+        // Directories that have been removed are handled when updating their parent
+        // directories, and changes inside directories that are games are not of interest.
+        if (folder == nullptr || folder->getType() != FOLDER ||
+            !Utils::FileSystem::isDirectory(folder->getPath()))
+            continue;
+
+        const Utils::FileSystem::StringList& dirContent {
+            Utils::FileSystem::getDirContent(folder->getPath())};
+        std::unordered_set<std::string> fileNames;
+        for (auto& filePath : dirContent)
+            fileNames.emplace(Utils::FileSystem::getFileName(filePath));
+
+        std::unordered_set<std::string>& skippedEntries {mSkippedEntries[folder->getPath()]};
+        for (auto it = skippedEntries.begin(); it != skippedEntries.end();) {
+            if (fileNames.find(*it) == fileNames.cend()) {
+                mSkippedEntries.erase(folder->getPath() + "/" + *it);
+                it = skippedEntries.erase(it);
+            }
+            else {
+                ++it;
             }
+        }
 
-            FileData* newFolder {new FileData(FOLDER, filePath, mEnvData, this)};
-            populateFolder(newFolder);
+        const std::vector<FileData*> children {folder->getChildren()};
+        for (auto child : children) {
+            if (fileNames.find(child->getKey()) == fileNames.cend()) {
+                folder->removeChild(child);
+                detachedFiles.emplace_back(child);
+            }
+        }
+
+        for (auto& filePath : dirContent) {
+            const std::string& fileName {Utils::FileSystem::getFileName(filePath)};
+            if (folder->getChildrenByFilename().find(fileName) !=
+                    folder->getChildrenByFilename().cend() ||
+                skippedEntries.find(fileName) != skippedEntries.cend())
+                continue;
 
-            if (mFlattenFolders) {
-                for (auto& entry : newFolder->getChildrenByFilename())
-                    folder->addChild(entry.second);
+            const size_t childCount {folder->getChildren().size()};
+            if (!populateEntry(folder, filePath, showHiddenFiles))
+                break;
+            if (folder->getChildren().size() == childCount)
+                continue;
+
+            FileData* child {folder->getChildren().back()};
+            // Folders with a noload.txt file are only kept in the tree until the gamelist
+            // has been parsed when populating the system.
+            if (child->getNoLoad()) {
+                skippedEntries.emplace(fileName);
+                delete child;
             }
             else {
-                // Ignore folders that do not contain games.
-                if (newFolder->getChildrenByFilename().size() == 0)
-                    delete newFolder;
-                else
-                    folder->addChild(newFolder);
+                addedFiles.emplace_back(child);
             }
         }
+
+        // Folders that no longer contain any games are removed, the same as when populating.
+        while (folder != mRootFolder && folder->getChildren().empty()) {
+            FileData* parent {folder->getParent()};
+            parent->removeChild(folder);
+            detachedFiles.emplace_back(folder);
+            folder = parent;
+        }
     }
-    return true;
+
+    // Entries could have been added to folders that were then removed.
+    auto isDetached = [this](const FileData* file) {
+        while (file->getParent() != nullptr)
+            file = file->getParent();
+        return file != mRootFolder;
+    };
+    addedFiles.erase(std::remove_if(addedFiles.begin(), addedFiles.end(), isDetached),
+                     addedFiles.end());
+
+    if (addedFiles.empty() && detachedFiles.empty())
+        return;
+
+    for (auto file : detachedFiles) {
+        if (file->getType() == GAME) {
+            mFilterIndex->removeFromIndex(file);
+        }
+        else {
+            for (auto game : file->getFilesRecursive(GAME))
+                mFilterIndex->removeFromIndex(game);
+        }
+        removedFiles.emplace_back(file);
+    }
+
+    std::vector<std::string> addedGamePaths;
+    std::unordered_set<std::string> addedPaths;
+
+    for (auto file : addedFiles) {
+        addedPaths.emplace(file->getPath());
+        if (file->getType() == GAME) {
+            addedGamePaths.emplace_back(file->getPath());
+            continue;
+        }
+        for (auto child : file->getFilesRecursive(GAME | FOLDER)) {
+            addedPaths.emplace(child->getPath());
+            if (child->getType() == GAME)
+                addedGamePaths.emplace_back(child->getPath());
+        }
+    }
+
+    // Entries that are flagged as hidden in the gamelist could get deleted while parsing,
+    // so the games are looked up again afterwards.
+    if (!addedPaths.empty() && !Settings::getInstance()->getBool("IgnoreGamelist")) {
+        GamelistFileParser::parseGamelist(this, addedPaths);
+
+        for (auto& path : addedPaths) {
+            const FileData* entry {findEntry(path)};
+            if (entry == nullptr || entry->getPath() != path) {
+                mSkippedEntries[Utils::FileSystem::getParent(path)].emplace(
+                    Utils::FileSystem::getFileName(path));
+            }
+        }
+    }
+
+    for (auto& path : addedGamePaths) {
+        FileData* game {findEntry(path)};
+        if (game != nullptr && game->getType() == GAME && game->getPath() == path) {
+            mFilterIndex->addToIndex(game);
+            addedGames.emplace_back(game);
+        }
+    }
+
+    mRootFolder->sort(mRootFolder->getSortTypeFromString(mRootFolder->getSortTypeString()),
+                      Settings::getInstance()->getBool("FavoritesFirst"));
+}
+
+FileData* SystemData::findEntry(const std::string& path) const
+{
+    const std::string& startPath {mEnvData->mStartPath};
+
+    if (path.compare(0, startPath.length(), startPath) != 0 ||
+        (path.length() > startPath.length() && path[startPath.length()] != '/'))
+        return nullptr;
+
+    FileData* entry {mRootFolder};
+    size_t position {startPath.length() + 1};
+
+    while (position < path.length()) {
+        // Changes inside directories that are games don't affect the tree.
+        if (entry->getType() != FOLDER)
+            return nullptr;
+
+        size_t separator {path.find('/', position)};
+        if (separator == std::string::npos)
+            separator = path.length();
+
+        const std::unordered_map<std::string, FileData*>& children {
+            entry->getChildrenByFilename()};
+        auto it = children.find(path.substr(position, separator - position));
+        if (it == children.cend())
+            break;
+
+        entry = (*it).second;
+        position = separator + 1;
+    }
+
+    return entry;
 }
 
 void SystemData::indexAllGameFilters(const FileData* folder)
@@ -873,8 +1091,10 @@ bool SystemData::loadConfig()
     });
 
     // Don't load any collections if there are no systems available.
-    if (sSystemVector.size() > 0)
+    if (sSystemVector.size() > 0) {
+        StartupTimer::Phase phase {"collections"};
         CollectionSystemsManager::getInstance()->loadCollectionSystems();
+    }
 
     return false;
 }
@@ -984,6 +1204,9 @@ void SystemData::deleteSystems()
         delete sSystemVector.at(i);
 
     sSystemVector.clear();
+
+    // The systems may have queued gamelist.xml writes when they were deleted.
+    GamelistFileParser::flushGamelistWrites();
 }
 
 std::vector<std::string> SystemData::getConfigPath()
@@ -1440,11 +1663,8 @@ SystemData* SystemData::getRandomSystem(const SystemData* currentSystem)
 
     do {
         // Get a random number in range.
-        std::random_device randDev;
-        //  Mersenne Twister pseudorandom number generator.
-        std::mt19937 engine {randDev()};
         std::uniform_int_distribution<int> uniform_dist {0, total - 1};
-        int target {uniform_dist(engine)};
+        int target {uniform_dist(getRandomEngine())};
 
         for (auto it = sSystemVector.cbegin(); it != sSystemVector.cend(); ++it) {
             if ((*it)->isGameSystem()) {
@@ -1462,7 +1682,7 @@ SystemData* SystemData::getRandomSystem(const SystemData* currentSystem)
     return randomSystem;
 }
 
-FileData* SystemData::getRandomGame(const FileData* currentGame, bool gameSelectorMode)
+FileData* SystemData::getRandomGame(const FileData* currentGame)
 {
     std::vector<FileData*> gameList;
     bool onlyFolders {false};
@@ -1475,27 +1695,12 @@ FileData* SystemData::getRandomGame(const FileData* currentGame, bool gameSelect
         gameList = mRootFolder->getParent()->getChildrenListToDisplay();
     }
     else {
-        if (gameSelectorMode) {
-            gameList = mRootFolder->getFilesRecursive(GAME, false, false);
-            if (Settings::getInstance()->getString("UIMode") == "kid") {
-                // Doing some extra work here instead of in FileData is OK as it's only needed
-                // for the rare combination of a gameselector being present while in kid mode.
-                for (auto it = gameList.begin(); it != gameList.end();) {
-                    if (!(*it)->getKidgame())
-                        it = gameList.erase(it);
-                    else
-                        ++it;
-                }
-            }
-        }
-        else {
-            gameList = ViewController::getInstance()
-                           ->getGamelistView(mRootFolder->getSystem())
-                           .get()
-                           ->getCursor()
-                           ->getParent()
-                           ->getChildrenListToDisplay();
-        }
+        gameList = ViewController::getInstance()
+                       ->getGamelistView(mRootFolder->getSystem())
+                       .get()
+                       ->getCursor()
+                       ->getParent()
+                       ->getChildrenListToDisplay();
     }
 
     if (gameList.size() > 0 && gameList.front()->getParent()->getOnlyFoldersFlag())
@@ -1507,13 +1712,9 @@ FileData* SystemData::getRandomGame(const FileData* currentGame, bool gameSelect
     // If this is a mixed view of folders and files, then remove all the folder entries
     // as we want to exclude them from the random selection.
     if (!onlyFolders && hasFolders) {
-        unsigned int i {0};
-        do {
-            if (gameList[i]->getType() == FOLDER)
-                gameList.erase(gameList.begin() + i);
-            else
-                ++i;
-        } while (i < gameList.size());
+        gameList.erase(std::remove_if(gameList.begin(), gameList.end(),
+                                      [](FileData* file) { return file->getType() == FOLDER; }),
+                       gameList.end());
     }
 
     if (!currentGame && gameList.size() == 1)
@@ -1532,18 +1733,53 @@ FileData* SystemData::getRandomGame(const FileData* currentGame, bool gameSelect
     if (total < 2)
         return nullptr;
 
+    std::uniform_int_distribution<int> uniform_dist {0, total - 1};
     do {
         // Get a random number in range.
-        std::random_device randDev;
-        //  Mersenne Twister pseudorandom number generator.
-        std::mt19937 engine {randDev()};
-        std::uniform_int_distribution<int> uniform_dist {0, total - 1};
-        target = uniform_dist(engine);
+        target = uniform_dist(getRandomEngine());
     } while (currentGame && gameList.at(target) == currentGame);
 
     return gameList.at(target);
 }
 
+std::vector<FileData*> SystemData::getRandomGames(const int count,
+                                                  const FileData* excludeGame,
+                                                  const bool allowDuplicates)
+{
+    std::vector<FileData*>& candidates {getRandomGameCandidates()};
+    std::vector<FileData*> games;
+    const int total {static_cast<int>(candidates.size())};
+
+    if (total == 0 || count < 1)
+        return games;
+
+    std::mt19937& engine {getRandomEngine()};
+    int end {total};
+
+    // Partial Fisher-Yates shuffle, the candidates are reordered in place as their order
+    // doesn't matter. This gives distinct games without having to retry any selections.
+    for (int i {0}; i < std::min(count, end); ++i) {
+        int target {std::uniform_int_distribution<int> {i, end - 1}(engine)};
+        // Move the excluded game out of the range that is selected from.
+        if (candidates[target] == excludeGame && total > 1) {
+            std::swap(candidates[target], candidates[--end]);
+            if (i == end)
+                break;
+            target = std::uniform_int_distribution<int> {i, end - 1}(engine);
+        }
+        std::swap(candidates[i], candidates[target]);
+        games.emplace_back(candidates[i]);
+    }
+
+    if (allowDuplicates && !games.empty()) {
+        std::uniform_int_distribution<int> uniform_dist {0, static_cast<int>(games.size()) - 1};
+        while (static_cast<int>(games.size()) < count)
+            games.emplace_back(games[uniform_dist(engine)]);
+    }
+
+    return games;
+}
+
 void SystemData::sortSystem(bool reloadGamelist, bool jumpToFirstRow)
 {
     if (getName() == "recent")
@@ -1593,6 +1829,9 @@ void SystemData::loadTheme(ThemeTriggers::TriggerType trigger)
 {
     mTheme = std::make_shared<ThemeData>();
 
+    if (sHeadlessMode)
+        return;
+
     const std::string& path {getThemePath()};
 
     if (!Utils::FileSystem::exists(path)) {
@@ -1711,6 +1950,15 @@ void SystemData::onMetaDataSavePoint()
     writeMetaData();
 }
 
+void SystemData::onStatisticsSavePoint(const std::vector<FileData*>& files)
+{
+    if (Settings::getInstance()->getString("SaveGamelistsMode") != "always" ||
+        Settings::getInstance()->getBool("IgnoreGamelist") || mIsCollectionSystem)
+        return;
+
+    GamelistFileParser::appendStatistics(this, files);
+}
+
 void SystemData::setupSystemSortType(FileData* rootFolder)
 {
     // If DefaultSortOrder is set to something, check that it is actually a valid value.
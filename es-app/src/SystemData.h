@@ -19,6 +19,8 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 class FileData;
@@ -121,6 +123,8 @@ public:
     static inline std::vector<SystemData*> sSystemVector;
     static inline std::unique_ptr<FindRules> sFindRules;
     static inline bool sStartupExitSignal {false};
+    // Set when running one of the command line batch modes, in which case no themes are loaded.
+    static inline bool sHeadlessMode {false};
 
     const bool isCollection() const { return mIsCollectionSystem; }
     const bool isCustomCollection() const { return mIsCustomCollectionSystem; }
@@ -135,8 +139,16 @@ public:
     SystemData* getNext() const;
     SystemData* getPrev() const;
     static SystemData* getRandomSystem(const SystemData* currentSystem);
-    FileData* getRandomGame(const FileData* currentGame = nullptr, bool gameSelectorMode = false);
+    FileData* getRandomGame(const FileData* currentGame = nullptr);
+    // Returns up to count distinct random games, excluding excludeGame if there are other games
+    // to choose from. Games are only repeated if allowDuplicates is set and there are fewer games
+    // than requested. Used by the gameselector component.
+    std::vector<FileData*> getRandomGames(const int count,
+                                          const FileData* excludeGame,
+                                          const bool allowDuplicates);
     FileData* getPlaceholder() { return mPlaceholder; }
+    // Called by FileData when games are added, removed or have their flags changed.
+    void invalidateRandomGameCandidates() { mRandomGameCandidatesValid = false; }
 
     void sortSystem(bool reloadGamelist = true, bool jumpToFirstRow = false);
 
@@ -145,10 +157,20 @@ public:
 
     FileFilterIndex* getIndex() { return mFilterIndex; }
     void onMetaDataSavePoint();
+    // Used after launching games, only the playcount and lastplayed values have been changed.
+    void onStatisticsSavePoint(const std::vector<FileData*>& files);
     void writeMetaData();
 
     void setupSystemSortType(FileData* rootFolder);
 
+    // Brings the tree up to date with the files in the specified directories, which is used
+    // when the directories have changed after the system was populated. The entries that no
+    // longer exist are detached from the tree and returned in removedFiles, and it's up to
+    // the caller to delete them once they are no longer referenced.
+    void updateFolders(const std::vector<std::string>& directories,
+                       std::vector<FileData*>& addedGames,
+                       std::vector<FileData*>& removedFiles);
+
 private:
     std::string mName;
     std::string mFullName;
@@ -167,13 +189,29 @@ private:
     bool mFlattenFolders;
 
     bool populateFolder(FileData* folder);
+    bool populateEntry(FileData* folder, const std::string& filePath, const bool showHiddenFiles);
+    // Returns the entry for the path, or if there is no such entry then the closest folder
+    // above it. Returns nullptr if the path is not inside the system directory.
+    FileData* findEntry(const std::string& path) const;
     void indexAllGameFilters(const FileData* folder);
     void setIsGameSystemStatus();
+    // Returns the games that can be randomly selected in gameselector mode, these are only
+    // collected again after the candidates have been invalidated.
+    std::vector<FileData*>& getRandomGameCandidates();
 
     FileFilterIndex* mFilterIndex;
 
     FileData* mRootFolder;
     FileData* mPlaceholder;
+
+    std::vector<FileData*> mRandomGameCandidates;
+    std::vector<FileData*> mRandomKidGameCandidates;
+    bool mRandomGameCandidatesValid;
+
+    // The entries per folder that were left out of the tree on purpose, i.e. folders with a
+    // noload.txt file and entries hidden in the gamelist, so that updateFolders() doesn't
+    // treat them as added every time the folder changes.
+    std::unordered_map<std::string, std::unordered_set<std::string>> mSkippedEntries;
 };
 
 #endif // ES_APP_SYSTEM_DATA_H
@@ -1663,6 +1663,32 @@ void GuiMenu::openOtherOptions()
     });
 #endif
 
+    // Frame rate to use when there is no input and nothing is animating.
+    auto idleFrameRate = std::make_shared<OptionListComponent<std::string>>(
+        getHelpStyle(), _("IDLE FRAME RATE"), false);
+    const std::string& selectedIdleFrameRate {
+        std::to_string(Settings::getInstance()->getInt("IdleFrameRate"))};
+    idleFrameRate->add(_("DISABLED"), "0", selectedIdleFrameRate == "0");
+    idleFrameRate->add("1 FPS", "1", selectedIdleFrameRate == "1");
+    idleFrameRate->add("2 FPS", "2", selectedIdleFrameRate == "2");
+    idleFrameRate->add("5 FPS", "5", selectedIdleFrameRate == "5");
+    idleFrameRate->add("10 FPS", "10", selectedIdleFrameRate == "10");
+    idleFrameRate->add("15 FPS", "15", selectedIdleFrameRate == "15");
+    idleFrameRate->add("30 FPS", "30", selectedIdleFrameRate == "30");
+    // If there are no objects returned, then there must be a manually modified entry in the
+    // configuration file. Simply set the idle frame rate to "10" in this case.
+    if (idleFrameRate->getSelectedObjects().size() == 0)
+        idleFrameRate->selectEntry(4);
+    s->addWithLabel(_("IDLE FRAME RATE"), idleFrameRate);
+    s->addSaveFunc([idleFrameRate, s] {
+        if (idleFrameRate->getSelected() !=
+            std::to_string(Settings::getInstance()->getInt("IdleFrameRate"))) {
+            Settings::getInstance()->setInt("IdleFrameRate",
+                                            atoi(idleFrameRate->getSelected().c_str()));
+            s->setNeedsSaving();
+        }
+    });
+
     // Display/monitor.
     auto displayIndex = std::make_shared<OptionListComponent<std::string>>(
         getHelpStyle(), _("DISPLAY/MONITOR INDEX"), false);
@@ -2045,6 +2071,20 @@ void GuiMenu::openOtherOptions()
         }
     });
 
+    // Frame time profiler overlay.
+    auto displayFrameTimeProfiler = std::make_shared<SwitchComponent>();
+    displayFrameTimeProfiler->setState(
+        Settings::getInstance()->getBool("DisplayFrameTimeProfiler"));
+    s->addWithLabel(_("DISPLAY FRAME TIME PROFILER OVERLAY"), displayFrameTimeProfiler);
+    s->addSaveFunc([displayFrameTimeProfiler, s] {
+        if (displayFrameTimeProfiler->getState() !=
+            Settings::getInstance()->getBool("DisplayFrameTimeProfiler")) {
+            Settings::getInstance()->setBool("DisplayFrameTimeProfiler",
+                                             displayFrameTimeProfiler->getState());
+            s->setNeedsSaving();
+        }
+    });
+
     // Whether to enable the menu in Kid mode.
     auto enableMenuKidMode = std::make_shared<SwitchComponent>();
     enableMenuKidMode->setState(Settings::getInstance()->getBool("EnableMenuKidMode"));
@@ -2181,24 +2221,28 @@ void GuiMenu::openUtilities()
     row.addElement(dummyArrow, false);
 
     row.makeAcceptInputHandler([this] {
+        auto rescanFunc = [this](const bool quickRescan) {
+            if (CollectionSystemsManager::getInstance()->isEditing())
+                CollectionSystemsManager::getInstance()->exitEditMode();
+            mWindow->stopInfoPopup();
+            GuiMenu::close(true);
+            // Write any gamelist.xml changes before proceeding with the rescan.
+            if (Settings::getInstance()->getString("SaveGamelistsMode") == "on exit") {
+                for (auto system : SystemData::sSystemVector)
+                    system->writeMetaData();
+            }
+            if (quickRescan)
+                ViewController::getInstance()->rescanGameDirectories();
+            else
+                ViewController::getInstance()->rescanROMDirectory();
+        };
         mWindow->pushGui(new GuiMsgBox(
             getHelpStyle(),
             _("THIS WILL RESCAN YOUR ROM DIRECTORY FOR CHANGES SUCH AS ADDED OR REMOVED GAMES AND "
-              "SYSTEMS"),
-            _("PROCEED"),
-            [this] {
-                if (CollectionSystemsManager::getInstance()->isEditing())
-                    CollectionSystemsManager::getInstance()->exitEditMode();
-                mWindow->stopInfoPopup();
-                GuiMenu::close(true);
-                // Write any gamelist.xml changes before proceeding with the rescan.
-                if (Settings::getInstance()->getString("SaveGamelistsMode") == "on exit") {
-                    for (auto system : SystemData::sSystemVector)
-                        system->writeMetaData();
-                }
-                ViewController::getInstance()->rescanROMDirectory();
-            },
-            _("CANCEL"), nullptr, "", nullptr, nullptr, false, true,
+              "SYSTEMS. A QUICK RESCAN IS FASTER BUT ONLY LOOKS FOR ADDED OR REMOVED GAMES AND "
+              "MEDIA FILES FOR THE SYSTEMS THAT ARE ALREADY LOADED"),
+            _("PROCEED"), [rescanFunc] { rescanFunc(false); }, _("QUICK RESCAN"),
+            [rescanFunc] { rescanFunc(true); }, _("CANCEL"), nullptr, nullptr, false, true,
             (mRenderer->getIsVerticalOrientation() ?
                  0.76f :
                  0.52f * (1.778f / mRenderer->getScreenAspectRatio()))));
@@ -4,7 +4,7 @@
 //  GuiOfflineGenerator.cpp
 //
 //  User interface for the miximage offline generator.
-//  Calls MiximageGenerator to do the actual work.
+//  Calls MiximageGenerator to do the actual work, using a pool of worker threads.
 //
 
 #include "guis/GuiOfflineGenerator.h"
@@ -24,7 +24,6 @@ GuiOfflineGenerator::GuiOfflineGenerator(const std::queue<FileData*>& gameQueue)
 
     mProcessing = false;
     mPaused = false;
-    mOverwriting = false;
 
     mTotalGames = static_cast<int>(mGameQueue.size());
     mGamesProcessed = 0;
@@ -33,7 +32,15 @@ GuiOfflineGenerator::GuiOfflineGenerator(const std::queue<FileData*>& gameQueue)
     mGamesSkipped = 0;
     mGamesFailed = 0;
 
-    mGame = nullptr;
+    // A setting of zero means that the number of threads is based on the number of CPU cores,
+    // but this is capped as each generator needs quite a lot of memory for its image buffers.
+    int threads {Settings::getInstance()->getInt("MiximageOfflineGeneratorThreads")};
+    if (threads <= 0)
+        threads = std::min(8, static_cast<int>(std::thread::hardware_concurrency()));
+    threads = glm::clamp(threads, 1, std::max(1, static_cast<int>(mTotalGames)));
+
+    for (int i {0}; i < threads; ++i)
+        mWorkers.emplace_back(std::make_unique<GeneratorWorker>());
 
     // Header.
     mTitle = std::make_shared<TextComponent>(
@@ -152,12 +159,13 @@ GuiOfflineGenerator::GuiOfflineGenerator(const std::queue<FileData*>& gameQueue)
                 mCloseButton->setText(_("CLOSE"), _("close (abort processing)"));
                 mStatus->setText(_("RUNNING..."));
                 if (mGamesProcessed == 0) {
-                    LOG(LogInfo) << "GuiOfflineGenerator: Processing " << mTotalGames << " games";
+                    LOG(LogInfo) << "GuiOfflineGenerator: Processing " << mTotalGames
+                                 << " games using " << mWorkers.size()
+                                 << (mWorkers.size() == 1 ? " thread" : " threads");
                 }
             }
             else {
-                if (mMiximageGeneratorThread.joinable())
-                    mMiximageGeneratorThread.join();
+                joinWorkers();
                 mPaused = true;
                 update(1);
                 mProcessing = false;
@@ -210,16 +218,22 @@ GuiOfflineGenerator::GuiOfflineGenerator(const std::queue<FileData*>& gameQueue)
 
 GuiOfflineGenerator::~GuiOfflineGenerator()
 {
-    // Let the miximage generator thread complete.
-    if (mMiximageGeneratorThread.joinable())
-        mMiximageGeneratorThread.join();
-
-    mMiximageGenerator.reset();
+    // Let the miximage generator threads complete.
+    joinWorkers();
+    mWorkers.clear();
 
     if (mImagesGenerated > 0)
         ViewController::getInstance()->reloadAll();
 }
 
+void GuiOfflineGenerator::joinWorkers()
+{
+    for (auto& worker : mWorkers) {
+        if (worker->thread.joinable())
+            worker->thread.join();
+    }
+}
+
 void GuiOfflineGenerator::onSizeChanged()
 {
     mBackground.fitTo(mSize);
@@ -263,65 +277,82 @@ void GuiOfflineGenerator::update(int deltaTime)
     if (!mProcessing)
         return;
 
-    // Check if a miximage generator thread was started, and if the processing has been completed.
-    if (mMiximageGenerator && mGeneratorFuture.valid()) {
-        // Only wait one millisecond as this update() function runs very frequently.
-        if (mGeneratorFuture.wait_for(std::chrono::milliseconds(1)) == std::future_status::ready) {
-            // We always let the miximage generator thread complete.
-            if (mMiximageGeneratorThread.joinable())
-                mMiximageGeneratorThread.join();
-            mMiximageGenerator.reset();
-            if (!mGeneratorFuture.get()) {
-                ++mImagesGenerated;
-                TextureResource::manualUnload(mGame->getMiximagePath(), false);
-                mProcessingVal->setText("");
-                if (mOverwriting) {
-                    ++mImagesOverwritten;
-                    mOverwriting = false;
-                }
-            }
-            else {
-                std::string errorMessage {mResultMessage + " (" + mGameName + ")"};
-                mLastErrorVal->setText(errorMessage);
-                LOG(LogInfo) << "GuiOfflineGenerator: " << errorMessage;
-                ++mGamesFailed;
+    bool workersBusy {false};
+
+    // Check which miximage generator threads have completed their processing.
+    for (auto& worker : mWorkers) {
+        if (!worker->generator || !worker->future.valid())
+            continue;
+        // Don't wait at all as this update() function runs very frequently.
+        if (worker->future.wait_for(std::chrono::milliseconds(0)) != std::future_status::ready) {
+            workersBusy = true;
+            continue;
+        }
+        // We always let the miximage generator thread complete.
+        if (worker->thread.joinable())
+            worker->thread.join();
+        worker->generator.reset();
+        if (!worker->future.get()) {
+            ++mImagesGenerated;
+            TextureResource::manualUnload(worker->game->getMiximagePath(), false);
+            if (worker->overwriting) {
+                ++mImagesOverwritten;
+                worker->overwriting = false;
             }
-            mGame = nullptr;
-            ++mGamesProcessed;
         }
+        else {
+            std::string errorMessage {worker->resultMessage + " (" + worker->gameName + ")"};
+            mLastErrorVal->setText(errorMessage);
+            LOG(LogInfo) << "GuiOfflineGenerator: " << errorMessage;
+            ++mGamesFailed;
+        }
+        worker->game = nullptr;
+        ++mGamesProcessed;
     }
 
     // This is simply to retain the name of the last processed game on-screen while paused.
     if (mPaused)
         mProcessingVal->setText(mGameName);
+    else if (!workersBusy)
+        mProcessingVal->setText("");
+
+    // Hand out the next game in the queue to each idle worker.
+    for (auto& worker : mWorkers) {
+        if (mPaused || mGameQueue.empty())
+            break;
+        if (worker->generator)
+            continue;
 
-    if (!mPaused && !mGameQueue.empty() && !mMiximageGenerator) {
-        mGame = mGameQueue.front();
+        worker->game = mGameQueue.front();
         mGameQueue.pop();
 
-        mGameName =
-            mGame->getName() + " [" + Utils::String::toUpper(mGame->getSystem()->getName()) + "]";
+        worker->gameName = worker->game->getName() + " [" +
+                           Utils::String::toUpper(worker->game->getSystem()->getName()) + "]";
+        mGameName = worker->gameName;
         mProcessingVal->setText(mGameName);
 
         if (!Settings::getInstance()->getBool("MiximageOverwrite") &&
-            mGame->getMiximagePath() != "") {
+            worker->game->getMiximagePath() != "") {
+            worker->game = nullptr;
             ++mGamesProcessed;
             ++mGamesSkipped;
             mSkippedVal->setText(std::to_string(mGamesSkipped));
         }
         else {
-            if (mGame->getMiximagePath() != "")
-                mOverwriting = true;
+            if (worker->game->getMiximagePath() != "")
+                worker->overwriting = true;
 
-            mMiximageGenerator = std::make_unique<MiximageGenerator>(mGame, mResultMessage);
+            worker->resultMessage.clear();
+            worker->generator =
+                std::make_unique<MiximageGenerator>(worker->game, worker->resultMessage);
 
             // The promise/future mechanism is used as signaling for the thread to indicate
             // that processing has been completed.
-            std::promise<bool>().swap(mGeneratorPromise);
-            mGeneratorFuture = mGeneratorPromise.get_future();
+            std::promise<bool>().swap(worker->promise);
+            worker->future = worker->promise.get_future();
 
-            mMiximageGeneratorThread = std::thread(&MiximageGenerator::startThread,
-                                                   mMiximageGenerator.get(), &mGeneratorPromise);
+            worker->thread = std::thread(&MiximageGenerator::startThread, worker->generator.get(),
+                                         &worker->promise);
         }
     }
 
@@ -4,7 +4,7 @@
 //  GuiOfflineGenerator.h
 //
 //  User interface for the miximage offline generator.
-//  Calls MiximageGenerator to do the actual work.
+//  Calls MiximageGenerator to do the actual work, using a pool of worker threads.
 //
 
 #ifndef ES_APP_GUIS_GUI_OFFLINE_GENERATOR_H
@@ -33,19 +33,27 @@ private:
     std::vector<HelpPrompt> getHelpPrompts() override;
     HelpStyle getHelpStyle() override { return ViewController::getInstance()->getViewHelpStyle(); }
 
-    std::queue<FileData*> mGameQueue;
-
-    std::unique_ptr<MiximageGenerator> mMiximageGenerator;
-    std::thread mMiximageGeneratorThread;
-    std::promise<bool> mGeneratorPromise;
-    std::future<bool> mGeneratorFuture;
+    // A single slot in the worker pool, each running at most one miximage generator thread.
+    // MiximageGenerator keeps pointers to the result message and promise, so the slots are
+    // allocated individually to keep their addresses stable.
+    struct GeneratorWorker {
+        FileData* game {nullptr};
+        std::string gameName;
+        std::string resultMessage;
+        bool overwriting {false};
+        std::unique_ptr<MiximageGenerator> generator;
+        std::thread thread;
+        std::promise<bool> promise;
+        std::future<bool> future;
+    };
+
+    void joinWorkers();
 
-    FileData* mGame;
+    std::queue<FileData*> mGameQueue;
+    std::vector<std::unique_ptr<GeneratorWorker>> mWorkers;
 
     bool mProcessing;
     bool mPaused;
-    bool mOverwriting;
-    std::string mResultMessage;
 
     unsigned int mTotalGames;
     unsigned int mGamesProcessed;
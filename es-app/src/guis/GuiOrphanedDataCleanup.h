@@ -10,12 +10,11 @@
 #define ES_APP_GUIS_GUI_ORPHANED_DATA_CLEANUP_H
 
 #include "GuiComponent.h"
+#include "OrphanedDataCleanup.h"
 #include "components/BusyComponent.h"
 #include "guis/GuiSettings.h"
 #include "views/ViewController.h"
 
-#include <atomic>
-#include <mutex>
 #include <thread>
 
 class GuiOrphanedDataCleanup : public GuiComponent
@@ -24,10 +23,6 @@ public:
     GuiOrphanedDataCleanup(std::function<void()> reloadCallback);
     ~GuiOrphanedDataCleanup();
 
-    void cleanupMediaFiles();
-    void cleanupGamelists();
-    void cleanupCollections();
-
     void update(int deltaTime) override;
     void render(const glm::mat4& parentTrans) override;
 
@@ -61,27 +56,13 @@ private:
     std::shared_ptr<TextComponent> mErrorHeader;
     std::shared_ptr<TextComponent> mError;
 
+    OrphanedDataCleanup mCleanup;
     std::unique_ptr<std::thread> mThread;
-    std::mutex mMutex;
     int mCursorPos;
 
     std::string mMediaDescription;
     std::string mGamelistDescription;
     std::string mCollectionsDescription;
-    std::string mCurrentSystem;
-    std::string mErrorMessage;
-
-    std::string mMediaDirectory;
-    std::vector<std::string> mMediaTypes;
-
-    std::atomic<bool> mIsProcessing;
-    std::atomic<bool> mStopProcessing;
-    std::atomic<bool> mCompleted;
-    std::atomic<bool> mFailed;
-    std::atomic<bool> mNeedsReloading;
-    std::atomic<int> mProcessedCount;
-    bool mHasCustomCollections;
-    bool mCaseSensitiveFilesystem;
 
     enum class CleanupType {
         MEDIA,
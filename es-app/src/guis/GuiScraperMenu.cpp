@@ -747,6 +747,28 @@ void GuiScraperMenu::openMiximageOptions()
         }
     });
 
+    // Number of parallel threads used by the offline generator.
+    auto miximageOfflineGeneratorThreads = std::make_shared<OptionListComponent<int>>(
+        getHelpStyle(), _("OFFLINE GENERATOR THREADS"), false);
+    const int selectedThreads {Settings::getInstance()->getInt("MiximageOfflineGeneratorThreads")};
+    miximageOfflineGeneratorThreads->add(_("AUTO"), 0, selectedThreads == 0);
+    for (int threads : {1, 2, 3, 4, 6, 8, 12, 16})
+        miximageOfflineGeneratorThreads->add(std::to_string(threads), threads,
+                                             selectedThreads == threads);
+    // If there are no objects returned, then there must be a manually modified entry in the
+    // configuration file. Simply set the thread count to "auto" in this case.
+    if (miximageOfflineGeneratorThreads->getSelectedObjects().size() == 0)
+        miximageOfflineGeneratorThreads->selectEntry(0);
+    s->addWithLabel(_("OFFLINE GENERATOR THREADS"), miximageOfflineGeneratorThreads);
+    s->addSaveFunc([miximageOfflineGeneratorThreads, s] {
+        if (miximageOfflineGeneratorThreads->getSelected() !=
+            Settings::getInstance()->getInt("MiximageOfflineGeneratorThreads")) {
+            Settings::getInstance()->setInt("MiximageOfflineGeneratorThreads",
+                                            miximageOfflineGeneratorThreads->getSelected());
+            s->setNeedsSaving();
+        }
+    });
+
     // Miximage offline generator.
     ComponentListRow offlineGeneratorRow;
     offlineGeneratorRow.elements.clear();
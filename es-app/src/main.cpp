@@ -16,15 +16,17 @@
 #include "ApplicationVersion.h"
 #include "AudioManager.h"
 #include "CollectionSystemsManager.h"
+#include "HeadlessMode.h"
 #include "InputManager.h"
 #include "Log.h"
-#include "MameNames.h"
 #include "MediaViewer.h"
 #include "PDFViewer.h"
+#include "Profiler.h"
 #include "Screensaver.h"
 #include "Scripting.h"
 #include "Settings.h"
 #include "Sound.h"
+#include "StartupTimer.h"
 #include "SystemData.h"
 #include "guis/GuiDetectDevice.h"
 #include "guis/GuiLaunchScreen.h"
@@ -75,6 +77,10 @@ namespace
     bool createSystemDirectories {false};
     bool settingsNeedSaving {false};
     bool portableMode {false};
+    std::vector<HeadlessMode::Task> headlessTasks;
+    unsigned int startupBenchmarkEntries {0};
+    // Measures the time from preloading the views until the first frame has been rendered.
+    std::unique_ptr<StartupTimer::Phase> firstFramePhase;
 
     enum loadSystemsReturnCode {
         LOADING_OK,
@@ -385,6 +391,45 @@ bool parseArguments(const std::vector<std::string>& arguments)
         else if (arguments[i] == "--create-system-dirs") {
             createSystemDirectories = true;
         }
+        else if (arguments[i] == "--generate-miximages") {
+            headlessTasks.emplace_back(HeadlessMode::Task::GENERATE_MIXIMAGES);
+        }
+        else if (arguments[i] == "--cleanup-orphans") {
+            if (i >= arguments.size() - 1) {
+                std::cerr << "Error: No cleanup-orphans value supplied\n";
+                return false;
+            }
+            const std::string cleanupValue {arguments[i + 1]};
+            if (cleanupValue == "media") {
+                headlessTasks.emplace_back(HeadlessMode::Task::CLEANUP_MEDIA);
+            }
+            else if (cleanupValue == "gamelists") {
+                headlessTasks.emplace_back(HeadlessMode::Task::CLEANUP_GAMELISTS);
+            }
+            else if (cleanupValue == "collections") {
+                headlessTasks.emplace_back(HeadlessMode::Task::CLEANUP_COLLECTIONS);
+            }
+            else {
+                std::cerr << "Error: Invalid cleanup-orphans value supplied\n";
+                return false;
+            }
+            ++i;
+        }
+        else if (arguments[i] == "--warm-caches") {
+            headlessTasks.emplace_back(HeadlessMode::Task::WARM_CACHES);
+        }
+        else if (arguments[i] == "--startup-report") {
+            Settings::getInstance()->setBool("StartupReport", true);
+        }
+        else if (arguments[i] == "--startup-benchmark") {
+            if (i >= arguments.size() - 1 || stoi(arguments[i + 1]) < 1 ||
+                stoi(arguments[i + 1]) > 1000000) {
+                std::cerr << "Error: Invalid startup-benchmark entry count supplied\n";
+                return false;
+            }
+            startupBenchmarkEntries = static_cast<unsigned int>(stoi(arguments[i + 1]));
+            ++i;
+        }
         else if (arguments[i] == "--debug") {
             Settings::getInstance()->setBool("Debug", true);
             Settings::getInstance()->setBool("DebugFlag", true);
@@ -424,6 +469,11 @@ bool parseArguments(const std::vector<std::string>& arguments)
 "  --force-kid                           Force the UI mode to Kid\n"
 "  --force-input-config                  Force configuration of input devices\n"
 "  --create-system-dirs                  Create game system directories\n"
+"  --generate-miximages                  Generate miximages for all games, then exit\n"
+"  --cleanup-orphans [type]              Clean up orphaned media, gamelists or collections\n"
+"  --warm-caches                         Read all game media into the file caches, then exit\n"
+"  --startup-report                      Write the startup phase timings to a JSON file\n"
+"  --startup-benchmark [entries]         Time loading a generated system, then exit\n"
 "  --home [path]                         Directory to use as home path\n"
 "  --debug                               Enable debug mode\n"
 "  --version, -v                         Display version information\n"
@@ -477,6 +527,8 @@ bool checkApplicationDataDirectory()
 
 loadSystemsReturnCode loadSystemConfigFile()
 {
+    StartupTimer::Phase phase {"systems"};
+
     if (SystemData::loadConfig())
         return INVALID_FILE;
 
@@ -500,7 +552,10 @@ void applicationLoop()
 #if !defined(__EMSCRIPTEN__)
     while (true) {
 #endif
+        Profiler::beginFrame();
+
         if (SDL_PollEvent(&event)) {
+            PROFILE_SCOPE("Input");
             do {
 #if defined(__ANDROID__)
                 if (event.type == SDL_WINDOWEVENT &&
@@ -552,12 +607,34 @@ void applicationLoop()
             }
         }
 #endif
-        window->update(deltaTime);
-        window->render();
+        {
+            PROFILE_SCOPE("Update");
+            window->update(deltaTime);
+        }
 
-        renderer->swapBuffers();
-        Log::flush();
+        // If nothing has changed on screen then skip rendering and wait for new events instead,
+        // which drastically reduces the CPU and GPU usage when idling.
+        int waitTime {0};
+        if (window->shouldRenderFrame(waitTime)) {
+            {
+                PROFILE_SCOPE("Render");
+                window->render();
+            }
+            {
+                PROFILE_SCOPE("Swap");
+                renderer->swapBuffers();
+            }
+            Profiler::endFrame();
+
+            if (firstFramePhase != nullptr) {
+                firstFramePhase.reset();
+                StartupTimer::report();
+            }
+        }
 #if !defined(__EMSCRIPTEN__)
+        else {
+            SDL_WaitEventTimeout(nullptr, waitTime);
+        }
     }
 #endif
 }
@@ -742,7 +819,8 @@ int main(int argc, char* argv[])
         return 0;
     }
 
-    Scripting::fireEvent("startup");
+    if (headlessTasks.empty() && startupBenchmarkEntries == 0)
+        Scripting::fireEvent("startup");
 
 #if defined(__EMSCRIPTEN__)
     // TODO: Remove when application window resizing has been implemented.
@@ -1049,6 +1127,22 @@ int main(int argc, char* argv[])
 
     Utils::Localization::setLocale();
 
+    if (!headlessTasks.empty() || startupBenchmarkEntries != 0) {
+        // The command line batch modes run without a window and renderer and exit when done.
+        const int returnValue {startupBenchmarkEntries != 0 ?
+                                   HeadlessMode::runStartupBenchmark(startupBenchmarkEntries) :
+                                   HeadlessMode::run(headlessTasks)};
+#if defined(FREEIMAGE_LIB)
+        // Call this ONLY when linking with FreeImage as a static library.
+        FreeImage_DeInitialise();
+#endif
+        LOG(LogInfo) << "ES-DE cleanly shutting down";
+#if defined(_WIN64)
+        FreeConsole();
+#endif
+        return returnValue;
+    }
+
     renderer = Renderer::getInstance();
     window = Window::getInstance();
 
@@ -1059,9 +1153,12 @@ int main(int argc, char* argv[])
     PDFViewer pdfViewer;
     GuiLaunchScreen guiLaunchScreen;
 
-    if (!window->init()) {
-        LOG(LogError) << "Window failed to initialize";
-        return 1;
+    {
+        StartupTimer::Phase phase {"window"};
+        if (!window->init()) {
+            LOG(LogError) << "Window failed to initialize";
+            return 1;
+        }
     }
 
 #if defined(__ANDROID__)
@@ -1155,8 +1252,10 @@ int main(int argc, char* argv[])
     }
 #endif
 
-    MameNames::getInstance();
-    ThemeData::populateThemes();
+    {
+        StartupTimer::Phase phase {"themes"};
+        ThemeData::populateThemes();
+    }
     loadSystemsReturnCode loadSystemsStatus {loadSystemConfigFile()};
 
     if (!SystemData::sStartupExitSignal) {
@@ -1177,7 +1276,11 @@ int main(int argc, char* argv[])
         SDL_GameControllerEventState(SDL_DISABLE);
 
         // Preload system view and all gamelist views.
-        ViewController::getInstance()->preload();
+        {
+            StartupTimer::Phase phase {"preload"};
+            ViewController::getInstance()->preload();
+        }
+        firstFramePhase = std::make_unique<StartupTimer::Phase>("first frame");
     }
 
     if (!SystemData::sStartupExitSignal) {
@@ -13,6 +13,7 @@
 #include "FileData.h"
 #include "GamesDBJSONScraper.h"
 #include "Log.h"
+#include "MediaManifest.h"
 #include "ScreenScraper.h"
 #include "Settings.h"
 #include "SystemData.h"
@@ -350,6 +351,7 @@ MDResolveHandle::MDResolveHandle(const ScraperSearchResult& result,
             const std::string& content {mResult.thumbnailImageData};
             stream.write(content.data(), content.length());
             stream.close();
+            MediaManifest::getInstance().invalidate(filePath);
             if (stream.bad()) {
                 setError(_("Couldn't save media file, permission problems or is the disk full?"),
                          false);
@@ -554,6 +556,7 @@ void MediaDownloadHandle::update()
     const std::string& content {mReq->getContent()};
     stream.write(content.data(), content.length());
     stream.close();
+    MediaManifest::getInstance().invalidate(mSavePath);
     if (stream.bad()) {
         setError(_("Couldn't save media file, permission problems or is the disk full?"), false);
         return;
@@ -15,6 +15,7 @@
 
 #include "CollectionSystemsManager.h"
 #include "FileFilterIndex.h"
+#include "MediaManifest.h"
 #include "UIModeController.h"
 #include "guis/GuiGamelistOptions.h"
 #include "utils/LocalizationUtil.h"
@@ -650,12 +651,15 @@ void GamelistBase::removeMedia(FileData* game)
 
     // If there are no media files left in the directory after the deletion, then remove
     // the directory too. Remove any empty parent directories as well.
+    // The media manifest is also updated so that any remaining files can be found.
     auto removeEmptyDirFunc = [](std::string systemMediaDir, std::string mediaType,
                                  std::string path) {
+        MediaManifest::getInstance().invalidate(path);
         std::string parentPath {Utils::FileSystem::getParent(path)};
         while (parentPath != systemMediaDir + "/" + mediaType) {
             if (Utils::FileSystem::getDirContent(parentPath).size() == 0) {
                 Utils::FileSystem::removeDirectory(parentPath, false);
+                MediaManifest::getInstance().invalidate(parentPath);
                 parentPath = Utils::FileSystem::getParent(parentPath);
             }
             else {
@@ -762,8 +766,6 @@ void GamelistBase::populateList(const std::vector<FileData*>& files, FileData* f
     bool isCollection {false};
     bool isCustomCollection {false};
     std::string editingCollection;
-    std::string inCollectionPrefix;
-    LetterCase letterCase {LetterCase::NONE};
 
     if (CollectionSystemsManager::getInstance()->isEditing()) {
         editingCollection = CollectionSystemsManager::getInstance()->getEditingCollection();
@@ -784,27 +786,7 @@ void GamelistBase::populateList(const std::vector<FileData*>& files, FileData* f
     if (mPrimary != nullptr)
         mPrimary->clear();
 
-    auto nameSuffixFunc = [this](std::vector<FileData*>::const_iterator it, std::string& name) {
-        if ((*it)->getType() == GAME) {
-            const LetterCase letterCase {mPrimary->getLetterCaseSystemNameSuffix()};
-            name.append(" [");
-            if (letterCase == LetterCase::UPPERCASE) {
-                name.append(
-                    Utils::String::toUpper((*it)->getSourceFileData()->getSystem()->getName()));
-            }
-            else if (letterCase == LetterCase::CAPITALIZE) {
-                name.append(Utils::String::toCapitalized(
-                    (*it)->getSourceFileData()->getSystem()->getName()));
-            }
-            else {
-                name.append((*it)->getSourceFileData()->getSystem()->getName());
-            }
-            name.append("]");
-        }
-    };
-
     auto theme = mRoot->getSystem()->getTheme();
-    std::string name;
     std::string defaultImage;
     std::string defaultFolderImage;
 
@@ -822,34 +804,98 @@ void GamelistBase::populateList(const std::vector<FileData*>& files, FileData* f
     }
 
     if (files.size() > 0) {
-        for (auto it = files.cbegin(); it != files.cend(); ++it) {
+        // The entry names are only generated once the entries are actually displayed as this
+        // is quite slow for large gamelists, so everything the names depend on is captured here.
+        const bool textList {mTextList != nullptr};
+        const std::string indicators {textList ? mTextList->getIndicators() : ""};
+        const std::string collectionIndicators {textList ? mTextList->getCollectionIndicators() :
+                                                           ""};
+        const std::string rootSystemName {mRoot->getSystem()->getName()};
+        const bool systemNameSuffix {isCollection && mSystemNameSuffix};
+        const LetterCase letterCase {mPrimary->getLetterCase()};
+        const LetterCase letterCaseSystemNameSuffix {mPrimary->getLetterCaseSystemNameSuffix()};
+        LetterCase letterCaseCustomCollections {letterCase};
 
-            if (!mFirstGameEntry && (*it)->getType() == GAME)
-                mFirstGameEntry = (*it);
+        if (isCustomCollection &&
+            mPrimary->getLetterCaseCustomCollections() != LetterCase::UNDEFINED)
+            letterCaseCustomCollections = mPrimary->getLetterCaseCustomCollections();
+
+        mPrimary->setEntryNameFunction([=](FileData* const& file) {
+            std::string name;
 
-            if (isCustomCollection && (*it)->getType() == FOLDER) {
-                letterCase = mPrimary->getLetterCaseCustomCollections();
-                if (letterCase == LetterCase::UNDEFINED)
-                    letterCase = mPrimary->getLetterCase();
+            if (!textList || indicators == "none") {
+                name = file->getName();
+            }
+            else if (file->getFavorite() && favoriteStar && rootSystemName != "favorites") {
+                if (indicators == "ascii")
+                    name = "* " + file->getName();
+                else
+                    name = ViewController::FAVORITE_CHAR + "  " + file->getName();
+            }
+            else if (file->getType() == FOLDER && rootSystemName != "collections") {
+                if (indicators == "ascii") {
+                    if (file->metadata.get("folderlink") != "")
+                        name = "> " + file->getName();
+                    else
+                        name = "# " + file->getName();
+                }
+                else {
+                    if (file->metadata.get("folderlink") != "")
+                        name = ViewController::FOLDERLINK_CHAR + "  " + file->getName();
+                    else
+                        name = ViewController::FOLDER_CHAR + "  " + file->getName();
+                }
             }
             else {
-                letterCase = mPrimary->getLetterCase();
+                name = file->getName();
             }
 
+            // Add a leading tick mark icon to the game name if it's part of the custom
+            // collection currently being edited.
+            if (textList && isEditing && file->getType() == GAME &&
+                CollectionSystemsManager::getInstance()->inCustomCollection(editingCollection,
+                                                                            file)) {
+                if (collectionIndicators == "ascii")
+                    name = "! " + name;
+                else
+                    name = ViewController::TICKMARK_CHAR + "  " + name;
+            }
+
+            const LetterCase entryLetterCase {
+                isCustomCollection && file->getType() == FOLDER ? letterCaseCustomCollections :
+                                                                  letterCase};
+
+            if (entryLetterCase == LetterCase::UPPERCASE)
+                name = Utils::String::toUpper(name);
+            else if (entryLetterCase == LetterCase::LOWERCASE)
+                name = Utils::String::toLower(name);
+            else if (entryLetterCase == LetterCase::CAPITALIZE)
+                name = Utils::String::toCapitalized(name);
+
+            if (systemNameSuffix && file->getType() == GAME) {
+                const std::string& systemName {file->getSourceFileData()->getSystem()->getName()};
+                name.append(" [");
+                if (letterCaseSystemNameSuffix == LetterCase::UPPERCASE)
+                    name.append(Utils::String::toUpper(systemName));
+                else if (letterCaseSystemNameSuffix == LetterCase::CAPITALIZE)
+                    name.append(Utils::String::toCapitalized(systemName));
+                else
+                    name.append(systemName);
+                name.append("]");
+            }
+
+            return name;
+        });
+
+        for (auto it = files.cbegin(); it != files.cend(); ++it) {
+
+            if (!mFirstGameEntry && (*it)->getType() == GAME)
+                mFirstGameEntry = (*it);
+
             if (mCarousel != nullptr) {
                 CarouselComponent<FileData*>::Entry carouselEntry;
-                carouselEntry.name = (*it)->getName();
                 carouselEntry.object = *it;
-
-                if (letterCase == LetterCase::UPPERCASE)
-                    carouselEntry.name = Utils::String::toUpper(carouselEntry.name);
-                else if (letterCase == LetterCase::LOWERCASE)
-                    carouselEntry.name = Utils::String::toLower(carouselEntry.name);
-                else if (letterCase == LetterCase::CAPITALIZE)
-                    carouselEntry.name = Utils::String::toCapitalized(carouselEntry.name);
-
-                if (isCollection && mSystemNameSuffix)
-                    nameSuffixFunc(it, carouselEntry.name);
+                carouselEntry.deferredName = true;
 
                 if ((*it)->getType() == FOLDER) {
                     if (defaultFolderImage != "")
@@ -865,18 +911,8 @@ void GamelistBase::populateList(const std::vector<FileData*>& files, FileData* f
             }
             else if (mGrid != nullptr) {
                 GridComponent<FileData*>::Entry gridEntry;
-                gridEntry.name = (*it)->getName();
                 gridEntry.object = *it;
-
-                if (letterCase == LetterCase::UPPERCASE)
-                    gridEntry.name = Utils::String::toUpper(gridEntry.name);
-                else if (letterCase == LetterCase::LOWERCASE)
-                    gridEntry.name = Utils::String::toLower(gridEntry.name);
-                else if (letterCase == LetterCase::CAPITALIZE)
-                    gridEntry.name = Utils::String::toCapitalized(gridEntry.name);
-
-                if (isCollection && mSystemNameSuffix)
-                    nameSuffixFunc(it, gridEntry.name);
+                gridEntry.deferredName = true;
 
                 if ((*it)->getType() == FOLDER) {
                     if (defaultFolderImage != "")
@@ -892,68 +928,8 @@ void GamelistBase::populateList(const std::vector<FileData*>& files, FileData* f
             }
             else if (mTextList != nullptr) {
                 TextListComponent<FileData*>::Entry textListEntry;
-                std::string indicators {mTextList->getIndicators()};
-                std::string collectionIndicators {mTextList->getCollectionIndicators()};
-
-                // Add a leading tick mark icon to the game name if it's part of the custom
-                // collection currently being edited.
-                if (isEditing && (*it)->getType() == GAME) {
-                    if (CollectionSystemsManager::getInstance()->inCustomCollection(
-                            editingCollection, (*it))) {
-                        if (collectionIndicators == "ascii")
-                            inCollectionPrefix = "! ";
-                        else
-                            inCollectionPrefix = ViewController::TICKMARK_CHAR + "  ";
-                    }
-                    else {
-                        inCollectionPrefix = "";
-                    }
-                }
-
-                if (indicators == "none") {
-                    name = inCollectionPrefix + (*it)->getName();
-                }
-                else {
-                    if ((*it)->getFavorite() && favoriteStar &&
-                        mRoot->getSystem()->getName() != "favorites") {
-                        if (indicators == "ascii")
-                            name = inCollectionPrefix + "* " + (*it)->getName();
-                        else
-                            name = inCollectionPrefix + ViewController::FAVORITE_CHAR + "  " +
-                                   (*it)->getName();
-                    }
-                    else if ((*it)->getType() == FOLDER &&
-                             mRoot->getSystem()->getName() != "collections") {
-                        if (indicators == "ascii") {
-                            if ((*it)->metadata.get("folderlink") != "")
-                                name = "> " + (*it)->getName();
-                            else
-                                name = "# " + (*it)->getName();
-                        }
-                        else {
-                            if ((*it)->metadata.get("folderlink") != "")
-                                name = ViewController::FOLDERLINK_CHAR + "  " + (*it)->getName();
-                            else
-                                name = ViewController::FOLDER_CHAR + "  " + (*it)->getName();
-                        }
-                    }
-                    else {
-                        name = inCollectionPrefix + (*it)->getName();
-                    }
-                }
-
-                if (letterCase == LetterCase::UPPERCASE)
-                    name = Utils::String::toUpper(name);
-                else if (letterCase == LetterCase::LOWERCASE)
-                    name = Utils::String::toLower(name);
-                else if (letterCase == LetterCase::CAPITALIZE)
-                    name = Utils::String::toCapitalized(name);
-
-                if (isCollection && mSystemNameSuffix)
-                    nameSuffixFunc(it, name);
-
-                textListEntry.name = name;
                 textListEntry.object = *it;
+                textListEntry.deferredName = true;
                 if ((*it)->getType() == FOLDER)
                     textListEntry.data.entryType = TextListEntryType::SECONDARY;
                 else
@@ -9,6 +9,8 @@
 #include "views/GamelistView.h"
 
 #include "CollectionSystemsManager.h"
+#include "Profiler.h"
+#include "Scripting.h"
 #include "UIModeController.h"
 #include "animations/LambdaAnimation.h"
 #include "utils/LocalizationUtil.h"
@@ -19,6 +21,7 @@
 GamelistView::GamelistView(FileData* root)
     : GamelistBase {root}
     , mRenderer {Renderer::getInstance()}
+    , mLastSelectedGame {nullptr}
     , mStaticVideoAudio {false}
 {
 }
@@ -94,10 +97,13 @@ void GamelistView::onShow()
     updateView(CursorState::CURSOR_STOPPED);
     mPrimary->finishAnimation(0);
     mPrimary->onShowPrimary();
+    fireGameSelectEvent();
 }
 
 void GamelistView::onHide()
 {
+    mLastSelectedGame = nullptr;
+
     for (auto& video : mVideoComponents)
         video->stopVideoPlayer(false);
 
@@ -159,7 +165,7 @@ void GamelistView::onThemeChanged(const std::shared_ptr<ThemeData>& theme)
                     mPrimary = mTextList.get();
                 }
                 mPrimary->setCursorChangedCallback(
-                    [&](const CursorState& state) { updateView(state); });
+                    [&](const CursorState& state) { onCursorChanged(state); });
                 mPrimary->setDefaultZIndex(50.0f);
                 mPrimary->setZIndex(50.0f);
                 mPrimary->applyTheme(theme, "gamelist", element.first, ALL);
@@ -176,7 +182,7 @@ void GamelistView::onThemeChanged(const std::shared_ptr<ThemeData>& theme)
                     mPrimary = mCarousel.get();
                 }
                 mPrimary->setCursorChangedCallback(
-                    [&](const CursorState& state) { updateView(state); });
+                    [&](const CursorState& state) { onCursorChanged(state); });
                 mPrimary->setDefaultZIndex(50.0f);
                 mPrimary->applyTheme(theme, "gamelist", element.first, ALL);
                 addChild(mPrimary);
@@ -192,7 +198,7 @@ void GamelistView::onThemeChanged(const std::shared_ptr<ThemeData>& theme)
                     mPrimary = mGrid.get();
                 }
                 mPrimary->setCursorChangedCallback(
-                    [&](const CursorState& state) { updateView(state); });
+                    [&](const CursorState& state) { onCursorChanged(state); });
                 mPrimary->setDefaultZIndex(50.0f);
                 mPrimary->applyTheme(theme, "gamelist", element.first, ALL);
                 addChild(mPrimary);
@@ -357,7 +363,8 @@ void GamelistView::onThemeChanged(const std::shared_ptr<ThemeData>& theme)
     if (mPrimary == nullptr) {
         mTextList = std::make_unique<TextListComponent<FileData*>>();
         mPrimary = mTextList.get();
-        mPrimary->setCursorChangedCallback([&](const CursorState& state) { updateView(state); });
+        mPrimary->setCursorChangedCallback(
+            [&](const CursorState& state) { onCursorChanged(state); });
         mPrimary->setDefaultZIndex(50.0f);
         mPrimary->setZIndex(50.0f);
         mPrimary->applyTheme(theme, "gamelist", "", ALL);
@@ -466,6 +473,7 @@ void GamelistView::render(const glm::mat4& parentTrans)
         stationaryApplicable = true;
 
     for (unsigned int i {0}; i < getChildCount(); ++i) {
+        PROFILE_COMPONENT_SCOPE(getChild(i));
         bool childStationary {false};
         if (stationaryApplicable) {
             if (getChild(i)->getStationary() == Stationary::NEVER) {
@@ -569,6 +577,40 @@ std::vector<HelpPrompt> GamelistView::getHelpPrompts()
     return prompts;
 }
 
+void GamelistView::onCursorChanged(const CursorState& state)
+{
+    updateView(state);
+
+    if (state == CursorState::CURSOR_STOPPED)
+        fireGameSelectEvent();
+}
+
+void GamelistView::fireGameSelectEvent()
+{
+    if (mLastUpdated == nullptr || mLastUpdated == mLastSelectedGame)
+        return;
+
+    // Make sure the event is fired again if returning to the same game from a folder.
+    if (mLastUpdated->getType() != GAME) {
+        mLastSelectedGame = nullptr;
+        return;
+    }
+
+    // The views for the other systems are also populated in the background, so the event is
+    // only fired for the gamelist that is actually shown. As the cursor may already have been
+    // positioned at that point, the event is also fired when the view is shown.
+    const ViewController::State& viewState {ViewController::getInstance()->getState()};
+    if (viewState.viewing != ViewController::ViewMode::GAMELIST ||
+        viewState.getSystem() != mRoot->getSystem())
+        return;
+
+    mLastSelectedGame = mLastUpdated;
+    FileData* sourceFile {mLastUpdated->getSourceFileData()};
+    Scripting::fireEvent("game-select", Utils::FileSystem::getEscapedPath(mLastUpdated->getPath()),
+                         sourceFile->metadata.get("name"), sourceFile->getSystem()->getName(),
+                         sourceFile->getSystem()->getFullName());
+}
+
 void GamelistView::updateView(const CursorState& state)
 {
     bool loadedTexture {false};
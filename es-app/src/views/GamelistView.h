@@ -108,11 +108,15 @@ public:
     std::vector<HelpPrompt> getHelpPrompts() override;
 
 private:
+    void onCursorChanged(const CursorState& state);
+    void fireGameSelectEvent();
     void updateView(const CursorState& state);
     void setGameImage(FileData* file, GuiComponent* comp);
 
     Renderer* mRenderer;
     HelpStyle mHelpStyle;
+    // The game that the game-select event was last fired for, only used for comparison.
+    const FileData* mLastSelectedGame;
     bool mStaticVideoAudio;
 
     std::shared_ptr<ThemeData> mTheme;
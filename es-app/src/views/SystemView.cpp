@@ -9,6 +9,8 @@
 #include "views/SystemView.h"
 
 #include "Log.h"
+#include "Profiler.h"
+#include "Scripting.h"
 #include "Settings.h"
 #include "Sound.h"
 #include "UIModeController.h"
@@ -27,6 +29,7 @@ SystemView::SystemView()
     , mPrimary {nullptr}
     , mPrimaryType {PrimaryType::CAROUSEL}
     , mLastCursor {-1}
+    , mLastSelectedSystem {nullptr}
     , mCamOffset {0.0f}
     , mFadeOpacity {0.0f}
     , mPreviousScrollVelocity {0}
@@ -175,6 +178,23 @@ void SystemView::update(int deltaTime)
     GuiComponent::update(deltaTime);
 }
 
+bool SystemView::isAnimating()
+{
+    if (mPrimary == nullptr || mPrimary->getCursor() + 1 > static_cast<int>(mSystemElements.size()))
+        return GuiComponent::isAnimating();
+
+    if (GuiComponent::isAnimating() || mPrimary->isAnimating())
+        return true;
+
+    // Only the elements for the selected system are updated, see update().
+    for (auto child : mSystemElements[mPrimary->getCursor()].children) {
+        if (child->isVisible() && child->isAnimating())
+            return true;
+    }
+
+    return false;
+}
+
 void SystemView::render(const glm::mat4& parentTrans)
 {
     if (mPrimary == nullptr)
@@ -195,7 +215,10 @@ void SystemView::render(const glm::mat4& parentTrans)
                     static_cast<int>(std::round(trans[3].y))},
         glm::ivec2 {static_cast<int>(std::round(mSize.x)), static_cast<int>(std::round(mSize.y))});
 
-    mPrimary->render(trans);
+    {
+        PROFILE_COMPONENT_SCOPE(mPrimary);
+        mPrimary->render(trans);
+    }
     mRenderer->popClipRect();
 
     if (!mPrimary->getFadeAbovePrimary() || !transitionFade)
@@ -209,6 +232,21 @@ void SystemView::onThemeChanged(const std::shared_ptr<ThemeData>& /*theme*/)
     populate();
 }
 
+void SystemView::refreshGameSelectors(const std::vector<SystemData*>& systems)
+{
+    // Only a single game selector per system gets notified when the lists of last played
+    // and most played games are updated, so all of them are flagged here.
+    for (auto& elements : mSystemElements) {
+        if (std::find(systems.cbegin(), systems.cend(), elements.system) == systems.cend())
+            continue;
+        for (auto& selector : elements.gameSelectors)
+            selector->setNeedsRefresh();
+    }
+
+    if (mPrimary != nullptr && !mSystemElements.empty())
+        updateGameSelectors();
+}
+
 std::vector<HelpPrompt> SystemView::getHelpPrompts()
 {
     std::vector<HelpPrompt> prompts;
@@ -334,6 +372,13 @@ void SystemView::onCursorChanged(const CursorState& state)
     const int prevLastCursor {mLastCursor};
     mLastCursor = cursor;
 
+    // The event is not fired for every system passed while scrolling.
+    if (state == CursorState::CURSOR_STOPPED && mPrimary->getSelected() != mLastSelectedSystem) {
+        mLastSelectedSystem = mPrimary->getSelected();
+        Scripting::fireEvent("system-select", mLastSelectedSystem->getName(),
+                             mLastSelectedSystem->getFullName());
+    }
+
     for (auto& video : mSystemElements[cursor].videoComponents)
         video->setStaticVideo();
 
@@ -1577,6 +1622,7 @@ void SystemView::renderElements(const glm::mat4& parentTrans, bool abovePrimary)
 
             if (mSystemElements.size() > static_cast<size_t>(index)) {
                 for (GuiComponent* child : mSystemElements[index].children) {
+                    PROFILE_COMPONENT_SCOPE(child);
                     bool renderChild {true};
                     bool childStationary {false};
                     if (stationaryApplicable) {
@@ -45,6 +45,7 @@ public:
     bool input(InputConfig* config, Input input) override;
     void update(int deltaTime) override;
     void render(const glm::mat4& parentTrans) override;
+    bool isAnimating() override;
 
     bool isScrolling() { return mPrimary->isScrolling(); }
     void stopScrolling()
@@ -102,6 +103,9 @@ public:
     }
 
     void onThemeChanged(const std::shared_ptr<ThemeData>& theme);
+    // Makes the game selectors of the systems pick their games again, which is required
+    // before any games that they could reference are deleted.
+    void refreshGameSelectors(const std::vector<SystemData*>& systems);
 
     std::vector<HelpPrompt> getHelpPrompts() override;
     HelpStyle getHelpStyle() override { return mSystemElements[mPrimary->getCursor()].helpStyle; }
@@ -143,6 +147,8 @@ private:
     PrimaryComponent<SystemData*>* mPrimary;
     PrimaryType mPrimaryType;
     int mLastCursor;
+    // The system for which the last system-select event was fired.
+    SystemData* mLastSelectedSystem;
 
     // Dummy entry to keep the default SVG rating images in the texture cache so they don't
     // need to be re-rasterized for each gamelist that is loaded.
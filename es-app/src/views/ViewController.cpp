@@ -16,11 +16,15 @@
 #include "AudioManager.h"
 #include "CollectionSystemsManager.h"
 #include "FileFilterIndex.h"
+#include "GameDirectoryUpdater.h"
+#include "GameDirectoryWatcher.h"
 #include "InputManager.h"
 #include "Log.h"
+#include "MediaManifest.h"
 #include "Scripting.h"
 #include "Settings.h"
 #include "Sound.h"
+#include "StartupTimer.h"
 #include "SystemData.h"
 #include "SystemView.h"
 #include "UIModeController.h"
@@ -56,6 +60,7 @@ ViewController::ViewController() noexcept
     , mNextSystem {false}
     , mWindowChangedWidth {0}
     , mWindowChangedHeight {0}
+    , mDeferredGamelistViewsDelay {0}
 {
     mState.viewing = ViewMode::NOTHING;
     mState.previouslyViewed = ViewMode::NOTHING;
@@ -1088,6 +1093,14 @@ std::shared_ptr<GamelistView> ViewController::getGamelistView(SystemData* system
     if (exists != mGamelistViews.cend())
         return exists->second;
 
+    // If the view creation was deferred by preload() then it's created on demand instead.
+    auto deferred =
+        std::find(mDeferredGamelistViews.cbegin(), mDeferredGamelistViews.cend(), system);
+    if (deferred != mDeferredGamelistViews.cend()) {
+        mDeferredGamelistViews.erase(deferred);
+        system->getIndex()->resetFilters();
+    }
+
     system->getIndex()->setKidModeFilters();
     // If there's no entry, then create it and return it.
     std::shared_ptr<GamelistView> view;
@@ -1299,12 +1312,57 @@ void ViewController::update(int deltaTime)
 
     updateSelf(deltaTime);
 
+    if (!mDeferredGamelistViews.empty())
+        createDeferredGamelistView();
+
+    if (mDirectoryWatcher)
+        mDirectoryWatcher->update(deltaTime);
+
     if (mGameToLaunch) {
         launch(mGameToLaunch);
         mGameToLaunch = nullptr;
     }
 }
 
+bool ViewController::isAnimating()
+{
+    if (isAnyAnimationPlaying() || isCameraMoving() || mGameToLaunch != nullptr)
+        return true;
+
+    // All views are children of the ViewController but only the current view can be animating
+    // once any transition has finished.
+    return mCurrentView != nullptr && mCurrentView->isAnimating();
+}
+
+void ViewController::createDeferredGamelistView()
+{
+    if (mDeferredGamelistViewsDelay > 0) {
+        --mDeferredGamelistViewsDelay;
+        return;
+    }
+
+    // Don't cause any stutter during view transitions or when a game is about to be launched.
+    if (isAnyAnimationPlaying() || isCameraMoving() || mGameToLaunch != nullptr)
+        return;
+
+    while (!mDeferredGamelistViews.empty()) {
+        SystemData* system {mDeferredGamelistViews.front()};
+        mDeferredGamelistViews.erase(mDeferredGamelistViews.begin());
+
+        // The system could have been removed since preload(), for example a custom collection.
+        if (std::find(SystemData::sSystemVector.cbegin(), SystemData::sSystemVector.cend(),
+                      system) == SystemData::sSystemVector.cend())
+            continue;
+
+        LOG(LogDebug) << "ViewController::createDeferredGamelistView(): Populating gamelist for "
+                      << (system->isCustomCollection() ? "custom collection" : "system") << " \""
+                      << system->getName() << "\"";
+        system->getIndex()->resetFilters();
+        getGamelistView(system)->preloadGamelist();
+        break;
+    }
+}
+
 void ViewController::render(const glm::mat4& parentTrans)
 {
     glm::mat4 trans {mCamera * parentTrans};
@@ -1360,19 +1418,55 @@ void ViewController::render(const glm::mat4& parentTrans)
 
 void ViewController::preload()
 {
-    const unsigned int systemCount {static_cast<unsigned int>(SystemData::sSystemVector.size())};
     // This reduces the amount of texture pop-in when loading theme extras.
-    if (!SystemData::sSystemVector.empty())
+    if (!SystemData::sSystemVector.empty()) {
+        StartupTimer::Phase phase {"system view"};
         getSystemListView();
+    }
+
+    std::vector<SystemData*> preloadSystems {SystemData::sSystemVector};
+    mDeferredGamelistViews.clear();
+
+    if (Settings::getInstance()->getBool("DeferGamelistViews") && preloadSystems.size() > 3) {
+        // Only create the views for the startup system and its adjacent systems now, the other
+        // views are created when idle after the first frame, in order of distance from the
+        // startup system. Any view that is navigated to before that is created on demand.
+        const size_t systemCount {preloadSystems.size()};
+        const std::string& startupSystem {Settings::getInstance()->getString("StartupSystem")};
+        SystemData* startSystem {getSystemListView()->getFirstSystem()};
+        for (auto system : preloadSystems) {
+            if (system->getName() == startupSystem) {
+                startSystem = system;
+                break;
+            }
+        }
+
+        const size_t startIndex {static_cast<size_t>(
+            std::find(preloadSystems.cbegin(), preloadSystems.cend(), startSystem) -
+            preloadSystems.cbegin())};
+        std::vector<SystemData*> orderedSystems {preloadSystems[startIndex % systemCount]};
+        for (size_t offset {1}; offset <= systemCount / 2; ++offset) {
+            orderedSystems.emplace_back(preloadSystems[(startIndex + offset) % systemCount]);
+            if (offset != systemCount - offset)
+                orderedSystems.emplace_back(
+                    preloadSystems[(startIndex + systemCount - offset) % systemCount]);
+        }
+
+        preloadSystems.assign(orderedSystems.cbegin(), orderedSystems.cbegin() + 3);
+        mDeferredGamelistViews.assign(orderedSystems.cbegin() + 3, orderedSystems.cend());
+        // Skip the first update so that the first frame gets rendered before any deferred
+        // views are created.
+        mDeferredGamelistViewsDelay = 1;
+    }
 
+    const unsigned int systemCount {static_cast<unsigned int>(preloadSystems.size())};
     const bool splashScreen {Settings::getInstance()->getBool("SplashScreen")};
     float loadedSystems {0.0f};
     unsigned int lastTime {0};
     unsigned int accumulator {0};
     SDL_Event event {};
 
-    for (auto it = SystemData::sSystemVector.cbegin(); // Line break.
-         it != SystemData::sSystemVector.cend(); ++it) {
+    for (auto it = preloadSystems.cbegin(); it != preloadSystems.cend(); ++it) {
         // Poll events so that the OS doesn't think the application is hanging on startup,
         // this is required as the main application loop hasn't started yet.
         while (SDL_PollEvent(&event)) {
@@ -1408,6 +1502,7 @@ void ViewController::preload()
                 lastTime += SDL_GetTicks() - curTime;
             }
         }
+        StartupTimer::Phase phase {"gamelist", (*it)->getName()};
         (*it)->getIndex()->resetFilters();
         getGamelistView(*it)->preloadGamelist();
     }
@@ -1436,6 +1531,10 @@ void ViewController::preload()
     }
     if (!SystemData::sSystemVector.empty() && !themeSoundSupport)
         NavigationSounds::getInstance().loadThemeNavigationSounds(nullptr);
+
+    if (Settings::getInstance()->getBool("WatchGameDirectories") &&
+        !Settings::getInstance()->getBool("ParseGamelistOnly") && FileWatcher::isSupported())
+        mDirectoryWatcher = std::make_unique<GameDirectoryWatcher>();
 }
 
 void ViewController::reloadGamelistView(GamelistView* view, bool reloadTheme)
@@ -1465,6 +1564,15 @@ void ViewController::reloadGamelistView(GamelistView* view, bool reloadTheme)
             if (std::find(children.cbegin(), children.cend(), cursor) != children.cend())
                 newView->setCursor(cursor);
 
+            // Folders could have been removed if the game directories have changed.
+            cursorHistoryTemp.erase(
+                std::remove_if(cursorHistoryTemp.begin(), cursorHistoryTemp.end(),
+                               [&children](FileData* entry) {
+                                   return std::find(children.cbegin(), children.cend(),
+                                                    entry) == children.cend();
+                               }),
+                cursorHistoryTemp.end());
+
             if (isCurrent)
                 mCurrentView = newView;
 
@@ -1517,6 +1625,13 @@ void ViewController::reloadAll()
         it->first->getIndex()->resetFilters();
     }
 
+    // The gamelist views that have not yet been created still need the new theme.
+    for (auto system : mDeferredGamelistViews) {
+        if (std::find(SystemData::sSystemVector.cbegin(), SystemData::sSystemVector.cend(),
+                      system) != SystemData::sSystemVector.cend())
+            system->loadTheme(ThemeTriggers::TriggerType::NONE);
+    }
+
     ThemeData::setThemeTransitions();
 
     // Rebuild SystemListView.
@@ -1639,9 +1754,11 @@ void ViewController::rescanROMDirectory()
 {
     mWindow->setBlockInput(true);
     resetCamera();
+    mDirectoryWatcher.reset();
 
     mState.viewing = ViewMode::NOTHING;
     mGamelistViews.clear();
+    mDeferredGamelistViews.clear();
     mSystemListView.reset();
     mCurrentView.reset();
     mPreviousView.reset();
@@ -1649,6 +1766,8 @@ void ViewController::rescanROMDirectory()
 
     mWindow->renderSplashScreen(Window::SplashScreenState::SCANNING, 0.0f);
     CollectionSystemsManager::getInstance()->deinit(false);
+    // Media added or removed by other applications is picked up by a rescan.
+    MediaManifest::getInstance().clear();
     SystemData::loadConfig();
 
     if (SystemData::sStartupExitSignal) {
@@ -1677,6 +1796,56 @@ void ViewController::rescanROMDirectory()
     }
 }
 
+void ViewController::rescanGameDirectories()
+{
+    // The tree can't be compared to the directories if only the gamelist.xml files are parsed
+    // or if the folders are flattened, and removed system directories means that the list of
+    // systems needs to be updated.
+    bool fullRescan {Settings::getInstance()->getBool("ParseGamelistOnly")};
+
+    for (auto system : SystemData::sSystemVector) {
+        if (system->isCollection())
+            continue;
+        if (system->getFlattenFolders() ||
+            !Utils::FileSystem::isDirectory(system->getStartPath())) {
+            fullRescan = true;
+            break;
+        }
+    }
+
+    if (fullRescan) {
+        rescanROMDirectory();
+        return;
+    }
+
+    LOG(LogInfo) << "Rescanning the game directories of the loaded systems";
+    mWindow->renderSplashScreen(Window::SplashScreenState::SCANNING, 0.0f);
+
+    // Every folder in the tree is read again, any new folders are populated when their
+    // parent folders are processed.
+    const std::string& mediaDirectory {FileData::getMediaDirectory()};
+    std::vector<std::string> directories;
+
+    for (auto system : SystemData::sSystemVector) {
+        if (system->isCollection())
+            continue;
+        directories.emplace_back(system->getStartPath());
+        for (auto folder : system->getRootFolder()->getFilesRecursive(FOLDER))
+            directories.emplace_back(folder->getPath());
+        directories.emplace_back(mediaDirectory + system->getName());
+    }
+
+    GameDirectoryUpdater::updateDirectories(directories);
+
+    // Systems without any games are not shown, which requires a full rescan.
+    for (auto system : SystemData::sSystemVector) {
+        if (!system->isCollection() && system->getRootFolder()->getChildren().empty()) {
+            rescanROMDirectory();
+            return;
+        }
+    }
+}
+
 std::vector<HelpPrompt> ViewController::getHelpPrompts()
 {
     std::vector<HelpPrompt> prompts;
@@ -21,6 +21,7 @@
 
 #include <vector>
 
+class GameDirectoryWatcher;
 class GamelistView;
 class SystemData;
 class SystemView;
@@ -43,7 +44,9 @@ public:
     void updateAvailableDialog();
 
     // Try to completely populate the GamelistView map.
-    // Caches things so there's no pauses during transitions.
+    // Caches things so there's no pauses during transitions. Unless the DeferGamelistViews
+    // setting has been disabled, only the views for the startup system and its adjacent
+    // systems are created here and the rest are created in update() when idle.
     void preload();
 
     // If a basic view detected a metadata change, it can request to recreate
@@ -62,6 +65,10 @@ public:
 
     // Rescan the ROM directory for any changes to games and systems.
     void rescanROMDirectory();
+    // Only look for added or removed games and media files in the systems that are already
+    // loaded, which keeps the views and the cursor positions. Falls back to a full rescan if
+    // the systems themselves have changed.
+    void rescanGameDirectories();
 
     // Navigation.
     void goToNextGamelist();
@@ -106,6 +113,7 @@ public:
     bool input(InputConfig* config, Input input) override;
     void update(int deltaTime) override;
     void render(const glm::mat4& parentTrans) override;
+    bool isAnimating() override;
 
     enum class ViewMode {
         NOTHING,
@@ -174,6 +182,8 @@ private:
     ViewController() noexcept;
 
     void launch(FileData* game);
+    // Creates the next deferred gamelist view, if any.
+    void createDeferredGamelistView();
 
     Renderer* mRenderer;
     std::string mNoGamesErrorMessage;
@@ -189,6 +199,11 @@ private:
     std::shared_ptr<GuiComponent> mPreviousView;
     std::shared_ptr<GuiComponent> mSkipView;
     std::map<SystemData*, std::shared_ptr<GamelistView>> mGamelistViews;
+    // Systems for which preload() deferred the gamelist view creation.
+    std::vector<SystemData*> mDeferredGamelistViews;
+    int mDeferredGamelistViewsDelay;
+    // Only created if the WatchGameDirectories setting is enabled.
+    std::unique_ptr<GameDirectoryWatcher> mDirectoryWatcher;
     std::shared_ptr<SystemView> mSystemListView;
     ViewTransitionAnimation mLastTransitionAnim;
 
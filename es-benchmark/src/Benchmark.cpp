@@ -0,0 +1,27 @@
+//  SPDX-License-Identifier: MIT
+//
+//  ES-DE Frontend
+//  Benchmark.cpp
+//
+//  Minimal timing helpers shared by the micro-benchmarks.
+//
+
+#include "Benchmark.h"
+
+#include <cstdio>
+
+namespace Benchmark
+{
+    void printHeader(const std::string& title)
+    {
+        std::printf("\n%s\n", title.c_str());
+        std::printf("%-44s %12s %12s %9s\n", "Benchmark", "Legacy (ms)", "Current (ms)", "Speedup");
+    }
+
+    void printResult(const std::string& name, const double legacyTime, const double currentTime)
+    {
+        std::printf("%-44s %12.3f %12.3f %8.2fx\n", name.c_str(), legacyTime, currentTime,
+                    currentTime > 0.0 ? legacyTime / currentTime : 0.0);
+    }
+
+} // namespace Benchmark
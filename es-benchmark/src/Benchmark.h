@@ -0,0 +1,38 @@
+//  SPDX-License-Identifier: MIT
+//
+//  ES-DE Frontend
+//  Benchmark.h
+//
+//  Minimal timing helpers shared by the micro-benchmarks.
+//
+
+#ifndef ES_BENCHMARK_BENCHMARK_H
+#define ES_BENCHMARK_BENCHMARK_H
+
+#include <chrono>
+#include <string>
+
+namespace Benchmark
+{
+    // Runs the function the defined number of times and returns the average duration in
+    // milliseconds. The function is run once before measuring to warm up the caches.
+    template <typename T> double measure(const unsigned int iterations, T&& function)
+    {
+        function();
+        const auto startTime {std::chrono::steady_clock::now()};
+        for (unsigned int i {0}; i < iterations; ++i)
+            function();
+        const auto endTime {std::chrono::steady_clock::now()};
+        return std::chrono::duration<double, std::milli>(endTime - startTime).count() /
+               static_cast<double>(iterations);
+    }
+
+    void printHeader(const std::string& title);
+    void printResult(const std::string& name, const double legacyTime, const double currentTime);
+
+    void runCImgBenchmarks();
+    void runStringBenchmarks();
+
+} // namespace Benchmark
+
+#endif // ES_BENCHMARK_BENCHMARK_H
@@ -0,0 +1,287 @@
+//  SPDX-License-Identifier: MIT
+//
+//  ES-DE Frontend
+//  CImgBenchmark.cpp
+//
+//  Benchmarks for the CImg utility functions used by the miximage generator.
+//  The legacy implementations are the previous per-pixel and CImg based versions.
+//
+
+#include "Benchmark.h"
+#include "utils/CImgUtil.h"
+
+#include <random>
+
+namespace
+{
+    using Image = cimg_library::CImg<unsigned char>;
+
+    namespace Legacy
+    {
+        void convertBGRAToCImg(const std::vector<unsigned char>& imageBGRA, Image& image)
+        {
+            int counter {0};
+            for (int r {0}; r < image.height(); ++r) {
+                for (int c {0}; c < image.width(); ++c) {
+                    image(c, r, 0, 0) = imageBGRA[counter + 0];
+                    image(c, r, 0, 1) = imageBGRA[counter + 1];
+                    image(c, r, 0, 2) = imageBGRA[counter + 2];
+                    image(c, r, 0, 3) = imageBGRA[counter + 3];
+                    counter += 4;
+                }
+            }
+        }
+
+        void convertCImgToBGRA(const Image& image, std::vector<unsigned char>& imageBGRA)
+        {
+            for (int r {image.height() - 1}; r >= 0; --r) {
+                for (int c {0}; c < image.width(); ++c) {
+                    imageBGRA.emplace_back((unsigned char)image(c, r, 0, 0));
+                    imageBGRA.emplace_back((unsigned char)image(c, r, 0, 1));
+                    imageBGRA.emplace_back((unsigned char)image(c, r, 0, 2));
+                    imageBGRA.emplace_back((unsigned char)image(c, r, 0, 3));
+                }
+            }
+        }
+
+        void removeTransparentPadding(Image& image)
+        {
+            double pixelValueSum {0.0};
+            int rowCounterTop {0};
+            int rowCounterBottom {0};
+            unsigned int columnCounterLeft {0};
+            unsigned int columnCounterRight {0};
+
+            for (int i {image.height() - 1}; i > 0; --i) {
+                pixelValueSum = image.get_rows(i, i).get_shared_channel(3).sum();
+                if (pixelValueSum == 0.0)
+                    ++rowCounterTop;
+                else
+                    break;
+            }
+            for (int i {0}; i < image.height(); ++i) {
+                pixelValueSum = image.get_rows(i, i).get_shared_channel(3).sum();
+                if (pixelValueSum == 0.0)
+                    ++rowCounterBottom;
+                else
+                    break;
+            }
+            for (int i {0}; i < image.width(); ++i) {
+                pixelValueSum = image.get_columns(i, i).get_shared_channel(3).sum();
+                if (pixelValueSum == 0.0)
+                    ++columnCounterLeft;
+                else
+                    break;
+            }
+            for (int i {image.width() - 1}; i > 0; --i) {
+                pixelValueSum = image.get_columns(i, i).get_shared_channel(3).sum();
+                if (pixelValueSum == 0.0)
+                    ++columnCounterRight;
+                else
+                    break;
+            }
+
+            if (rowCounterTop > 0)
+                image.crop(0, 0, 0, 3, image.width() - 1, image.height() - 1 - rowCounterTop, 0, 0);
+            if (rowCounterBottom > 0)
+                image.crop(0, rowCounterBottom, 0, 3, image.width() - 1, image.height() - 1, 0, 0);
+            if (columnCounterLeft > 0)
+                image.crop(columnCounterLeft, 0, 0, 3, image.width() - 1, image.height() - 1, 0, 0);
+            if (columnCounterRight > 0)
+                image.crop(0, 0, 0, 3, image.width() - columnCounterRight - 1, image.height() - 1,
+                           0, 0);
+        }
+
+        void cropLetterboxes(Image& image)
+        {
+            int rowCounterUpper {0};
+            int rowCounterLower {0};
+
+            for (int i {image.height() - 1}; i > 0; --i) {
+                Image imageRow(image.get_rows(i, i));
+                imageRow.channels(0, 2);
+                if (imageRow.sum() == 0.0)
+                    ++rowCounterUpper;
+                else
+                    break;
+            }
+            for (int i {0}; i < image.height(); ++i) {
+                Image imageRow(image.get_rows(i, i));
+                imageRow.channels(0, 2);
+                if (imageRow.sum() == 0.0)
+                    ++rowCounterLower;
+                else
+                    break;
+            }
+
+            if (rowCounterUpper > 0)
+                image.crop(0, 0, 0, 3, image.width() - 1, image.height() - 1 - rowCounterUpper, 0,
+                           0);
+            if (rowCounterLower > 0)
+                image.crop(0, rowCounterLower, 0, 3, image.width() - 1, image.height() - 1, 0, 0);
+        }
+
+        void cropPillarboxes(Image& image)
+        {
+            unsigned int columnCounterLeft {0};
+            unsigned int columnCounterRight {0};
+
+            for (int i {0}; i < image.width(); ++i) {
+                Image imageColumn(image.get_columns(i, i));
+                imageColumn.channels(0, 2);
+                if (imageColumn.sum() == 0.0)
+                    ++columnCounterLeft;
+                else
+                    break;
+            }
+            for (int i {image.width() - 1}; i > 0; --i) {
+                Image imageColumn(image.get_columns(i, i));
+                imageColumn.channels(0, 2);
+                if (imageColumn.sum() == 0.0)
+                    ++columnCounterRight;
+                else
+                    break;
+            }
+
+            if (columnCounterLeft > 0)
+                image.crop(columnCounterLeft, 0, 0, 3, image.width() - 1, image.height() - 1, 0, 0);
+            if (columnCounterRight > 0)
+                image.crop(0, 0, 0, 3, image.width() - columnCounterRight - 1, image.height() - 1,
+                           0, 0);
+        }
+
+        void addDropShadow(Image& image,
+                           unsigned int shadowDistance,
+                           float transparency,
+                           unsigned int iterations)
+        {
+            Image shadowImage(image.width() + shadowDistance * 3,
+                              image.height() + shadowDistance * 3, 1, 4, 0);
+            Image maskImage(image.width(), image.height(), 1, 4, 0);
+            maskImage.draw_image(0, 0, image);
+            maskImage.get_shared_channels(0, 2).fill(255);
+
+            shadowImage.draw_image(shadowDistance, shadowDistance, image);
+            shadowImage.get_shared_channels(0, 2).fill(0);
+            shadowImage.get_shared_channel(3) /= transparency;
+            shadowImage.blur_box(static_cast<const float>(shadowDistance),
+                                 static_cast<const float>(shadowDistance), 1, true, iterations);
+
+            shadowImage.get_shared_channel(3).draw_image(0, 0, maskImage.get_shared_channels(0, 0),
+                                                         maskImage.get_shared_channel(3), 1, 255);
+            shadowImage.draw_image(0, 0, image.get_shared_channels(0, 2),
+                                   image.get_shared_channel(3), 1, 255);
+            removeTransparentPadding(shadowImage);
+
+            image = shadowImage;
+        }
+
+    } // namespace Legacy
+
+    // Random pixel data surrounded by the defined number of zeroed (black and transparent)
+    // rows and columns, to mimic letterboxed screenshots and padded marquee images.
+    Image createImage(const int width, const int height, const int padding)
+    {
+        std::mt19937 generator {1};
+        std::uniform_int_distribution<int> distribution {1, 255};
+        Image image(width, height, 1, 4, 0);
+        for (int c {0}; c < 4; ++c) {
+            for (int y {padding}; y < height - padding; ++y) {
+                for (int x {padding}; x < width - padding; ++x)
+                    image(x, y, 0, c) = static_cast<unsigned char>(distribution(generator));
+            }
+        }
+        return image;
+    }
+
+    void runResolution(const int width, const int height, const unsigned int iterations)
+    {
+        const std::string suffix {" " + std::to_string(width) + "x" + std::to_string(height)};
+        const Image source(createImage(width, height, height / 8));
+        std::vector<unsigned char> sourceBGRA;
+        Utils::CImg::convertCImgToBGRA(source, sourceBGRA);
+
+        Image image(width, height, 1, 4, 0);
+        Benchmark::printResult(
+            "convertBGRAToCImg" + suffix,
+            Benchmark::measure(iterations,
+                               [&] { Legacy::convertBGRAToCImg(sourceBGRA, image); }),
+            Benchmark::measure(iterations,
+                               [&] { Utils::CImg::convertBGRAToCImg(sourceBGRA, image); }));
+
+        Benchmark::printResult("convertCImgToBGRA" + suffix,
+                               Benchmark::measure(iterations,
+                                                  [&] {
+                                                      std::vector<unsigned char> result;
+                                                      Legacy::convertCImgToBGRA(source, result);
+                                                  }),
+                               Benchmark::measure(iterations, [&] {
+                                   std::vector<unsigned char> result;
+                                   Utils::CImg::convertCImgToBGRA(source, result);
+                               }));
+
+        Benchmark::printResult("removeTransparentPadding" + suffix,
+                               Benchmark::measure(iterations,
+                                                  [&] {
+                                                      Image result(source);
+                                                      Legacy::removeTransparentPadding(result);
+                                                  }),
+                               Benchmark::measure(iterations, [&] {
+                                   Image result(source);
+                                   Utils::CImg::removeTransparentPadding(result);
+                               }));
+
+        Benchmark::printResult("cropLetterboxes + cropPillarboxes" + suffix,
+                               Benchmark::measure(iterations,
+                                                  [&] {
+                                                      Image result(source);
+                                                      Legacy::cropLetterboxes(result);
+                                                      Legacy::cropPillarboxes(result);
+                                                  }),
+                               Benchmark::measure(iterations, [&] {
+                                   Image result(source);
+                                   Utils::CImg::cropLetterboxes(result);
+                                   Utils::CImg::cropPillarboxes(result);
+                               }));
+
+        // Drop shadows are applied to the downscaled marquee, box and physical media images,
+        // so use a quarter of the resolution and the shadow size used by the miximage generator.
+        const Image sprite(createImage(width / 4, height / 4, 8));
+        const unsigned int shadowSize {width >= 3840 ? 12u : 6u};
+        Benchmark::printResult("addDropShadow" + suffix,
+                               Benchmark::measure(iterations,
+                                                  [&] {
+                                                      Image result(sprite);
+                                                      Legacy::addDropShadow(result, shadowSize,
+                                                                            0.6f, 4);
+                                                  }),
+                               Benchmark::measure(iterations, [&] {
+                                   Image result(sprite);
+                                   Utils::CImg::addDropShadow(result, shadowSize, 0.6f, 4);
+                               }));
+
+        const Image spriteRGB(sprite.get_shared_channels(0, 2));
+        const Image spriteAlpha(sprite.get_shared_channel(3));
+        Image canvas(source);
+        Benchmark::printResult(
+            "alphaBlend" + suffix,
+            Benchmark::measure(
+                iterations,
+                [&] { canvas.draw_image(width / 8, height / 8, spriteRGB, spriteAlpha, 1, 255); }),
+            Benchmark::measure(iterations, [&] {
+                Utils::CImg::alphaBlend(canvas, spriteRGB, spriteAlpha, width / 8, height / 8);
+            }));
+    }
+
+} // namespace
+
+namespace Benchmark
+{
+    void runCImgBenchmarks()
+    {
+        printHeader("CImg utility functions");
+        runResolution(1920, 1080, 10);
+        runResolution(3840, 2160, 5);
+    }
+
+} // namespace Benchmark
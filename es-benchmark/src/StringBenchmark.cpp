@@ -0,0 +1,132 @@
+//  SPDX-License-Identifier: MIT
+//
+//  ES-DE Frontend
+//  StringBenchmark.cpp
+//
+//  Benchmarks for the string case conversion functions, which are used by the sort
+//  comparators, the gamelist filters and when populating the gamelists.
+//  The legacy implementations are the previous versions which always used ICU.
+//
+
+#include "Benchmark.h"
+#include "utils/StringUtil.h"
+
+#include <unicode/unistr.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace
+{
+    namespace Legacy
+    {
+        std::string toLower(const std::string& stringArg)
+        {
+            icu::UnicodeString convert {icu::UnicodeString::fromUTF8(stringArg.c_str())};
+            std::string stringLower;
+
+            convert.toLower();
+            return convert.toUTF8String(stringLower);
+        }
+
+        std::string toUpper(const std::string& stringArg)
+        {
+            icu::UnicodeString convert {icu::UnicodeString::fromUTF8(stringArg.c_str())};
+            std::string stringUpper;
+
+            convert.toUpper();
+            return convert.toUTF8String(stringUpper);
+        }
+
+    } // namespace Legacy
+
+    // Table names in the usual "Name (Manufacturer Year)" format. If nonASCII is set then
+    // every fourth name gets an accented character.
+    std::vector<std::string> createNames(const size_t count, const bool nonASCII)
+    {
+        const std::vector<std::string> titles {
+            "Attack from Mars", "Medieval Madness", "The Addams Family", "Twilight Zone",
+            "Monster Bash",     "Theatre of Magic", "Cirqus Voltaire",   "Black Knight 2000",
+            "Funhouse",         "Tales of the Arabian Nights"};
+        const std::vector<std::string> manufacturers {"Bally", "Williams", "Gottlieb", "Stern",
+                                                      "Data East"};
+        std::mt19937 generator {1};
+        std::vector<std::string> names;
+
+        for (size_t i {0}; i < count; ++i) {
+            std::string name {titles[generator() % titles.size()]};
+            if (nonASCII && i % 4 == 0)
+                name.append(" Édition Spéciale");
+            name.append(" (")
+                .append(manufacturers[generator() % manufacturers.size()])
+                .append(" ")
+                .append(std::to_string(1970 + generator() % 50))
+                .append(") v")
+                .append(std::to_string(i));
+            names.emplace_back(name);
+        }
+
+        return names;
+    }
+
+    template <typename T> void convertAll(const std::vector<std::string>& names, T&& function)
+    {
+        size_t length {0};
+        for (auto& name : names)
+            length += function(name).length();
+        // Prevent the conversions from being optimized away.
+        if (length == 0)
+            Benchmark::printHeader("");
+    }
+
+    void runNames(const std::string& suffix, const bool nonASCII)
+    {
+        const std::vector<std::string> names {createNames(2000, nonASCII)};
+
+        Benchmark::printResult(
+            "toUpper 2000 names" + suffix,
+            Benchmark::measure(20, [&] { convertAll(names, Legacy::toUpper); }),
+            Benchmark::measure(20, [&] { convertAll(names, Utils::String::toUpper); }));
+
+        Benchmark::printResult(
+            "toLower 2000 names" + suffix,
+            Benchmark::measure(20, [&] { convertAll(names, Legacy::toLower); }),
+            Benchmark::measure(20, [&] { convertAll(names, Utils::String::toLower); }));
+
+        // Same comparison as used by the name sort comparators.
+        Benchmark::printResult("sort 2000 names" + suffix,
+                               Benchmark::measure(5,
+                                                  [&] {
+                                                      std::vector<std::string> sorted {names};
+                                                      std::stable_sort(
+                                                          sorted.begin(), sorted.end(),
+                                                          [](const std::string& name1,
+                                                             const std::string& name2) {
+                                                              return Legacy::toUpper(name1) <
+                                                                     Legacy::toUpper(name2);
+                                                          });
+                                                  }),
+                               Benchmark::measure(5, [&] {
+                                   std::vector<std::string> sorted {names};
+                                   std::stable_sort(sorted.begin(), sorted.end(),
+                                                    [](const std::string& name1,
+                                                       const std::string& name2) {
+                                                        return Utils::String::toUpper(name1) <
+                                                               Utils::String::toUpper(name2);
+                                                    });
+                               }));
+    }
+
+} // namespace
+
+namespace Benchmark
+{
+    void runStringBenchmarks()
+    {
+        printHeader("String case conversion");
+        runNames(" (ASCII)", false);
+        runNames(" (mixed)", true);
+    }
+
+} // namespace Benchmark
@@ -0,0 +1,49 @@
+//  SPDX-License-Identifier: MIT
+//
+//  ES-DE Frontend
+//  main.cpp
+//
+//  Micro-benchmark utility comparing optimized code paths against their previous
+//  implementations. Run without arguments to execute all benchmarks, or pass the names
+//  of the benchmark groups to run.
+//
+
+#include "Benchmark.h"
+
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+    struct BenchmarkGroup {
+        const char* name;
+        void (*function)();
+    };
+
+    const BenchmarkGroup benchmarkGroups[] {{"cimg", &Benchmark::runCImgBenchmarks},
+                                            {"string", &Benchmark::runStringBenchmarks}};
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1 && (std::strcmp(argv[1], "--help") == 0 || std::strcmp(argv[1], "-h") == 0)) {
+        std::cout << "Usage: es-benchmark [group...]\nAvailable groups:";
+        for (auto& group : benchmarkGroups)
+            std::cout << " " << group.name;
+        std::cout << std::endl;
+        return 0;
+    }
+
+    for (auto& group : benchmarkGroups) {
+        bool runGroup {argc == 1};
+        for (int i {1}; i < argc; ++i) {
+            if (std::strcmp(argv[i], group.name) == 0)
+                runGroup = true;
+        }
+        if (runGroup)
+            group.function();
+    }
+
+    return 0;
+}
@@ -0,0 +1,239 @@
+//  SPDX-License-Identifier: MIT
+//
+//  ES-DE Frontend
+//  AnimationWorker.cpp
+//
+//  Renders GIF and Lottie animation frames ahead of time on a shared pool of worker threads
+//  so that the render thread only needs to upload the finished frames to the GPU.
+//  Each animation gets a small buffer of upcoming frames, and for short animations all
+//  frames can be kept so that every frame only gets rendered once.
+//
+
+#include "AnimationWorker.h"
+
+#include <algorithm>
+
+namespace
+{
+    // The number of upcoming frames that are rendered ahead of playback.
+    constexpr int FRAMES_AHEAD {4};
+    constexpr unsigned int MAX_THREADS {4};
+} // namespace
+
+AnimationWorker& AnimationWorker::getInstance()
+{
+    static AnimationWorker instance;
+    return instance;
+}
+
+AnimationWorker::AnimationWorker()
+    : mExit {false}
+{
+    // Leave some cores for the render thread, the texture loader and the video players.
+    const unsigned int threadCount {
+        std::clamp(std::thread::hardware_concurrency() / 2, 1u, MAX_THREADS)};
+
+    for (unsigned int i {0}; i < threadCount; ++i)
+        mThreads.emplace_back(&AnimationWorker::threadProc, this);
+}
+
+AnimationWorker::~AnimationWorker()
+{
+    {
+        std::unique_lock<std::mutex> lock {mMutex};
+        mJobs.clear();
+        mLowPriorityJobs.clear();
+        mExit = true;
+    }
+
+    mJobCondition.notify_all();
+    for (auto& thread : mThreads)
+        thread.join();
+}
+
+void AnimationWorker::queueJob(const void* owner, std::function<void()> job, const bool lowPriority)
+{
+    std::unique_lock<std::mutex> lock {mMutex};
+    (lowPriority ? mLowPriorityJobs : mJobs).emplace_back(Job {owner, std::move(job)});
+    mJobCondition.notify_one();
+}
+
+void AnimationWorker::cancelJobs(const void* owner)
+{
+    std::unique_lock<std::mutex> lock {mMutex};
+    // No further jobs are started for the owner while waiting, as otherwise jobs that queue
+    // another job when completing could keep this waiting indefinitely.
+    mCancelledOwners.insert(owner);
+    mDoneCondition.wait(lock, [&] { return mRunningOwners.find(owner) == mRunningOwners.cend(); });
+    // This is done after waiting as the running job may have queued another job.
+    mJobs.remove_if([owner](const Job& job) { return job.owner == owner; });
+    mLowPriorityJobs.remove_if([owner](const Job& job) { return job.owner == owner; });
+    mCancelledOwners.erase(owner);
+}
+
+void AnimationWorker::threadProc()
+{
+    std::unique_lock<std::mutex> lock {mMutex};
+
+    const auto isRunnable = [this](const Job& job) {
+        return mRunningOwners.find(job.owner) == mRunningOwners.cend() &&
+               mCancelledOwners.find(job.owner) == mCancelledOwners.cend();
+    };
+
+    while (true) {
+        std::list<Job>* jobs {nullptr};
+        std::list<Job>::iterator it;
+        mJobCondition.wait(lock, [&] {
+            for (auto list : {&mJobs, &mLowPriorityJobs}) {
+                it = std::find_if(list->begin(), list->end(), isRunnable);
+                if (it != list->end()) {
+                    jobs = list;
+                    return true;
+                }
+            }
+            return mExit;
+        });
+
+        if (mExit)
+            return;
+
+        Job job {std::move(*it)};
+        jobs->erase(it);
+        mRunningOwners.insert(job.owner);
+
+        lock.unlock();
+        job.function();
+        lock.lock();
+
+        mRunningOwners.erase(job.owner);
+        mDoneCondition.notify_all();
+        // Jobs for the same owner may have been waiting for this job to complete.
+        mJobCondition.notify_all();
+    }
+}
+
+AnimationFrameBuffer::AnimationFrameBuffer()
+    : mTotalFrames {0}
+    , mNextFrame {0}
+    , mDirection {1}
+    , mCacheAllFrames {false}
+    , mJobQueued {false}
+{
+}
+
+void AnimationFrameBuffer::setAnimation(RenderFunction renderFunction,
+                                        int totalFrames,
+                                        bool cacheAllFrames)
+{
+    clear();
+
+    std::unique_lock<std::mutex> lock {mMutex};
+    mRenderFunction = renderFunction;
+    mTotalFrames = totalFrames;
+    mCacheAllFrames = cacheAllFrames;
+}
+
+void AnimationFrameBuffer::clear()
+{
+    // No lock can be held while cancelling as the running job needs it to complete.
+    AnimationWorker::getInstance().cancelJobs(this);
+
+    std::unique_lock<std::mutex> lock {mMutex};
+    mFrames.clear();
+    mFailedFrames.clear();
+    mTotalFrames = 0;
+    mNextFrame = 0;
+    mDirection = 1;
+    mJobQueued = false;
+}
+
+void AnimationFrameBuffer::requestFrames(int frameNum, int direction)
+{
+    std::unique_lock<std::mutex> lock {mMutex};
+
+    if (mTotalFrames == 0)
+        return;
+
+    mNextFrame = ((frameNum % mTotalFrames) + mTotalFrames) % mTotalFrames;
+    mDirection = direction < 0 ? -1 : 1;
+
+    // Discard the frames that are no longer ahead of playback.
+    if (!mCacheAllFrames) {
+        for (auto it = mFrames.begin(); it != mFrames.end();) {
+            const int distance {(((*it).first - mNextFrame) * mDirection + mTotalFrames) %
+                                mTotalFrames};
+            if (distance >= FRAMES_AHEAD)
+                it = mFrames.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    if (!mJobQueued && getMissingFrame() != -1)
+        queueRenderJob();
+}
+
+bool AnimationFrameBuffer::getFrame(int frameNum, std::vector<uint8_t>& pictureRGBA)
+{
+    std::unique_lock<std::mutex> lock {mMutex};
+
+    auto it = mFrames.find(frameNum);
+    if (it == mFrames.end())
+        return mFailedFrames.find(frameNum) != mFailedFrames.cend();
+
+    if (mCacheAllFrames) {
+        pictureRGBA = (*it).second;
+    }
+    else {
+        pictureRGBA.swap((*it).second);
+        mFrames.erase(it);
+    }
+
+    return true;
+}
+
+int AnimationFrameBuffer::getMissingFrame()
+{
+    for (int i {0}; i < std::min(FRAMES_AHEAD, mTotalFrames); ++i) {
+        const int frameNum {((mNextFrame + i * mDirection) + mTotalFrames) % mTotalFrames};
+        if (mFrames.find(frameNum) == mFrames.cend() &&
+            mFailedFrames.find(frameNum) == mFailedFrames.cend())
+            return frameNum;
+    }
+    return -1;
+}
+
+void AnimationFrameBuffer::queueRenderJob()
+{
+    // Only a single frame is rendered per job so that other animations are not starved.
+    mJobQueued = true;
+    AnimationWorker::getInstance().queueJob(this, [this] { renderFrame(); });
+}
+
+void AnimationFrameBuffer::renderFrame()
+{
+    int frameNum {0};
+    {
+        std::unique_lock<std::mutex> lock {mMutex};
+        frameNum = getMissingFrame();
+        if (frameNum == -1) {
+            mJobQueued = false;
+            return;
+        }
+    }
+
+    // The render function is not replaced while a job is running, see setAnimation().
+    std::vector<uint8_t> pictureRGBA;
+    const bool success {mRenderFunction(frameNum, pictureRGBA)};
+
+    std::unique_lock<std::mutex> lock {mMutex};
+    if (success)
+        mFrames[frameNum] = std::move(pictureRGBA);
+    else
+        mFailedFrames.insert(frameNum);
+
+    if (getMissingFrame() != -1)
+        queueRenderJob();
+    else
+        mJobQueued = false;
+}
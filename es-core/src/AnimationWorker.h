@@ -0,0 +1,96 @@
+//  SPDX-License-Identifier: MIT
+//
+//  ES-DE Frontend
+//  AnimationWorker.h
+//
+//  Renders GIF and Lottie animation frames ahead of time on a shared pool of worker threads
+//  so that the render thread only needs to upload the finished frames to the GPU.
+//  Each animation gets a small buffer of upcoming frames, and for short animations all
+//  frames can be kept so that every frame only gets rendered once.
+//
+
+#ifndef ES_CORE_ANIMATION_WORKER_H
+#define ES_CORE_ANIMATION_WORKER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+class AnimationWorker
+{
+public:
+    static AnimationWorker& getInstance();
+
+    // The jobs for the same owner are never executed concurrently. Low priority jobs are only
+    // executed when no other jobs are waiting.
+    void queueJob(const void* owner, std::function<void()> job, const bool lowPriority = false);
+    // Removes any queued jobs for the owner and waits for a running job to complete.
+    void cancelJobs(const void* owner);
+
+private:
+    AnimationWorker();
+    ~AnimationWorker();
+
+    void threadProc();
+
+    struct Job {
+        const void* owner;
+        std::function<void()> function;
+    };
+
+    std::mutex mMutex;
+    std::condition_variable mJobCondition;
+    std::condition_variable mDoneCondition;
+    std::list<Job> mJobs;
+    std::list<Job> mLowPriorityJobs;
+    std::set<const void*> mRunningOwners;
+    std::set<const void*> mCancelledOwners;
+    std::vector<std::thread> mThreads;
+    bool mExit;
+};
+
+class AnimationFrameBuffer
+{
+public:
+    // Renders the requested frame into the buffer, this is called from the worker threads.
+    using RenderFunction = std::function<bool(int frameNum, std::vector<uint8_t>& pictureRGBA)>;
+
+    AnimationFrameBuffer();
+    ~AnimationFrameBuffer() { clear(); }
+
+    // If cacheAllFrames is set then rendered frames are never discarded.
+    void setAnimation(RenderFunction renderFunction, int totalFrames, bool cacheAllFrames);
+    // Cancels any pending rendering and discards all frames.
+    void clear();
+
+    // Requests the frames following frameNum in the direction of playback (1 or -1) to be
+    // rendered, wrapping around at the start and end of the animation.
+    void requestFrames(int frameNum, int direction);
+    // Copies the frame to pictureRGBA and returns true if it has been rendered. If the frame
+    // couldn't be rendered then true is returned and pictureRGBA is left unchanged.
+    bool getFrame(int frameNum, std::vector<uint8_t>& pictureRGBA);
+
+private:
+    // The mutex needs to be locked by the caller.
+    int getMissingFrame();
+    void queueRenderJob();
+    void renderFrame();
+
+    std::mutex mMutex;
+    RenderFunction mRenderFunction;
+    std::map<int, std::vector<uint8_t>> mFrames;
+    std::set<int> mFailedFrames;
+    int mTotalFrames;
+    int mNextFrame;
+    int mDirection;
+    bool mCacheAllFrames;
+    bool mJobQueued;
+};
+
+#endif // ES_CORE_ANIMATION_WORKER_H
@@ -0,0 +1,193 @@
+//  SPDX-License-Identifier: MIT
+//
+//  ES-DE Frontend
+//  FileWatcher.cpp
+//
+//  Watches directory trees for entries being added, removed or renamed. This uses inotify
+//  and is therefore only supported on Linux and Android, on other platforms no changes
+//  are ever reported.
+//
+
+#include "FileWatcher.h"
+
+#include "Log.h"
+#include "utils/FileSystemUtil.h"
+
+#include <algorithm>
+
+#if defined(__linux__)
+#include <errno.h>
+#include <filesystem>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+namespace
+{
+    constexpr uint32_t WATCH_MASK {IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+                                   IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR};
+
+} // namespace
+#endif
+
+FileWatcher::FileWatcher()
+    : mFileDescriptor {-1}
+    , mWatchLimitReached {false}
+{
+#if defined(__linux__)
+    mFileDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (mFileDescriptor == -1) {
+        LOG(LogError) << "FileWatcher: Couldn't initialize inotify, error code " << errno;
+    }
+#endif
+}
+
+FileWatcher::~FileWatcher()
+{
+#if defined(__linux__)
+    // Closing the file descriptor also removes all watches.
+    if (mFileDescriptor != -1)
+        close(mFileDescriptor);
+#endif
+}
+
+const bool FileWatcher::isSupported()
+{
+#if defined(__linux__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+void FileWatcher::addDirectory(const std::string& path)
+{
+#if defined(__linux__)
+    if (mFileDescriptor != -1)
+        mPendingDirectories.emplace_back(path);
+#endif
+}
+
+const bool FileWatcher::addPendingDirectories(const size_t maxDirectories)
+{
+    for (size_t i {0}; i < maxDirectories && !mPendingDirectories.empty(); ++i) {
+        const std::string path {mPendingDirectories.front()};
+        mPendingDirectories.pop_front();
+        addWatch(path);
+    }
+
+    return mPendingDirectories.empty();
+}
+
+void FileWatcher::addWatch(const std::string& path)
+{
+#if defined(__linux__)
+    const int watch {inotify_add_watch(mFileDescriptor, path.c_str(), WATCH_MASK)};
+
+    if (watch == -1) {
+        if (errno == ENOSPC) {
+            if (!mWatchLimitReached) {
+                LOG(LogWarning) << "FileWatcher: Reached the inotify watch limit, changes to \""
+                                << path << "\" and some other directories will not be detected "
+                                << "(the limit can be raised using the "
+                                << "fs.inotify.max_user_watches kernel parameter)";
+                mWatchLimitReached = true;
+            }
+        }
+        else if (errno != ENOENT) {
+            LOG(LogWarning) << "FileWatcher: Couldn't watch directory \"" << path
+                            << "\", error code " << errno;
+        }
+        return;
+    }
+
+    // The same watch is returned if the directory is already watched, for example if it has
+    // been moved, in which case only its path is updated.
+    mWatches[watch] = path;
+
+    std::error_code errorCode;
+    for (auto& entry : std::filesystem::directory_iterator(path, errorCode)) {
+        // Symlinked directories are not watched as they could lead anywhere, including to
+        // a parent directory.
+        if (entry.is_directory(errorCode) && !entry.is_symlink(errorCode))
+            mPendingDirectories.emplace_back(entry.path().generic_string());
+    }
+#endif
+}
+
+std::vector<std::string> FileWatcher::getChangedDirectories()
+{
+    std::vector<std::string> changedDirectories;
+
+#if defined(__linux__)
+    if (mFileDescriptor == -1)
+        return changedDirectories;
+
+    bool overflow {false};
+    alignas(inotify_event) char buffer[4096];
+
+    while (true) {
+        const ssize_t length {read(mFileDescriptor, buffer, sizeof(buffer))};
+        // With a non-blocking file descriptor this returns -1 when there are no more events.
+        if (length <= 0)
+            break;
+
+        for (ssize_t offset {0}; offset < length;) {
+            const inotify_event* event {reinterpret_cast<const inotify_event*>(buffer + offset)};
+            offset += sizeof(inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                overflow = true;
+                continue;
+            }
+
+            auto it = mWatches.find(event->wd);
+            if (it == mWatches.end())
+                continue;
+
+            // The watch is removed by the kernel after the directory has been deleted.
+            if (event->mask & IN_IGNORED) {
+                mWatches.erase(it);
+                continue;
+            }
+
+            const std::string directory {(*it).second};
+            changedDirectories.emplace_back(directory);
+
+            if (event->mask & IN_MOVE_SELF) {
+                // If the directory was moved somewhere within the watched directories then the
+                // paths have already been updated, otherwise the directory and its
+                // subdirectories are no longer of interest.
+                if (!Utils::FileSystem::isDirectory(directory)) {
+                    for (auto& watch : mWatches) {
+                        if (watch.second.compare(0, directory.length(), directory) == 0 &&
+                            (watch.second.length() == directory.length() ||
+                             watch.second[directory.length()] == '/'))
+                            inotify_rm_watch(mFileDescriptor, watch.first);
+                    }
+                }
+            }
+            else if ((event->mask & IN_ISDIR) && (event->mask & (IN_CREATE | IN_MOVED_TO)) &&
+                     event->len > 0) {
+                // The new directory is watched right away so that changes made to it shortly
+                // after its creation are detected, its subdirectories are added later.
+                addWatch(directory + "/" + event->name);
+            }
+        }
+    }
+
+    if (overflow) {
+        LOG(LogWarning) << "FileWatcher: Event queue overflow, treating all watched directories "
+                           "as changed";
+        for (auto& watch : mWatches)
+            changedDirectories.emplace_back(watch.second);
+    }
+
+    std::sort(changedDirectories.begin(), changedDirectories.end());
+    changedDirectories.erase(std::unique(changedDirectories.begin(), changedDirectories.end()),
+                             changedDirectories.end());
+#endif
+
+    return changedDirectories;
+}
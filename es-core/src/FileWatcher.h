@@ -0,0 +1,53 @@
+//  SPDX-License-Identifier: MIT
+//
+//  ES-DE Frontend
+//  FileWatcher.h
+//
+//  Watches directory trees for entries being added, removed or renamed. This uses inotify
+//  and is therefore only supported on Linux and Android, on other platforms no changes
+//  are ever reported.
+//
+
+#ifndef ES_CORE_FILE_WATCHER_H
+#define ES_CORE_FILE_WATCHER_H
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class FileWatcher
+{
+public:
+    FileWatcher();
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    static const bool isSupported();
+    const bool isInitialized() const { return mFileDescriptor != -1; }
+
+    // Watches the directory and all its subdirectories, except for symlinked subdirectories.
+    // Subdirectories that are created later on are watched automatically. The watches are
+    // not added until addPendingDirectories() is called.
+    void addDirectory(const std::string& path);
+    // Adds the watches for at most maxDirectories of the directories that are waiting to be
+    // watched, as reading large directory trees takes a while. Returns true when all
+    // directories are watched.
+    const bool addPendingDirectories(const size_t maxDirectories);
+    // Returns the directories in which entries have been added, removed or renamed since the
+    // last call, sorted and without duplicates. This never blocks. Directories that have been
+    // removed or moved away are included as well.
+    std::vector<std::string> getChangedDirectories();
+
+private:
+    void addWatch(const std::string& path);
+
+    int mFileDescriptor;
+    std::unordered_map<int, std::string> mWatches;
+    std::deque<std::string> mPendingDirectories;
+    bool mWatchLimitReached;
+};
+
+#endif // ES_CORE_FILE_WATCHER_H
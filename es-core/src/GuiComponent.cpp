@@ -266,6 +266,28 @@ void GuiComponent::cancelAllAnimations()
         cancelAnimation(i);
 }
 
+const bool GuiComponent::isAnyAnimationPlaying() const
+{
+    for (unsigned char i {0}; i < MAX_ANIMATIONS; ++i) {
+        if (mAnimationMap[i] != nullptr)
+            return true;
+    }
+    return false;
+}
+
+bool GuiComponent::isAnimating()
+{
+    if (isAnyAnimationPlaying())
+        return true;
+
+    for (auto child : mChildren) {
+        if (child->isVisible() && child->isAnimating())
+            return true;
+    }
+
+    return false;
+}
+
 void GuiComponent::setBrightness(float brightness)
 {
     if (mBrightness == brightness)
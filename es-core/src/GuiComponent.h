@@ -239,6 +239,11 @@ public:
     const bool advanceAnimation(unsigned char slot, unsigned int time);
     void stopAllAnimations();
     void cancelAllAnimations();
+    // Returns true if an animation is playing in any slot.
+    const bool isAnyAnimationPlaying() const;
+    // Returns true if the component or any of its visible children will change appearance
+    // on subsequent frames, this is used to determine whether a new frame needs to be rendered.
+    virtual bool isAnimating();
 
     virtual void stopGamelistFadeAnimations() {}
     virtual bool isListScrolling() { return false; }
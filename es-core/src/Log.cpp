@@ -5,32 +5,239 @@
 //
 //  Log output.
 //  This class is thread safe.
+//  Records are formatted on the calling thread and passed via a lock-free queue to a
+//  background writer thread which handles all file and console output.
 //
 
 #include "Log.h"
 #include "Settings.h"
 #include "utils/StringUtil.h"
 
-LogLevel Log::getReportingLevel()
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <ctime>
+#include <iterator>
+#include <memory>
+#include <thread>
+
+#include <fcntl.h>
+
+#if defined(_WIN64)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
 {
-    std::unique_lock<std::mutex> lock {sLogMutex};
-    return sReportingLevel;
-}
+    // Bounded lock-free queue for multiple producers and a single consumer. Each slot has a
+    // sequence number which tells whether it's free to be written to or ready to be read from.
+    class RecordQueue
+    {
+    public:
+        static constexpr size_t CAPACITY {8192};
+
+        RecordQueue()
+            : mSlots {new Slot[CAPACITY]}
+        {
+            for (size_t i {0}; i < CAPACITY; ++i)
+                mSlots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        // Returns false if the queue is full.
+        bool push(const LogLevel level, std::string&& record)
+        {
+            size_t position {mPushPosition.load(std::memory_order_relaxed)};
+            Slot* slot {nullptr};
+
+            while (true) {
+                slot = &mSlots[position & (CAPACITY - 1)];
+                const size_t sequence {slot->sequence.load(std::memory_order_acquire)};
+                const intptr_t difference {static_cast<intptr_t>(sequence) -
+                                           static_cast<intptr_t>(position)};
+                if (difference == 0) {
+                    if (mPushPosition.compare_exchange_weak(position, position + 1,
+                                                            std::memory_order_relaxed))
+                        break;
+                }
+                else if (difference < 0) {
+                    return false;
+                }
+                else {
+                    position = mPushPosition.load(std::memory_order_relaxed);
+                }
+            }
+
+            slot->level = level;
+            slot->record = std::move(record);
+            slot->sequence.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Must only be called by a single consumer at a time.
+        bool pop(LogLevel& level, std::string& record)
+        {
+            const size_t position {mPopPosition.load(std::memory_order_relaxed)};
+            Slot& slot {mSlots[position & (CAPACITY - 1)]};
+
+            if (slot.sequence.load(std::memory_order_acquire) != position + 1)
+                return false;
+
+            level = slot.level;
+            record = std::move(slot.record);
+            slot.record.clear();
+            slot.sequence.store(position + CAPACITY, std::memory_order_release);
+            mPopPosition.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool isEmpty() const
+        {
+            const size_t position {mPopPosition.load(std::memory_order_relaxed)};
+            return mSlots[position & (CAPACITY - 1)].sequence.load(std::memory_order_acquire) !=
+                   position + 1;
+        }
+
+        size_t getPushPosition() const { return mPushPosition.load(std::memory_order_acquire); }
+        size_t getPopPosition() const { return mPopPosition.load(std::memory_order_acquire); }
+
+    private:
+        struct Slot {
+            std::atomic<size_t> sequence;
+            LogLevel level;
+            std::string record;
+        };
+
+        std::unique_ptr<Slot[]> mSlots;
+        alignas(64) std::atomic<size_t> mPushPosition {0};
+        alignas(64) std::atomic<size_t> mPopPosition {0};
+    };
+
+    RecordQueue& getQueue()
+    {
+        static RecordQueue queue;
+        return queue;
+    }
+
+    const char* logLevelNames[] {"Error:  ", "Warn:   ", "Info:   ", "Debug:  "};
+
+    std::thread writer;
+    std::mutex writerMutex;
+    std::condition_variable writerCondition;
+    std::condition_variable flushCondition;
+    std::atomic<bool> writerRunning {false};
+    std::atomic<bool> writerIdle {false};
+    std::atomic<bool> consumerBusy {false};
+    std::atomic<bool> handlingCrash {false};
+    std::atomic<size_t> droppedRecords {0};
+    // Separate unbuffered file descriptor for the log file which is used by the crash handler.
+    std::atomic<int> crashFile {-1};
+    // These are protected by writerMutex.
+    bool stopWriter {false};
+    bool flushRequested {false};
+    size_t writtenPosition {0};
+
+#if defined(_WIN64)
+    const int crashSignals[] {SIGSEGV, SIGABRT, SIGFPE, SIGILL};
+    void (*previousHandlers[std::size(crashSignals)])(int) {};
+#else
+    const int crashSignals[] {SIGSEGV, SIGABRT, SIGFPE, SIGILL, SIGBUS};
+    struct sigaction previousActions[std::size(crashSignals)] {};
+#endif
+
+    std::string getTimestamp()
+    {
+        time_t t {time(nullptr)};
+        struct tm tm;
+#if defined(_WIN64)
+        // Of course Windows does not follow standards and puts the parameters the other way
+        // around compared to POSIX.
+        localtime_s(&tm, &t);
+#else
+        localtime_r(&t, &tm);
+#endif
+        char timestamp[32];
+        strftime(timestamp, sizeof(timestamp), "%b %d %H:%M:%S ", &tm);
+        return timestamp;
+    }
+
+    int openCrashFile(const std::string& path)
+    {
+#if defined(_WIN64)
+        return _wopen(Utils::String::stringToWideString(path).c_str(), _O_WRONLY | _O_APPEND);
+#else
+        return ::open(path.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+#endif
+    }
 
-void Log::setReportingLevel(LogLevel level)
+    void closeCrashFile()
+    {
+        const int file {crashFile.exchange(-1)};
+        if (file == -1)
+            return;
+#if defined(_WIN64)
+        _close(file);
+#else
+        ::close(file);
+#endif
+    }
+
+    // The following functions are async-signal-safe as they are used by the crash handler.
+
+    void writeToFile(const int file, const char* buffer, const size_t length)
+    {
+        if (file == -1)
+            return;
+#if defined(_WIN64)
+        _write(file, buffer, static_cast<unsigned int>(length));
+#else
+        // There is nothing that can be done about a failed write at this point.
+        if (::write(file, buffer, length) == -1)
+            return;
+#endif
+    }
+
+    void appendText(char* buffer, size_t& length, const size_t size, const char* text)
+    {
+        while (*text != '\0' && length < size)
+            buffer[length++] = *text++;
+    }
+
+    void appendNumber(char* buffer, size_t& length, const size_t size, size_t number)
+    {
+        char digits[24];
+        size_t count {0};
+
+        do {
+            digits[count++] = static_cast<char>('0' + number % 10);
+            number /= 10;
+        } while (number != 0);
+
+        while (count > 0 && length < size)
+            buffer[length++] = digits[--count];
+    }
+
+} // namespace
+
+std::string Log::getLogDirectory()
 {
-    std::unique_lock<std::mutex> lock {sLogMutex};
-    sReportingLevel = level;
+    if (Settings::getInstance()->getBool("LegacyAppDataDirectory"))
+        return Utils::FileSystem::getAppDataDirectory();
+    else
+        return Utils::FileSystem::getAppDataDirectory() + "/logs";
 }
 
 void Log::init()
 {
-    if (Settings::getInstance()->getBool("LegacyAppDataDirectory"))
-        sLogPath = Utils::FileSystem::getAppDataDirectory() + "/es_log.txt";
-    else
-        sLogPath = Utils::FileSystem::getAppDataDirectory() + "/logs/es_log.txt";
+    sLogPath = getLogDirectory() + "/es_log.txt";
+
+    const int maxFileSize {Settings::getInstance()->getInt("LogMaxFileSize")};
+    sMaxFileSize = static_cast<size_t>(std::clamp(maxFileSize, 0, 4096)) * 1024 * 1024;
 
     Utils::FileSystem::removeFile(sLogPath + ".bak");
+    Utils::FileSystem::removeFile(sLogPath + ".1");
     // Rename the previous log file.
     Utils::FileSystem::renameFile(sLogPath, sLogPath + ".bak", true);
     return;
@@ -38,42 +245,82 @@ void Log::init()
 
 void Log::open()
 {
-    std::unique_lock<std::mutex> lock {sLogMutex};
+    {
+        std::unique_lock<std::mutex> lock {sLogMutex};
 #if defined(_WIN64)
-    sFile.open(Utils::String::stringToWideString(sLogPath).c_str());
+        sFile.open(Utils::String::stringToWideString(sLogPath).c_str());
 #else
-    sFile.open(sLogPath.c_str());
+        sFile.open(sLogPath.c_str());
 #endif
+        sFileSize = 0;
+
+        if (!sFile.is_open())
+            return;
+
+        crashFile = openCrashFile(sLogPath);
+    }
+
+    // Make sure that any queued records are written to the log file if the application crashes.
+    for (size_t i {0}; i < std::size(crashSignals); ++i) {
+#if defined(_WIN64)
+        previousHandlers[i] = std::signal(crashSignals[i], &Log::crashHandler);
+#else
+        struct sigaction action {};
+        action.sa_handler = &Log::crashHandler;
+        sigemptyset(&action.sa_mask);
+        sigaction(crashSignals[i], &action, &previousActions[i]);
+#endif
+    }
+
+    stopWriter = false;
+    writerRunning = true;
+    writer = std::thread(&Log::writerThread);
 }
 
 void Log::flush()
 {
-    std::unique_lock<std::mutex> lock {sLogMutex};
-    sFile.flush();
+    if (!writerRunning) {
+        std::unique_lock<std::mutex> lock {sLogMutex};
+        sFile.flush();
+        return;
+    }
+
+    const size_t targetPosition {getQueue().getPushPosition()};
+    std::unique_lock<std::mutex> lock {writerMutex};
+    flushRequested = true;
+    writerCondition.notify_one();
+    // Use a timeout so that a stalled writer thread can't hang the application.
+    flushCondition.wait_for(lock, std::chrono::seconds(2),
+                            [targetPosition] { return writtenPosition >= targetPosition; });
 }
 
 void Log::close()
 {
+    if (writer.joinable()) {
+        {
+            std::unique_lock<std::mutex> lock {writerMutex};
+            stopWriter = true;
+        }
+        writerCondition.notify_one();
+        writer.join();
+        writerRunning = false;
+    }
+
     std::unique_lock<std::mutex> lock {sLogMutex};
-    if (sFile.is_open())
+    if (sFile.is_open()) {
+        // Write any records that were queued after the writer thread exited. Rotation is
+        // disabled as any logging from the file operations would deadlock on the log mutex.
+        sMaxFileSize = 0;
+        writeQueuedRecords();
         sFile.close();
+    }
+
+    closeCrashFile();
 }
 
 std::ostringstream& Log::get(LogLevel level)
 {
-    time_t t {time(nullptr)};
-    struct tm tm;
-#if defined(_WIN64)
-    // Of course Windows does not follow standards and puts the parameters the other way
-    // around compared to POSIX.
-    localtime_s(&tm, &t);
-#else
-    localtime_r(&t, &tm);
-#endif
-    std::unique_lock<std::mutex> lock {sLogMutex};
-    mOutStringStream << std::put_time(&tm, "%b %d %H:%M:%S ") << mLogLevelMap[level]
-                     << (level == LogLevel::LogInfo || level == LogLevel::LogWarning ? ":   " :
-                                                                                       ":  ");
+    mOutStringStream << getTimestamp() << logLevelNames[level];
     mMessageLevel = level;
 
     return mOutStringStream;
@@ -81,8 +328,24 @@ std::ostringstream& Log::get(LogLevel level)
 
 Log::~Log()
 {
+    mOutStringStream << '\n';
+
+    if (writerRunning) {
+        bool pushed {getQueue().push(mMessageLevel, mOutStringStream.str())};
+        // Errors are important enough to wait briefly for the writer thread to free up space.
+        for (int i {0}; !pushed && mMessageLevel == LogError && i < 100; ++i) {
+            writerCondition.notify_one();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            pushed = getQueue().push(mMessageLevel, mOutStringStream.str());
+        }
+        if (!pushed)
+            ++droppedRecords;
+        else if (writerIdle)
+            writerCondition.notify_one();
+        return;
+    }
+
     std::unique_lock<std::mutex> lock {sLogMutex};
-    mOutStringStream << std::endl;
 
     if (!sFile.is_open()) {
         // Not open yet, print to stdout.
@@ -100,27 +363,174 @@ Log::~Log()
         return;
     }
 
-    sFile << mOutStringStream.str();
+    writeRecord(mMessageLevel, mOutStringStream.str());
+}
+
+void Log::writerThread()
+{
+    RecordQueue& queue {getQueue()};
+
+    while (true) {
+        const bool wroteRecords {writeQueuedRecords()};
+
+        std::unique_lock<std::mutex> lock {writerMutex};
+        writtenPosition = queue.getPopPosition();
+        flushRequested = false;
+        flushCondition.notify_all();
+
+        if (stopWriter && queue.isEmpty())
+            break;
+
+        if (!wroteRecords) {
+            // Producers only notify when the writer is idle, and in the unlikely event that a
+            // notification is missed the records will be written when the wait times out.
+            writerIdle = true;
+            writerCondition.wait_for(lock, std::chrono::milliseconds(100), [&queue] {
+                return stopWriter || flushRequested || !queue.isEmpty();
+            });
+            writerIdle = false;
+        }
+    }
+}
+
+void Log::writeRecord(const LogLevel level, const std::string& record)
+{
+    sFile << record;
+    sFileSize += record.size();
 
 #if defined(__ANDROID__)
-    if (mMessageLevel == LogError) {
-        __android_log_print(ANDROID_LOG_ERROR, ANDROID_APPLICATION_ID, "%s",
-                            mOutStringStream.str().c_str());
+    if (level == LogError) {
+        __android_log_print(ANDROID_LOG_ERROR, ANDROID_APPLICATION_ID, "%s", record.c_str());
     }
     else if (sReportingLevel >= LogDebug) {
-        if (mMessageLevel == LogInfo)
-            __android_log_print(ANDROID_LOG_INFO, ANDROID_APPLICATION_ID, "%s",
-                                mOutStringStream.str().c_str());
-        else if (mMessageLevel == LogWarning)
-            __android_log_print(ANDROID_LOG_WARN, ANDROID_APPLICATION_ID, "%s",
-                                mOutStringStream.str().c_str());
+        if (level == LogInfo)
+            __android_log_print(ANDROID_LOG_INFO, ANDROID_APPLICATION_ID, "%s", record.c_str());
+        else if (level == LogWarning)
+            __android_log_print(ANDROID_LOG_WARN, ANDROID_APPLICATION_ID, "%s", record.c_str());
         else
-            __android_log_print(ANDROID_LOG_DEBUG, ANDROID_APPLICATION_ID, "%s",
-                                mOutStringStream.str().c_str());
+            __android_log_print(ANDROID_LOG_DEBUG, ANDROID_APPLICATION_ID, "%s", record.c_str());
     }
 #else
     // If it's an error or the --debug flag has been set, then print to the console as well.
-    if (mMessageLevel == LogError || sReportingLevel >= LogDebug)
-        std::cerr << mOutStringStream.str();
+    if (level == LogError || sReportingLevel >= LogDebug)
+        std::cerr << record;
+#endif
+}
+
+bool Log::writeQueuedRecords()
+{
+    // The crash handler may have taken over the queue.
+    if (consumerBusy.exchange(true, std::memory_order_acquire))
+        return false;
+
+    RecordQueue& queue {getQueue()};
+    LogLevel level;
+    std::string record;
+    bool wroteRecords {false};
+
+    while (queue.pop(level, record)) {
+        writeRecord(level, record);
+        wroteRecords = true;
+        if (sMaxFileSize != 0 && sFileSize >= sMaxFileSize)
+            rotateLogFile();
+    }
+
+    writeDroppedRecords();
+
+    if (wroteRecords)
+        sFile.flush();
+
+    consumerBusy.store(false, std::memory_order_release);
+    return wroteRecords;
+}
+
+void Log::writeDroppedRecords()
+{
+    const size_t dropped {droppedRecords.exchange(0)};
+
+    if (dropped == 0)
+        return;
+
+    writeRecord(LogWarning, getTimestamp() + logLevelNames[LogWarning] +
+                                std::to_string(dropped) +
+                                (dropped == 1 ? " log record was" : " log records were") +
+                                " dropped as the log queue was full\n");
+}
+
+void Log::rotateLogFile()
+{
+    sFile.close();
+    Utils::FileSystem::renameFile(sLogPath, sLogPath + ".1", true);
+#if defined(_WIN64)
+    sFile.open(Utils::String::stringToWideString(sLogPath).c_str());
+#else
+    sFile.open(sLogPath.c_str());
+#endif
+    sFileSize = 0;
+
+    const int file {openCrashFile(sLogPath)};
+    closeCrashFile();
+    crashFile = file;
+}
+
+void Log::crashHandler(int signal)
+{
+    // Only the first crashing thread writes to the log file.
+    if (!handlingCrash.exchange(true)) {
+        // Give the writer thread a brief moment to finish writing its current batch of records.
+        for (int i {0}; i < 200 && consumerBusy; ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        // If the writer thread is still busy, possibly because it's the thread that crashed,
+        // then the queue can't be drained as it only supports a single consumer.
+        if (!consumerBusy.exchange(true, std::memory_order_acquire)) {
+            RecordQueue& queue {getQueue()};
+            LogLevel level;
+            std::string record;
+
+            while (queue.pop(level, record))
+                writeRecord(level, record);
+
+            sFile.flush();
+        }
+
+        // The final message is formatted without any allocations and written directly to the
+        // file descriptor, as the file stream may be in use by the writer thread. There is no
+        // timestamp as the time conversion functions are not async-signal-safe.
+        char message[256];
+        const size_t size {sizeof(message)};
+        size_t length {0};
+        const size_t dropped {droppedRecords.exchange(0)};
+
+        if (dropped != 0) {
+            appendText(message, length, size, logLevelNames[LogWarning]);
+            appendNumber(message, length, size, dropped);
+            appendText(message, length, size,
+                       dropped == 1 ? " log record was" : " log records were");
+            appendText(message, length, size, " dropped as the log queue was full\n");
+        }
+
+        appendText(message, length, size, logLevelNames[LogError]);
+        appendText(message, length, size, "Received signal ");
+        appendNumber(message, length, size, static_cast<size_t>(signal));
+        appendText(message, length, size, ", the application will terminate\n");
+
+        writeToFile(crashFile, message, length);
+#if !defined(__ANDROID__)
+        writeToFile(2, message, length);
 #endif
+    }
+
+    // Restore the previous signal handler and raise the signal again.
+    for (size_t i {0}; i < std::size(crashSignals); ++i) {
+        if (crashSignals[i] != signal)
+            continue;
+#if defined(_WIN64)
+        std::signal(signal, previousHandlers[i] == SIG_ERR ? SIG_DFL : previousHandlers[i]);
+#else
+        sigaction(signal, &previousActions[i], nullptr);
+#endif
+    }
+
+    std::raise(signal);
 }
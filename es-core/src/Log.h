@@ -5,6 +5,8 @@
 //
 //  Log output.
 //  This class is thread safe.
+//  Records are formatted on the calling thread and passed via a lock-free queue to a
+//  background writer thread which handles all file and console output.
 //
 
 #ifndef ES_CORE_LOG_H
@@ -12,10 +14,10 @@
 
 #include "utils/FileSystemUtil.h"
 
+#include <atomic>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
-#include <map>
 #include <mutex>
 #include <sstream>
 
@@ -43,30 +45,37 @@ public:
 
     std::ostringstream& get(LogLevel level = LogInfo);
 
-    static LogLevel getReportingLevel();
-    static void setReportingLevel(LogLevel level);
+    static LogLevel getReportingLevel() { return sReportingLevel; }
+    static void setReportingLevel(LogLevel level) { sReportingLevel = level; }
+    // The directory for the log file, also used for the profiler and startup report files.
+    static std::string getLogDirectory();
 
     // These functions are not thread safe.
     static void init();
     static void open();
 
+    // Blocks until all queued records have been written to the log file.
     static void flush();
     static void close();
 
-protected:
+private:
+    static void writerThread();
+    // Writes a record to the log file and if applicable also to the console.
+    static void writeRecord(const LogLevel level, const std::string& record);
+    static bool writeQueuedRecords();
+    static void writeDroppedRecords();
+    static void rotateLogFile();
+    static void crashHandler(int signal);
+
     std::ostringstream mOutStringStream;
+    LogLevel mMessageLevel;
 
-private:
-    std::map<LogLevel, std::string> mLogLevelMap {// Log level indicators.
-                                                  {LogError, "Error"},
-                                                  {LogWarning, "Warn"},
-                                                  {LogInfo, "Info"},
-                                                  {LogDebug, "Debug"}};
     static inline std::ofstream sFile;
-    static inline LogLevel sReportingLevel = LogInfo;
+    static inline std::atomic<LogLevel> sReportingLevel {LogInfo};
     static inline std::mutex sLogMutex;
     static inline std::string sLogPath;
-    LogLevel mMessageLevel;
+    static inline size_t sFileSize {0};
+    static inline size_t sMaxFileSize {0};
 };
 
 #endif // ES_CORE_LOG_H
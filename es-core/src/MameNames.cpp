@@ -5,7 +5,8 @@
 //
 //  Provides expanded game names based on short MAME name arguments. Also contains
 //  functions to check whether a passed argument is a MAME BIOS or a MAME device.
-//  The data sources are stored as the files mamebioses.xml, mamedevices.xml and mamenames.xml.
+//  The data sources are stored as the files mamebioses.xml, mamedevices.xml and mamenames.xml,
+//  and these are compiled into the binary index file mameindex.bin at build time.
 //
 
 #include "MameNames.h"
@@ -15,8 +16,27 @@
 #include "utils/FileSystemUtil.h"
 
 #include <pugixml.hpp>
+
+#include <algorithm>
+#include <fstream>
 #include <string.h>
 
+#if defined(_WIN64)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const char INDEX_MAGIC[8] {'E', 'S', 'M', 'A', 'M', 'E', '0', '1'};
+    // Used to detect index files created on a machine with a different byte order.
+    const uint32_t BYTE_ORDER_MARK {0x01020304};
+} // namespace
+
 MameNames& MameNames::getInstance()
 {
     static MameNames instance;
@@ -24,87 +44,373 @@ MameNames& MameNames::getInstance()
 }
 
 MameNames::MameNames()
+    : mMappedData {nullptr}
+    , mMappedSize {0}
+#if defined(_WIN64)
+    , mFileHandle {INVALID_HANDLE_VALUE}
+    , mMappingHandle {nullptr}
+#endif
+    , mNames {nullptr}
+    , mBioses {nullptr}
+    , mDevices {nullptr}
+    , mStrings {nullptr}
+    , mNameCount {0}
+    , mBiosCount {0}
+    , mDeviceCount {0}
+    , mStringsSize {0}
 {
-    std::string xmlpath {ResourceManager::getInstance().getResourcePath(":/MAME/mamenames.xml")};
+}
 
-    if (!Utils::FileSystem::exists(xmlpath))
-        return;
+MameNames::~MameNames() { unmapIndexFile(); }
 
-    pugi::xml_document doc;
+std::string MameNames::getRealName(const std::string& mameName)
+{
+    std::call_once(mLoadFlag, &MameNames::load, this);
+
+    const uint32_t* entry {findEntry(mNames, mNameCount, 2, mameName)};
+    if (entry == nullptr || mStrings[entry[1]] == '\0')
+        return mameName;
+    else
+        return std::string {&mStrings[entry[1]]};
+}
+
+const bool MameNames::isBios(const std::string& biosName)
+{
+    std::call_once(mLoadFlag, &MameNames::load, this);
+    return findEntry(mBioses, mBiosCount, 1, biosName) != nullptr;
+}
+
+const bool MameNames::isDevice(const std::string& deviceName)
+{
+    std::call_once(mLoadFlag, &MameNames::load, this);
+    return findEntry(mDevices, mDeviceCount, 1, deviceName) != nullptr;
+}
+
+bool MameNames::compileIndex(const std::string& namesFile,
+                             const std::string& biosesFile,
+                             const std::string& devicesFile,
+                             const std::string& indexFile,
+                             std::string& errorMessage)
+{
+    std::vector<std::pair<std::string, std::string>> names;
+    std::vector<std::pair<std::string, std::string>> bioses;
+    std::vector<std::pair<std::string, std::string>> devices;
+
+    if (!readSourceFile(namesFile, "game", names, errorMessage) ||
+        !readSourceFile(biosesFile, "bios", bioses, errorMessage) ||
+        !readSourceFile(devicesFile, "device", devices, errorMessage))
+        return false;
+
+    std::vector<char> index;
+    buildIndex(names, bioses, devices, index);
 
 #if defined(_WIN64)
-    LOG(LogInfo) << "Parsing MAME names file \"" << Utils::String::replace(xmlpath, "/", "\\")
-                 << "\"...";
-    pugi::xml_parse_result result {
-        doc.load_file(Utils::String::stringToWideString(xmlpath).c_str())};
+    std::ofstream stream {Utils::String::stringToWideString(indexFile).c_str(),
+                          std::ios::binary | std::ios::trunc};
 #else
-    LOG(LogInfo) << "Parsing MAME names file \"" << xmlpath << "\"...";
-    pugi::xml_parse_result result {doc.load_file(xmlpath.c_str())};
+    std::ofstream stream {indexFile, std::ios::binary | std::ios::trunc};
 #endif
-
-    if (!result) {
-        LOG(LogError) << "Error parsing MAME names file \"" << xmlpath
-                      << "\": " << result.description();
-        return;
+    if (!stream.good()) {
+        errorMessage = "Couldn't open index file \"" + indexFile + "\" for writing";
+        return false;
     }
 
-    for (pugi::xml_node gameNode {doc.child("game")}; gameNode;
-         gameNode = gameNode.next_sibling("game")) {
-        mNamePairs[gameNode.child("mamename").text().get()] =
-            gameNode.child("realname").text().get();
+    stream.write(index.data(), static_cast<std::streamsize>(index.size()));
+    stream.close();
+
+    if (stream.fail()) {
+        errorMessage = "Couldn't write index file \"" + indexFile + "\"";
+        return false;
     }
 
-    // Read BIOS file.
-    xmlpath = ResourceManager::getInstance().getResourcePath(":/MAME/mamebioses.xml");
+    return true;
+}
+
+void MameNames::load()
+{
+    const std::string indexFile {
+        ResourceManager::getInstance().getResourcePath(":/MAME/mameindex.bin", false)};
 
-    if (!Utils::FileSystem::exists(xmlpath))
+    if (indexFile != "" && mapIndexFile(indexFile)) {
+#if defined(_WIN64)
+        LOG(LogInfo) << "Mapped MAME index file \"" << Utils::String::replace(indexFile, "/", "\\")
+                     << "\" (" << mNameCount << " names, " << mBiosCount << " BIOSes, "
+                     << mDeviceCount << " devices)";
+#else
+        LOG(LogInfo) << "Mapped MAME index file \"" << indexFile << "\" (" << mNameCount
+                     << " names, " << mBiosCount << " BIOSes, " << mDeviceCount << " devices)";
+#endif
         return;
+    }
+
+    // If there is no usable index file, which could be the case when cross compiling or when
+    // running from a source tree that has not been fully built, then parse the XML files.
+    LOG(LogInfo) << "No usable MAME index file found, parsing the MAME XML files instead";
 
+    std::vector<std::pair<std::string, std::string>> names;
+    std::vector<std::pair<std::string, std::string>> bioses;
+    std::vector<std::pair<std::string, std::string>> devices;
+    std::string errorMessage;
+
+    if (!readSourceFile(
+            ResourceManager::getInstance().getResourcePath(":/MAME/mamenames.xml", false), "game",
+            names, errorMessage) ||
+        !readSourceFile(
+            ResourceManager::getInstance().getResourcePath(":/MAME/mamebioses.xml", false),
+            "bios", bioses, errorMessage) ||
+        !readSourceFile(
+            ResourceManager::getInstance().getResourcePath(":/MAME/mamedevices.xml", false),
+            "device", devices, errorMessage)) {
+        LOG(LogError) << errorMessage;
+    }
+
+    buildIndex(names, bioses, devices, mIndexBuffer);
+    setupTables(mIndexBuffer.data(), mIndexBuffer.size());
+}
+
+bool MameNames::mapIndexFile(const std::string& indexFile)
+{
 #if defined(_WIN64)
-    LOG(LogInfo) << "Parsing MAME BIOSes file \"" << Utils::String::replace(xmlpath, "/", "\\")
-                 << "\"...";
-    result = doc.load_file(Utils::String::stringToWideString(xmlpath).c_str());
+    mFileHandle = CreateFileW(Utils::String::stringToWideString(indexFile).c_str(), GENERIC_READ,
+                              FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+    if (mFileHandle == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(mFileHandle, &fileSize) || fileSize.QuadPart == 0) {
+        unmapIndexFile();
+        return false;
+    }
+
+    mMappingHandle = CreateFileMappingW(mFileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mMappingHandle == nullptr) {
+        unmapIndexFile();
+        return false;
+    }
+
+    mMappedData =
+        static_cast<const char*>(MapViewOfFile(mMappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (mMappedData == nullptr) {
+        unmapIndexFile();
+        return false;
+    }
+    mMappedSize = static_cast<size_t>(fileSize.QuadPart);
 #else
-    LOG(LogInfo) << "Parsing MAME BIOSes file \"" << xmlpath << "\"...";
-    result = doc.load_file(xmlpath.c_str());
+    const int fileDescriptor {open(indexFile.c_str(), O_RDONLY)};
+    if (fileDescriptor == -1)
+        return false;
+
+    struct stat fileInfo;
+    if (fstat(fileDescriptor, &fileInfo) != 0 || fileInfo.st_size == 0) {
+        close(fileDescriptor);
+        return false;
+    }
+
+    void* data {
+        mmap(nullptr, static_cast<size_t>(fileInfo.st_size), PROT_READ, MAP_PRIVATE,
+             fileDescriptor, 0)};
+    // The mapping stays valid after the file descriptor has been closed.
+    close(fileDescriptor);
+
+    if (data == MAP_FAILED)
+        return false;
+
+    mMappedData = static_cast<const char*>(data);
+    mMappedSize = static_cast<size_t>(fileInfo.st_size);
 #endif
 
-    if (!result) {
-        LOG(LogError) << "Error parsing MAME BIOSes file \"" << xmlpath
-                      << "\": " << result.description();
-        return;
+    if (!setupTables(mMappedData, mMappedSize)) {
+        LOG(LogWarning) << "MAME index file \"" << indexFile << "\" is invalid";
+        unmapIndexFile();
+        return false;
     }
 
-    for (pugi::xml_node biosNode {doc.child("bios")}; biosNode;
-         biosNode = biosNode.next_sibling("bios")) {
-        std::string bios = biosNode.text().get();
-        mMameBioses.emplace_back(bios);
+    return true;
+}
+
+bool MameNames::setupTables(const char* data, const size_t size)
+{
+    if (size < sizeof(IndexHeader))
+        return false;
+
+    IndexHeader header;
+    memcpy(&header, data, sizeof(IndexHeader));
+
+    if (memcmp(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 ||
+        header.byteOrderMark != BYTE_ORDER_MARK)
+        return false;
+
+    // Make sure that all the tables and the string pool are within the bounds of the data.
+    const uint64_t tableEntries {static_cast<uint64_t>(header.nameCount) * 2 + header.biosCount +
+                                 header.deviceCount};
+    const uint64_t expectedSize {sizeof(IndexHeader) + tableEntries * sizeof(uint32_t) +
+                                 header.stringsSize};
+
+    if (expectedSize != size || header.stringsSize == 0 || data[size - 1] != '\0')
+        return false;
+
+    const uint32_t* tables {reinterpret_cast<const uint32_t*>(data + sizeof(IndexHeader))};
+
+    for (uint64_t i {0}; i < tableEntries; ++i) {
+        if (tables[i] >= header.stringsSize)
+            return false;
     }
 
-    // Read device file.
-    xmlpath = ResourceManager::getInstance().getResourcePath(":/MAME/mamedevices.xml");
+    mNames = tables;
+    mBioses = mNames + header.nameCount * 2;
+    mDevices = mBioses + header.biosCount;
+    mStrings = reinterpret_cast<const char*>(mDevices + header.deviceCount);
+    mNameCount = header.nameCount;
+    mBiosCount = header.biosCount;
+    mDeviceCount = header.deviceCount;
+    mStringsSize = header.stringsSize;
 
-    if (!Utils::FileSystem::exists(xmlpath))
-        return;
+    return true;
+}
 
+void MameNames::unmapIndexFile()
+{
 #if defined(_WIN64)
-    LOG(LogInfo) << "Parsing MAME devices file \"" << Utils::String::replace(xmlpath, "/", "\\")
-                 << "\"...";
-    result = doc.load_file(Utils::String::stringToWideString(xmlpath).c_str());
+    if (mMappedData != nullptr)
+        UnmapViewOfFile(mMappedData);
+    if (mMappingHandle != nullptr)
+        CloseHandle(mMappingHandle);
+    if (mFileHandle != INVALID_HANDLE_VALUE)
+        CloseHandle(mFileHandle);
+
+    mMappingHandle = nullptr;
+    mFileHandle = INVALID_HANDLE_VALUE;
 #else
-    LOG(LogInfo) << "Parsing MAME devices file \"" << xmlpath << "\"...";
-    result = doc.load_file(xmlpath.c_str());
+    if (mMappedData != nullptr)
+        munmap(const_cast<char*>(mMappedData), mMappedSize);
+#endif
+
+    mMappedData = nullptr;
+    mMappedSize = 0;
+}
+
+bool MameNames::readSourceFile(const std::string& sourceFile,
+                               const std::string& nodeName,
+                               std::vector<std::pair<std::string, std::string>>& entries,
+                               std::string& errorMessage)
+{
+    if (sourceFile == "" || !Utils::FileSystem::exists(sourceFile))
+        return true;
+
+    pugi::xml_document doc;
+
+#if defined(_WIN64)
+    const pugi::xml_parse_result result {
+        doc.load_file(Utils::String::stringToWideString(sourceFile).c_str())};
+#else
+    const pugi::xml_parse_result result {doc.load_file(sourceFile.c_str())};
 #endif
 
     if (!result) {
-        LOG(LogError) << "Error parsing MAME devices file \"" << xmlpath
-                      << "\": " << result.description();
-        return;
+        errorMessage = "Error parsing MAME file \"" + sourceFile + "\": " + result.description();
+        return false;
+    }
+
+    for (pugi::xml_node node {doc.child(nodeName.c_str())}; node;
+         node = node.next_sibling(nodeName.c_str())) {
+        if (nodeName == "game")
+            entries.emplace_back(node.child("mamename").text().get(),
+                                 node.child("realname").text().get());
+        else
+            entries.emplace_back(node.text().get(), "");
+    }
+
+    return true;
+}
+
+void MameNames::buildIndex(std::vector<std::pair<std::string, std::string>>& names,
+                           std::vector<std::pair<std::string, std::string>>& bioses,
+                           std::vector<std::pair<std::string, std::string>>& devices,
+                           std::vector<char>& index)
+{
+    // The sorting is stable so that the last of any duplicate entries can be kept, which is
+    // matches how the entries were previously inserted into a map when parsing the XML files.
+    auto sortEntries = [](std::vector<std::pair<std::string, std::string>>& entries) {
+        std::stable_sort(entries.begin(), entries.end(),
+                         [](const auto& a, const auto& b) { return a.first < b.first; });
+        std::vector<std::pair<std::string, std::string>> uniqueEntries;
+        for (size_t i {0}; i < entries.size(); ++i) {
+            if (entries[i].first == "")
+                continue;
+            if (i + 1 < entries.size() && entries[i + 1].first == entries[i].first)
+                continue;
+            uniqueEntries.emplace_back(std::move(entries[i]));
+        }
+        entries.swap(uniqueEntries);
+    };
+
+    sortEntries(names);
+    sortEntries(bioses);
+    sortEntries(devices);
+
+    std::vector<uint32_t> tables;
+    // Offset 0 is the empty string.
+    std::string strings(1, '\0');
+
+    auto addString = [&strings](const std::string& string) {
+        if (string == "")
+            return uint32_t {0};
+        const uint32_t offset {static_cast<uint32_t>(strings.size())};
+        strings.append(string);
+        strings.push_back('\0');
+        return offset;
+    };
+
+    for (auto& name : names) {
+        tables.emplace_back(addString(name.first));
+        tables.emplace_back(addString(name.second));
     }
+    for (auto& bios : bioses)
+        tables.emplace_back(addString(bios.first));
+    for (auto& device : devices)
+        tables.emplace_back(addString(device.first));
+
+    IndexHeader header {};
+    memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    header.byteOrderMark = BYTE_ORDER_MARK;
+    header.nameCount = static_cast<uint32_t>(names.size());
+    header.biosCount = static_cast<uint32_t>(bioses.size());
+    header.deviceCount = static_cast<uint32_t>(devices.size());
+    header.stringsSize = static_cast<uint32_t>(strings.size());
 
-    for (pugi::xml_node deviceNode {doc.child("device")}; deviceNode;
-         deviceNode = deviceNode.next_sibling("device")) {
-        std::string device {deviceNode.text().get()};
-        mMameDevices.emplace_back(device);
+    index.resize(sizeof(IndexHeader) + tables.size() * sizeof(uint32_t) + strings.size());
+    char* data {index.data()};
+    memcpy(data, &header, sizeof(IndexHeader));
+    data += sizeof(IndexHeader);
+    if (!tables.empty())
+        memcpy(data, tables.data(), tables.size() * sizeof(uint32_t));
+    data += tables.size() * sizeof(uint32_t);
+    memcpy(data, strings.data(), strings.size());
+}
+
+const uint32_t* MameNames::findEntry(const uint32_t* table,
+                                     const uint32_t count,
+                                     const uint32_t stride,
+                                     const std::string& key) const
+{
+    if (table == nullptr || count == 0)
+        return nullptr;
+
+    uint32_t low {0};
+    uint32_t high {count};
+
+    // The keys are sorted in byte order, which is the same for strcmp() and std::string.
+    while (low < high) {
+        const uint32_t middle {low + (high - low) / 2};
+        const int result {strcmp(&mStrings[table[middle * stride]], key.c_str())};
+        if (result == 0)
+            return &table[middle * stride];
+        else if (result < 0)
+            low = middle + 1;
+        else
+            high = middle;
     }
+
+    return nullptr;
 }
@@ -5,7 +5,8 @@
 //
 //  Provides expanded game names based on short MAME name arguments. Also contains
 //  functions to check whether a passed argument is a MAME BIOS or a MAME device.
-//  The data sources are stored as the files mamebioses.xml, mamedevices.xml and mamenames.xml.
+//  The data sources are stored as the files mamebioses.xml, mamedevices.xml and mamenames.xml,
+//  and these are compiled into the binary index file mameindex.bin at build time.
 //
 
 #ifndef ES_CORE_MAMENAMES_H
@@ -14,9 +15,9 @@
 #include "Settings.h"
 #include "utils/StringUtil.h"
 
-#include <algorithm>
+#include <cstdint>
+#include <mutex>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 // Expand MAME names to full game names and lookup device and BIOS entries.
@@ -25,14 +26,7 @@ class MameNames
 public:
     static MameNames& getInstance();
 
-    std::string getRealName(const std::string& mameName)
-    {
-        std::string name {mNamePairs[mameName]};
-        if (name == "")
-            return mameName;
-        else
-            return name;
-    }
+    std::string getRealName(const std::string& mameName);
 
     std::string getCleanName(const std::string& mameName)
     {
@@ -43,23 +37,74 @@ public:
             return getRealName(mameName);
     }
 
-    const bool isBios(const std::string& biosName)
-    {
-        return std::find(mMameBioses.cbegin(), mMameBioses.cend(), biosName) != mMameBioses.cend();
-    }
+    const bool isBios(const std::string& biosName);
+    const bool isDevice(const std::string& deviceName);
 
-    const bool isDevice(const std::string& deviceName)
-    {
-        return std::find(mMameDevices.cbegin(), mMameDevices.cend(), deviceName) !=
-               mMameDevices.cend();
-    }
+    // Compiles the XML data source files into the binary index file, any missing source file
+    // is treated as empty. Used by the es-mame-index build tool.
+    static bool compileIndex(const std::string& namesFile,
+                             const std::string& biosesFile,
+                             const std::string& devicesFile,
+                             const std::string& indexFile,
+                             std::string& errorMessage);
 
 private:
     MameNames();
+    ~MameNames();
+
+    // Sorted tables with offsets into the string pool. The index file is memory mapped and the
+    // tables are binary searched in place, so nothing needs to be parsed or copied on startup.
+    struct IndexHeader {
+        char magic[8];
+        uint32_t byteOrderMark;
+        uint32_t nameCount;
+        uint32_t biosCount;
+        uint32_t deviceCount;
+        uint32_t stringsSize;
+        uint32_t reserved;
+    };
+
+    // Nothing is loaded until the first lookup, which in practice means that the data is only
+    // loaded if there is an arcade or Neo Geo system present.
+    void load();
+    bool mapIndexFile(const std::string& indexFile);
+    bool setupTables(const char* data, const size_t size);
+    void unmapIndexFile();
+
+    // A missing source file is not considered an error, it just results in no entries.
+    static bool readSourceFile(const std::string& sourceFile,
+                               const std::string& nodeName,
+                               std::vector<std::pair<std::string, std::string>>& entries,
+                               std::string& errorMessage);
+    static void buildIndex(std::vector<std::pair<std::string, std::string>>& names,
+                           std::vector<std::pair<std::string, std::string>>& bioses,
+                           std::vector<std::pair<std::string, std::string>>& devices,
+                           std::vector<char>& index);
+
+    const uint32_t* findEntry(const uint32_t* table,
+                              const uint32_t count,
+                              const uint32_t stride,
+                              const std::string& key) const;
+
+    std::once_flag mLoadFlag;
+    // Used if the index file is missing and the XML files had to be parsed instead.
+    std::vector<char> mIndexBuffer;
+
+    const char* mMappedData;
+    size_t mMappedSize;
+#if defined(_WIN64)
+    void* mFileHandle;
+    void* mMappingHandle;
+#endif
 
-    std::unordered_map<std::string, std::string> mNamePairs;
-    std::vector<std::string> mMameBioses;
-    std::vector<std::string> mMameDevices;
+    const uint32_t* mNames;
+    const uint32_t* mBioses;
+    const uint32_t* mDevices;
+    const char* mStrings;
+    uint32_t mNameCount;
+    uint32_t mBiosCount;
+    uint32_t mDeviceCount;
+    uint32_t mStringsSize;
 };
 
 #endif // ES_CORE_MAMENAMES_H
@@ -0,0 +1,267 @@
+//  SPDX-License-Identifier: MIT
+//
+//  ES-DE Frontend
+//  Profiler.cpp
+//
+//  Lightweight frame time profiler.
+//  Scoped timers record the CPU time spent in the various subsystems for every frame.
+//  The profiler is always compiled in but the timers don't do anything unless it has been
+//  enabled. The results are shown in an on-screen overlay with frame time percentiles and
+//  the most recent frames can be exported as a Chrome trace file (chrome://tracing or
+//  https://ui.perfetto.dev can be used to inspect it).
+//
+
+#include "Profiler.h"
+
+#include "Log.h"
+#include "utils/StringUtil.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <typeindex>
+#include <vector>
+
+#if defined(__GNUC__)
+#include <cxxabi.h>
+#endif
+
+namespace
+{
+    // The number of frames kept for the frame time percentiles and the trace export.
+    constexpr size_t MAX_FRAMES {600};
+    // The number of most recent frames used for the per-scope averages in the overlay.
+    constexpr size_t AVERAGE_FRAMES {60};
+    // Safeguard against runaway memory usage if endFrame() is not called.
+    constexpr size_t MAX_FRAME_EVENTS {8192};
+    // The number of scopes listed in the overlay.
+    constexpr size_t MAX_OVERLAY_SCOPES {14};
+
+    struct Event {
+        const char* name;
+        int64_t startTime;
+        int64_t duration;
+        unsigned int threadIndex;
+    };
+
+    struct Frame {
+        int64_t startTime {-1};
+        int64_t duration {0};
+        std::vector<Event> events;
+    };
+
+    const auto profilerStartTime {std::chrono::steady_clock::now()};
+
+    std::mutex profilerMutex;
+    std::deque<Frame> frames;
+    Frame currentFrame;
+    std::map<std::thread::id, unsigned int> threadIndexes;
+    std::map<std::type_index, std::string> typeNames;
+
+    unsigned int getThreadIndex()
+    {
+        const auto it = threadIndexes.find(std::this_thread::get_id());
+        if (it != threadIndexes.cend())
+            return it->second;
+
+        const unsigned int index {static_cast<unsigned int>(threadIndexes.size())};
+        threadIndexes[std::this_thread::get_id()] = index;
+        return index;
+    }
+
+    const float toMilliseconds(const int64_t time) { return static_cast<float>(time) / 1000.0f; }
+
+} // namespace
+
+void Profiler::setEnabled(const bool state)
+{
+    if (sEnabled == state)
+        return;
+
+    std::unique_lock<std::mutex> lock {profilerMutex};
+    frames.clear();
+    currentFrame = Frame {};
+    sEnabled = state;
+
+    LOG(LogInfo) << "Frame time profiler " << (state ? "enabled" : "disabled");
+}
+
+void Profiler::beginFrame()
+{
+    if (!sEnabled)
+        return;
+
+    std::unique_lock<std::mutex> lock {profilerMutex};
+    // Discard anything recorded for iterations of the application loop where no frame
+    // was rendered.
+    currentFrame.events.clear();
+    currentFrame.startTime = getTime();
+}
+
+void Profiler::endFrame()
+{
+    if (!sEnabled)
+        return;
+
+    std::unique_lock<std::mutex> lock {profilerMutex};
+
+    if (currentFrame.startTime < 0)
+        return;
+
+    currentFrame.duration = getTime() - currentFrame.startTime;
+    frames.emplace_back(std::move(currentFrame));
+    currentFrame = Frame {};
+
+    if (frames.size() > MAX_FRAMES)
+        frames.pop_front();
+}
+
+std::string Profiler::getStatistics()
+{
+    std::unique_lock<std::mutex> lock {profilerMutex};
+
+    if (frames.empty())
+        return "";
+
+    std::vector<int64_t> frameTimes;
+    for (auto& frame : frames)
+        frameTimes.emplace_back(frame.duration);
+    std::sort(frameTimes.begin(), frameTimes.end());
+
+    auto percentile = [&frameTimes](const size_t percent) {
+        return toMilliseconds(frameTimes[(frameTimes.size() - 1) * percent / 100]);
+    };
+
+    // Accumulate the time per scope name for the most recent frames.
+    std::map<std::string, int64_t> scopeTimes;
+    const size_t averageFrames {std::min(frames.size(), AVERAGE_FRAMES)};
+    for (auto it = frames.cend() - averageFrames; it != frames.cend(); ++it) {
+        for (auto& event : (*it).events)
+            scopeTimes[event.name] += event.duration;
+    }
+
+    std::vector<std::pair<std::string, int64_t>> sortedScopes {scopeTimes.cbegin(),
+                                                               scopeTimes.cend()};
+    std::sort(sortedScopes.begin(), sortedScopes.end(),
+              [](const auto& a, const auto& b) { return a.second > b.second; });
+    if (sortedScopes.size() > MAX_OVERLAY_SCOPES)
+        sortedScopes.resize(MAX_OVERLAY_SCOPES);
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2) << "Frame time (" << frames.size()
+       << " frames)\np50: " << percentile(50) << " ms  p90: " << percentile(90)
+       << " ms\np99: " << percentile(99) << " ms  max: " << toMilliseconds(frameTimes.back())
+       << " ms\nAverage per frame:";
+
+    for (auto& scope : sortedScopes) {
+        ss << "\n"
+           << scope.first << ": "
+           << toMilliseconds(scope.second) / static_cast<float>(averageFrames) << " ms";
+    }
+
+    return ss.str();
+}
+
+const bool Profiler::exportTrace(const std::string& path)
+{
+    std::unique_lock<std::mutex> lock {profilerMutex};
+
+    if (frames.empty()) {
+        LOG(LogWarning) << "Profiler::exportTrace(): No frames have been recorded";
+        return false;
+    }
+
+    std::ofstream traceFile;
+#if defined(_WIN64)
+    traceFile.open(Utils::String::stringToWideString(path).c_str());
+#else
+    traceFile.open(path.c_str());
+#endif
+
+    if (!traceFile.is_open()) {
+        LOG(LogError) << "Couldn't open trace file \"" << path << "\" for writing";
+        return false;
+    }
+
+    // Complete events ("ph":"X") are used throughout, the frames are placed on a separate track.
+    traceFile << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    traceFile << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1000,"
+                 "\"args\":{\"name\":\"Frames\"}}";
+
+    for (auto& frame : frames) {
+        traceFile << ",\n{\"name\":\"Frame\",\"ph\":\"X\",\"pid\":1,\"tid\":1000,\"ts\":"
+                  << frame.startTime << ",\"dur\":" << frame.duration << "}";
+        for (auto& event : frame.events) {
+            traceFile << ",\n{\"name\":\"" << Utils::String::escapeJSON(event.name)
+                      << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.threadIndex
+                      << ",\"ts\":" << event.startTime << ",\"dur\":" << event.duration << "}";
+        }
+    }
+
+    traceFile << "\n]}\n";
+    traceFile.close();
+
+    if (traceFile.fail()) {
+        LOG(LogError) << "Couldn't write trace file \"" << path << "\"";
+        return false;
+    }
+
+    LOG(LogInfo) << "Exported " << frames.size() << " frames to trace file \"" << path << "\"";
+    return true;
+}
+
+std::string Profiler::getTracePath()
+{
+    return Log::getLogDirectory() + "/es_frametrace.json";
+}
+
+int64_t Profiler::getTime()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now() - profilerStartTime)
+        .count();
+}
+
+const char* Profiler::getTypeName(const std::type_info& type)
+{
+    std::unique_lock<std::mutex> lock {profilerMutex};
+
+    const auto it = typeNames.find(std::type_index(type));
+    if (it != typeNames.cend())
+        return it->second.c_str();
+
+    std::string name {type.name()};
+#if defined(__GNUC__)
+    int status {0};
+    char* demangledName {abi::__cxa_demangle(type.name(), nullptr, nullptr, &status)};
+    if (status == 0 && demangledName != nullptr)
+        name = demangledName;
+    free(demangledName);
+#else
+    // MSVC returns names such as "class TextComponent".
+    if (name.find("class ") == 0)
+        name = name.substr(6);
+#endif
+    // Template arguments would make the names too long for the overlay.
+    name = name.substr(0, name.find('<'));
+
+    return typeNames.emplace(std::type_index(type), name).first->second.c_str();
+}
+
+void Profiler::addEvent(const char* name, const int64_t startTime, const int64_t endTime)
+{
+    std::unique_lock<std::mutex> lock {profilerMutex};
+
+    if (!sEnabled || currentFrame.events.size() >= MAX_FRAME_EVENTS)
+        return;
+
+    currentFrame.events.emplace_back(
+        Event {name, startTime, endTime - startTime, getThreadIndex()});
+}
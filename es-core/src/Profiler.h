@@ -0,0 +1,90 @@
+//  SPDX-License-Identifier: MIT
+//
+//  ES-DE Frontend
+//  Profiler.h
+//
+//  Lightweight frame time profiler.
+//  Scoped timers record the CPU time spent in the various subsystems for every frame.
+//  The profiler is always compiled in but the timers don't do anything unless it has been
+//  enabled. The results are shown in an on-screen overlay with frame time percentiles and
+//  the most recent frames can be exported as a Chrome trace file (chrome://tracing or
+//  https://ui.perfetto.dev can be used to inspect it).
+//
+
+#ifndef ES_CORE_PROFILER_H
+#define ES_CORE_PROFILER_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <typeinfo>
+
+#define PROFILER_CONCAT_INNER(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_INNER(a, b)
+
+// Times the rest of the enclosing scope, the name needs to be a string literal.
+#define PROFILE_SCOPE(name) Profiler::Scope PROFILER_CONCAT(profilerScope, __LINE__) {name}
+// Same as above but uses the class name of the component (or any other object) as the name.
+#define PROFILE_COMPONENT_SCOPE(component)                                                         \
+    Profiler::Scope PROFILER_CONCAT(profilerScope, __LINE__) { typeid(*component) }
+
+class Profiler
+{
+public:
+    class Scope
+    {
+    public:
+        explicit Scope(const char* name)
+            : mName {name}
+            , mStartTime {sEnabled ? getTime() : -1}
+        {
+        }
+        explicit Scope(const std::type_info& type)
+            : mName {nullptr}
+            , mStartTime {-1}
+        {
+            if (sEnabled) {
+                mName = getTypeName(type);
+                mStartTime = getTime();
+            }
+        }
+        ~Scope()
+        {
+            if (mStartTime >= 0)
+                addEvent(mName, mStartTime, getTime());
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* mName;
+        int64_t mStartTime;
+    };
+
+    static const bool isEnabled() { return sEnabled; }
+    // Any previously recorded data is discarded when the profiler is enabled or disabled.
+    static void setEnabled(const bool state);
+
+    // These should be called from the main thread at the start and end of each frame.
+    static void beginFrame();
+    static void endFrame();
+
+    // Returns the text for the on-screen overlay.
+    static std::string getStatistics();
+    // Writes the recorded frames as a Chrome trace JSON file.
+    static const bool exportTrace(const std::string& path);
+    static std::string getTracePath();
+
+    // Returns the time in microseconds since application startup, this is also used by the
+    // startup timer so that its phases line up with the profiler events.
+    static int64_t getTime();
+
+private:
+    static const char* getTypeName(const std::type_info& type);
+    static void addEvent(const char* name, const int64_t startTime, const int64_t endTime);
+
+    static inline std::atomic<bool> sEnabled {false};
+};
+
+#endif // ES_CORE_PROFILER_H
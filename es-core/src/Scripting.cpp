@@ -11,6 +11,10 @@
 //  For example, if the event is called "game-start", all scripts inside the directory
 //  <application data>/scripts/game-start/ will be executed.
 //
+//  The events are executed in order on a separate script runner thread. Optionally a
+//  long-running script host process can be configured which receives all events as
+//  lines on its standard input.
+//
 
 #include "Scripting.h"
 
@@ -21,73 +25,129 @@
 #include "utils/StringUtil.h"
 
 #include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
 
-namespace Scripting
+#if !defined(_WIN64)
+#include <signal.h>
+#endif
+
+namespace
 {
-    void fireEvent(const std::string& eventName,
-                   const std::string& arg1,
-                   const std::string& arg2,
-                   const std::string& arg3,
-                   const std::string& arg4)
+    // The caller waits for the scripts for these events to finish, for instance the game-start
+    // scripts need to complete before the emulator is launched.
+    const std::vector<std::string> blockingEvents {"game-start", "game-end", "quit", "reboot",
+                                                   "poweroff"};
+
+    // For these events only the latest state is of interest, so any event of the same type that
+    // is still waiting in the queue is replaced instead of queueing another one.
+    const std::vector<std::string> coalescedEvents {"game-select", "system-select",
+                                                    "config-changed", "settings-changed",
+                                                    "controls-changed"};
+
+    struct Event {
+        std::string name;
+        std::array<std::string, 4> args;
+        uint64_t sequence;
+    };
+
+    struct ScriptDirectory {
+        std::filesystem::file_time_type lastWriteTime;
+        std::vector<std::string> scripts;
+    };
+
+    class EventRunner
     {
-        if (!Settings::getInstance()->getBool("CustomEventScripts"))
-            return;
+    public:
+        EventRunner()
+            : mNextSequence {1}
+            , mProcessedSequence {0}
+            , mHost {nullptr}
+            , mHostRetryTime {std::chrono::steady_clock::now()}
+        {
+            mHostCommand = Utils::FileSystem::expandHomePath(
+                Settings::getInstance()->getString("CustomEventScriptHost"));
+            // The runner lives until the application exits, see getRunner().
+            std::thread(&EventRunner::runnerThread, this).detach();
+        }
 
-        LOG(LogDebug) << "Scripting::fireEvent(): " << eventName << " \"" << arg1 << "\" \"" << arg2
-                      << "\" \"" << arg3 << "\" \"" << arg4 << "\"";
+        // Returns the sequence number that the event will have been processed at.
+        uint64_t queueEvent(const std::string& eventName, std::array<std::string, 4>&& args)
+        {
+            std::unique_lock<std::mutex> lock {mMutex};
+
+            if (std::find(coalescedEvents.cbegin(), coalescedEvents.cend(), eventName) !=
+                coalescedEvents.cend()) {
+                for (auto& event : mQueue) {
+                    if (event.name == eventName) {
+                        event.args = std::move(args);
+                        return event.sequence;
+                    }
+                }
+            }
 
-        std::list<std::string> scriptDirList;
-        std::string scriptDir;
+            mQueue.emplace_back(Event {eventName, std::move(args), mNextSequence});
+            mQueueCondition.notify_one();
+            return mNextSequence++;
+        }
 
-        // Check in application data directory.
-        scriptDir = Utils::FileSystem::getAppDataDirectory() + "/scripts/" + eventName;
-        if (Utils::FileSystem::exists(scriptDir))
-            scriptDirList.push_back(scriptDir);
+        void waitForEvent(const uint64_t sequence)
+        {
+            std::unique_lock<std::mutex> lock {mMutex};
+            mProcessedCondition.wait(lock, [&] { return mProcessedSequence >= sequence; });
+        }
 
-        for (auto dirIt = scriptDirList.cbegin(); dirIt != scriptDirList.cend(); ++dirIt) {
-            std::list<std::string> scripts {Utils::FileSystem::getDirContent(*dirIt)};
-            // Sort the scripts in case-sensitive order on Linux, Unix and Android and in
-            // case-insensitive order on macOS and Windows.
-#if defined(__unix__)
-            scripts.sort([](std::string a, std::string b) { return a.compare(b) < 0; });
-#else
-            scripts.sort([](std::string a, std::string b) {
-                return Utils::String::toUpper(a).compare(Utils::String::toUpper(b)) < 0;
-            });
+    private:
+        void runnerThread()
+        {
+#if !defined(_WIN64)
+            // If the script host exits, then writing to its standard input would otherwise
+            // terminate the application with SIGPIPE instead of returning an error.
+            sigset_t signalSet;
+            sigemptyset(&signalSet);
+            sigaddset(&signalSet, SIGPIPE);
+            pthread_sigmask(SIG_BLOCK, &signalSet, nullptr);
 #endif
-            for (auto it = scripts.cbegin(); it != scripts.cend(); ++it) {
-                std::string arg1Quotation;
-                std::string arg2Quotation;
-                std::string arg3Quotation;
-                std::string arg4Quotation;
-                // Add quotation marks around the arguments as long as these are not already
-                // present (i.e. for arguments with spaces in them).
-                if (!arg1.empty() && arg1.front() != '\"')
-                    arg1Quotation = "\"";
-                if (!arg2.empty() && arg2.front() != '\"')
-                    arg2Quotation = "\"";
-                if (!arg3.empty() && arg3.front() != '\"')
-                    arg3Quotation = "\"";
-                if (!arg4.empty() && arg4.front() != '\"')
-                    arg4Quotation = "\"";
-                std::string script;
-                script.append(*it)
-                    .append(" ")
-                    .append(arg1Quotation)
-                    .append(arg1)
-                    .append(arg1Quotation)
-                    .append(" ")
-                    .append(arg2Quotation)
-                    .append(arg2)
-                    .append(arg2Quotation)
-                    .append(" ")
-                    .append(arg3Quotation)
-                    .append(arg3)
-                    .append(arg3Quotation)
-                    .append(" ")
-                    .append(arg4Quotation)
-                    .append(arg4)
-                    .append(arg4Quotation);
+            while (true) {
+                Event event;
+                {
+                    std::unique_lock<std::mutex> lock {mMutex};
+                    mQueueCondition.wait(lock, [this] { return !mQueue.empty(); });
+                    event = std::move(mQueue.front());
+                    mQueue.pop_front();
+                }
+
+                runScripts(event);
+
+                if (mHostCommand != "")
+                    sendToHost(event);
+
+                std::unique_lock<std::mutex> lock {mMutex};
+                mProcessedSequence = event.sequence;
+                mProcessedCondition.notify_all();
+            }
+        }
+
+        void runScripts(const Event& event)
+        {
+            for (auto& scriptPath : getScripts(event.name)) {
+                std::string script {scriptPath};
+                for (auto& arg : event.args) {
+                    script.append(" ");
+                    // Add quotation marks around the arguments as long as these are not
+                    // already present (i.e. for arguments with spaces in them).
+                    if (!arg.empty() && arg.front() != '\"')
+                        script.append("\"").append(arg).append("\"");
+                    else
+                        script.append(arg);
+                }
                 LOG(LogDebug) << "Executing: " << script;
 #if defined(__ANDROID__)
                 Utils::Platform::runSystemCommand("sh " + script);
@@ -96,5 +156,141 @@ namespace Scripting
 #endif
             }
         }
+
+        // The directory contents are only read again if the directory modification time has
+        // changed, i.e. if any scripts have been added, removed or renamed.
+        const std::vector<std::string>& getScripts(const std::string& eventName)
+        {
+            const std::string scriptDir {Utils::FileSystem::getAppDataDirectory() + "/scripts/" +
+                                         eventName};
+            const std::filesystem::file_time_type lastWriteTime {
+                Utils::FileSystem::getLastWriteTime(scriptDir)};
+
+            auto it = mScriptDirectories.find(eventName);
+            if (it != mScriptDirectories.end() && it->second.lastWriteTime == lastWriteTime)
+                return it->second.scripts;
+
+            ScriptDirectory& directory {mScriptDirectories[eventName]};
+            directory.lastWriteTime = lastWriteTime;
+            directory.scripts.clear();
+
+            if (lastWriteTime == std::filesystem::file_time_type::min())
+                return directory.scripts;
+
+            for (auto& script : Utils::FileSystem::getDirContent(scriptDir))
+                directory.scripts.emplace_back(script);
+
+            // Sort the scripts in case-sensitive order on Linux, Unix and Android and in
+            // case-insensitive order on macOS and Windows.
+#if defined(__unix__)
+            std::sort(directory.scripts.begin(), directory.scripts.end());
+#else
+            std::sort(directory.scripts.begin(), directory.scripts.end(),
+                      [](const std::string& a, const std::string& b) {
+                          return Utils::String::toUpper(a).compare(Utils::String::toUpper(b)) < 0;
+                      });
+#endif
+            return directory.scripts;
+        }
+
+        // Events are written as tab-separated lines with the event name followed by the four
+        // arguments. The script host is started on the first event and is restarted if it exits.
+        void sendToHost(const Event& event)
+        {
+            if (mHost == nullptr) {
+                if (std::chrono::steady_clock::now() < mHostRetryTime)
+                    return;
+                LOG(LogInfo) << "Starting event script host \"" << mHostCommand << "\"";
+#if defined(_WIN64)
+                mHost = _wpopen(Utils::String::stringToWideString(mHostCommand).c_str(), L"w");
+#else
+                mHost = popen(mHostCommand.c_str(), "w");
+#endif
+                if (mHost == nullptr) {
+                    LOG(LogError) << "Couldn't start event script host \"" << mHostCommand
+                                  << "\"";
+                    mHostRetryTime = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+                    return;
+                }
+            }
+
+            std::string line {event.name};
+            for (auto& arg : event.args) {
+                std::string hostArg {arg};
+                // Make sure that the arguments can't break the line format.
+                std::replace_if(
+                    hostArg.begin(), hostArg.end(),
+                    [](const char c) { return c == '\t' || c == '\n' || c == '\r'; }, ' ');
+                line.append("\t").append(hostArg);
+            }
+            line.append("\n");
+
+            if (fputs(line.c_str(), mHost) < 0 || fflush(mHost) != 0) {
+                LOG(LogError) << "Event script host \"" << mHostCommand
+                              << "\" is not accepting events, it will be restarted";
+                closeHost();
+                mHostRetryTime = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+                return;
+            }
+
+            // Close the standard input on quit so the host gets a chance to exit cleanly.
+            if (event.name == "quit")
+                closeHost();
+        }
+
+        void closeHost()
+        {
+#if defined(_WIN64)
+            _pclose(mHost);
+#else
+            pclose(mHost);
+#endif
+            mHost = nullptr;
+        }
+
+        std::mutex mMutex;
+        std::condition_variable mQueueCondition;
+        std::condition_variable mProcessedCondition;
+        std::deque<Event> mQueue;
+        uint64_t mNextSequence;
+        uint64_t mProcessedSequence;
+
+        // These are only accessed from the runner thread.
+        std::map<std::string, ScriptDirectory> mScriptDirectories;
+        std::string mHostCommand;
+        FILE* mHost;
+        std::chrono::steady_clock::time_point mHostRetryTime;
+    };
+
+    EventRunner& getRunner()
+    {
+        // This is intentionally never deleted as the detached runner thread may still be
+        // executing scripts while the application exits.
+        static EventRunner* runner {new EventRunner};
+        return *runner;
+    }
+
+} // namespace
+
+namespace Scripting
+{
+    void fireEvent(const std::string& eventName,
+                   const std::string& arg1,
+                   const std::string& arg2,
+                   const std::string& arg3,
+                   const std::string& arg4)
+    {
+        if (!Settings::getInstance()->getBool("CustomEventScripts"))
+            return;
+
+        LOG(LogDebug) << "Scripting::fireEvent(): " << eventName << " \"" << arg1 << "\" \"" << arg2
+                      << "\" \"" << arg3 << "\" \"" << arg4 << "\"";
+
+        EventRunner& runner {getRunner()};
+        const uint64_t sequence {runner.queueEvent(eventName, {arg1, arg2, arg3, arg4})};
+
+        if (std::find(blockingEvents.cbegin(), blockingEvents.cend(), eventName) !=
+            blockingEvents.cend())
+            runner.waitForEvent(sequence);
     }
 } // namespace Scripting
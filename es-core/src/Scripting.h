@@ -11,6 +11,10 @@
 //  For example, if the event is called "game-start", all scripts inside the directory
 //  <application data>/scripts/game-start/ will be executed.
 //
+//  The events are executed in order on a separate script runner thread. Optionally a
+//  long-running script host process can be configured which receives all events as
+//  lines on its standard input.
+//
 
 #ifndef ES_CORE_SCRIPTING_H
 #define ES_CORE_SCRIPTING_H
@@ -19,6 +23,8 @@
 
 namespace Scripting
 {
+    // Returns immediately for most events, but for events such as game-start and quit which
+    // need the scripts to have completed before proceeding, it waits for their execution.
     void fireEvent(const std::string& eventName,
                    const std::string& arg1 = "",
                    const std::string& arg2 = "",
@@ -13,6 +13,7 @@
 #include "GuiComponent.h"
 #include "Log.h"
 #include "Scripting.h"
+#include "StartupTimer.h"
 #include "utils/FileSystemUtil.h"
 #include "utils/StringUtil.h"
 
@@ -38,6 +39,7 @@ namespace
         "ForceFull",            // --force-full
         "ForceKiosk",           // --force-kiosk
         "ForceKid",             // --force-kid
+        "StartupReport",        // --startup-report
         "Debug",                // Whether we're in debug mode.
         "DebugFlag",            // Whether the --debug flag was passed.
 
@@ -143,6 +145,7 @@ void Settings::setDefaults()
     mBoolMap["MiximageIncludeBox"] = {true, true};
     mBoolMap["MiximageCoverFallback"] = {true, true};
     mBoolMap["MiximageIncludePhysicalMedia"] = {true, true};
+    mIntMap["MiximageOfflineGeneratorThreads"] = {0, 0};
 
     mStringMap["ScraperRegion"] = {"eu", "eu"};
     mStringMap["ScraperLanguage"] = {"en", "en"};
@@ -274,6 +277,7 @@ void Settings::setDefaults()
 #if !defined(USE_OPENGLES)
     mIntMap["AntiAliasing"] = {0, 0};
 #endif
+    mIntMap["IdleFrameRate"] = {10, 10};
     mIntMap["DisplayIndex"] = {1, 1};
     mIntMap["ScreenRotate"] = {0, 0};
 #if defined(__APPLE__)
@@ -315,6 +319,7 @@ void Settings::setDefaults()
 #endif
     mBoolMap["DebugMode"] = {false, false};
     mBoolMap["DisplayGPUStatistics"] = {false, false};
+    mBoolMap["DisplayFrameTimeProfiler"] = {false, false};
     mBoolMap["EnableMenuKidMode"] = {false, false};
 // macOS requires root privileges to reboot and power off so it doesn't make much
 // sense to enable this setting and menu entry for that operating system.
@@ -332,6 +337,7 @@ void Settings::setDefaults()
     mBoolMap["ForceKid"] = {false, false};
     mBoolMap["ForceKiosk"] = {false, false};
     mBoolMap["IgnoreGamelist"] = {false, false};
+    mBoolMap["StartupReport"] = {false, false};
     mBoolMap["SplashScreen"] = {true, true};
     mBoolMap["VSync"] = {true, true};
     mBoolMap["FullscreenPadding"] = {false, false};
@@ -350,6 +356,10 @@ void Settings::setDefaults()
     mBoolMap["DebugSkipMissingThemeFilesCustomCollections"] = {true, true};
     mBoolMap["LegacyGamelistFileLocation"] = {false, false};
     mBoolMap["CreatePlaceholderSystemDirectories"] = {false, false};
+    mBoolMap["DeferGamelistViews"] = {true, true};
+    mBoolMap["LottieDiskCache"] = {true, true};
+    mBoolMap["WatchGameDirectories"] = {false, false};
+    mStringMap["CustomEventScriptHost"] = {"", ""};
     mStringMap["OpenGLVersion"] = {"", ""};
 #if !defined(__ANDROID__)
     mStringMap["ROMDirectory"] = {"", ""};
@@ -358,6 +368,7 @@ void Settings::setDefaults()
 #if !defined(__ANDROID__)
     mStringMap["UserThemeDirectory"] = {"", ""};
 #endif
+    mIntMap["LogMaxFileSize"] = {100, 100};
     mIntMap["LottieMaxFileCache"] = {150, 150};
     mIntMap["LottieMaxTotalCache"] = {1024, 1024};
     mIntMap["ScraperConnectionTimeout"] = {30, 30};
@@ -429,6 +440,7 @@ void Settings::saveFile()
 
 void Settings::loadFile()
 {
+    StartupTimer::Phase phase {"settings"};
     std::string path;
     if (mBoolMap["LegacyAppDataDirectory"].second == true)
         path = Utils::FileSystem::getAppDataDirectory() + "/es_settings.xml";
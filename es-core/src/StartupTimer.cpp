@@ -0,0 +1,209 @@
+//  SPDX-License-Identifier: MIT
+//
+//  ES-DE Frontend
+//  StartupTimer.cpp
+//
+//  Records the wall clock and CPU time of the application startup phases, optionally
+//  per game system. The phases are recorded until the first frame has been rendered,
+//  at which point the report is written to the log and optionally to a JSON file.
+//
+
+#include "StartupTimer.h"
+
+#include "Log.h"
+#include "Profiler.h"
+#include "Settings.h"
+#include "utils/FileSystemUtil.h"
+#include "utils/StringUtil.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+#if defined(_WIN64)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+namespace
+{
+    // Safeguard against runaway memory usage if report() is never called.
+    constexpr size_t MAX_PHASES {4096};
+
+    struct SystemPhases {
+        std::string name;
+        unsigned int systemCount {0};
+        int64_t wallTime {0};
+        int64_t cpuTime {0};
+        std::string slowestSystem {};
+        int64_t slowestTime {0};
+    };
+
+    std::mutex startupTimerMutex;
+    std::vector<StartupTimer::PhaseTiming> phases;
+
+    std::string formatTimes(const int64_t wallTime, const int64_t cpuTime)
+    {
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(1) << static_cast<double>(wallTime) / 1000.0
+           << " ms (CPU " << static_cast<double>(cpuTime) / 1000.0 << " ms)";
+        return ss.str();
+    }
+
+} // namespace
+
+StartupTimer::Phase::Phase(const std::string& name, const std::string& system)
+    : mStartTime {-1}
+    , mStartCPUTime {0}
+{
+    if (sRecording) {
+        mName = name;
+        mSystem = system;
+        mStartTime = Profiler::getTime();
+        mStartCPUTime = getCPUTime();
+    }
+}
+
+StartupTimer::Phase::~Phase()
+{
+    if (mStartTime < 0)
+        return;
+
+    const int64_t wallTime {Profiler::getTime() - mStartTime};
+    const int64_t cpuTime {getCPUTime() - mStartCPUTime};
+
+    std::unique_lock<std::mutex> lock {startupTimerMutex};
+    if (sRecording && phases.size() < MAX_PHASES)
+        phases.emplace_back(PhaseTiming {mName, mSystem, mStartTime, wallTime, cpuTime});
+}
+
+void StartupTimer::reset()
+{
+    std::unique_lock<std::mutex> lock {startupTimerMutex};
+    phases.clear();
+    sRecording = true;
+}
+
+std::vector<StartupTimer::PhaseTiming> StartupTimer::getPhases()
+{
+    std::unique_lock<std::mutex> lock {startupTimerMutex};
+    return phases;
+}
+
+void StartupTimer::report()
+{
+    if (!sRecording.exchange(false))
+        return;
+
+    const std::vector<PhaseTiming> recordedPhases {getPhases()};
+    std::vector<SystemPhases> systemPhases;
+
+    LOG(LogInfo) << "Startup phase timings:";
+
+    for (auto& phase : recordedPhases) {
+        if (phase.system.empty()) {
+            LOG(LogInfo) << "  " << phase.name << ": "
+                         << formatTimes(phase.wallTime, phase.cpuTime);
+            continue;
+        }
+
+        LOG(LogDebug) << "  " << phase.name << " [" << phase.system
+                      << "]: " << formatTimes(phase.wallTime, phase.cpuTime);
+
+        auto it = std::find_if(systemPhases.begin(), systemPhases.end(),
+                               [&phase](const SystemPhases& entry) {
+                                   return entry.name == phase.name;
+                               });
+        if (it == systemPhases.end())
+            it = systemPhases.insert(it, SystemPhases {phase.name});
+
+        ++(*it).systemCount;
+        (*it).wallTime += phase.wallTime;
+        (*it).cpuTime += phase.cpuTime;
+        if (phase.wallTime > (*it).slowestTime) {
+            (*it).slowestSystem = phase.system;
+            (*it).slowestTime = phase.wallTime;
+        }
+    }
+
+    // The per-system phases are summed up as there could be hundreds of them.
+    for (auto& entry : systemPhases) {
+        LOG(LogInfo) << "  " << entry.name << " (" << entry.systemCount
+                     << (entry.systemCount == 1 ? " system" : " systems")
+                     << "): " << formatTimes(entry.wallTime, entry.cpuTime) << ", slowest \""
+                     << entry.slowestSystem << "\" " << entry.slowestTime / 1000 << " ms";
+    }
+
+    if (Settings::getInstance()->getBool("StartupReport"))
+        writeReport(getReportPath());
+}
+
+const bool StartupTimer::writeReport(const std::string& path)
+{
+    const std::vector<PhaseTiming> recordedPhases {getPhases()};
+
+    std::ofstream reportFile;
+#if defined(_WIN64)
+    reportFile.open(Utils::String::stringToWideString(path).c_str());
+#else
+    reportFile.open(path.c_str());
+#endif
+
+    if (!reportFile.is_open()) {
+        LOG(LogError) << "Couldn't open startup report file \"" << path << "\" for writing";
+        return false;
+    }
+
+    reportFile << "{\"timeUnit\":\"us\",\"phases\":[";
+
+    for (size_t i {0}; i < recordedPhases.size(); ++i) {
+        const PhaseTiming& phase {recordedPhases[i]};
+        reportFile << (i == 0 ? "\n" : ",\n")
+                   << "{\"name\":\"" << Utils::String::escapeJSON(phase.name)
+                   << "\",\"system\":\"" << Utils::String::escapeJSON(phase.system)
+                   << "\",\"start\":" << phase.startTime << ",\"wall\":" << phase.wallTime
+                   << ",\"cpu\":" << phase.cpuTime << "}";
+    }
+
+    reportFile << "\n]}\n";
+    reportFile.close();
+
+    if (reportFile.fail()) {
+        LOG(LogError) << "Couldn't write startup report file \"" << path << "\"";
+        return false;
+    }
+
+    LOG(LogInfo) << "Wrote startup report file \"" << path << "\"";
+    return true;
+}
+
+std::string StartupTimer::getReportPath()
+{
+    return Log::getLogDirectory() + "/es_startup.json";
+}
+
+int64_t StartupTimer::getCPUTime()
+{
+#if defined(_WIN64)
+    FILETIME creationTime;
+    FILETIME exitTime;
+    FILETIME kernelTime;
+    FILETIME userTime;
+    if (!GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime))
+        return 0;
+    // The times are in 100 nanosecond units.
+    const uint64_t kernel {(static_cast<uint64_t>(kernelTime.dwHighDateTime) << 32) |
+                           kernelTime.dwLowDateTime};
+    const uint64_t user {(static_cast<uint64_t>(userTime.dwHighDateTime) << 32) |
+                         userTime.dwLowDateTime};
+    return static_cast<int64_t>((kernel + user) / 10);
+#else
+    timespec threadTime;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &threadTime) != 0)
+        return 0;
+    return static_cast<int64_t>(threadTime.tv_sec) * 1000000 + threadTime.tv_nsec / 1000;
+#endif
+}
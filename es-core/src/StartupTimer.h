@@ -0,0 +1,66 @@
+//  SPDX-License-Identifier: MIT
+//
+//  ES-DE Frontend
+//  StartupTimer.h
+//
+//  Records the wall clock and CPU time of the application startup phases, optionally
+//  per game system. The phases are recorded until the first frame has been rendered,
+//  at which point the report is written to the log and optionally to a JSON file.
+//
+
+#ifndef ES_CORE_STARTUP_TIMER_H
+#define ES_CORE_STARTUP_TIMER_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class StartupTimer
+{
+public:
+    struct PhaseTiming {
+        std::string name;
+        std::string system;
+        // All times are in microseconds, with the start time relative to application startup.
+        int64_t startTime;
+        int64_t wallTime;
+        // CPU time of the thread that executed the phase.
+        int64_t cpuTime;
+    };
+
+    // Times the rest of the enclosing scope as a startup phase.
+    class Phase
+    {
+    public:
+        explicit Phase(const std::string& name, const std::string& system = "");
+        ~Phase();
+
+        Phase(const Phase&) = delete;
+        Phase& operator=(const Phase&) = delete;
+
+    private:
+        std::string mName;
+        std::string mSystem;
+        int64_t mStartTime;
+        int64_t mStartCPUTime;
+    };
+
+    static const bool isRecording() { return sRecording; }
+    // Discards all recorded phases and starts recording again.
+    static void reset();
+    static std::vector<PhaseTiming> getPhases();
+
+    // Writes the phases to the log and stops recording. If the StartupReport setting is
+    // enabled then the phases are also written as JSON to the file returned by getReportPath().
+    static void report();
+    static const bool writeReport(const std::string& path);
+    static std::string getReportPath();
+
+private:
+    static int64_t getCPUTime();
+
+    static inline std::atomic<bool> sRecording {true};
+};
+
+#endif // ES_CORE_STARTUP_TIMER_H
@@ -11,6 +11,7 @@
 
 #include "InputManager.h"
 #include "Log.h"
+#include "Profiler.h"
 #include "Scripting.h"
 #include "Sound.h"
 #include "components/HelpComponent.h"
@@ -28,6 +29,11 @@
 
 #define CLOCK_BACKGROUND_CREATION false
 
+// Time in milliseconds to keep rendering at the full frame rate after any user input and after
+// a texture has finished loading in the background (to allow for the fade-in).
+#define IDLE_INPUT_DELAY 1000
+#define IDLE_TEXTURE_DELAY 500
+
 Window::Window() noexcept
     : mRenderer {Renderer::getInstance()}
     , mSplashTextPositions {0.0f, 0.0f, 0.0f, 0.0f}
@@ -42,6 +48,9 @@ Window::Window() noexcept
     , mFrameCountElapsed {0}
     , mAverageDeltaTime {10}
     , mTimeSinceLastInput {0}
+    , mTextureLoadedCount {0}
+    , mTimeSinceTextureLoad {0}
+    , mIdleFrameTimer {0}
     , mBlockInput {false}
     , mNormalizeNextUpdate {false}
     , mRenderScreensaver {false}
@@ -187,6 +196,10 @@ bool Window::init(bool resized)
         "", Font::get(FONT_SIZE_SMALL), 0xFF00FFFF, ALIGN_LEFT, ALIGN_CENTER, glm::vec2 {1, 1},
         glm::vec3 {mRenderer->getScreenWidth() * 0.02f, mRenderer->getScreenHeight() * 0.02f, 0.0f},
         glm::vec2 {0.0f, 0.0f}, 0x00000000, 1.3f);
+    mProfilerText = std::make_unique<TextComponent>(
+        "", Font::get(FONT_SIZE_SMALL), 0xFFFF00FF, ALIGN_LEFT, ALIGN_CENTER, glm::vec2 {1, 1},
+        glm::vec3 {mRenderer->getScreenWidth() * 0.6f, mRenderer->getScreenHeight() * 0.02f, 0.0f},
+        glm::vec2 {0.0f, 0.0f}, 0x00000000, 1.3f);
 
     // Update our help because font sizes probably changed.
     if (peekGui())
@@ -318,6 +331,19 @@ void Window::input(InputConfig* config, Input input)
         Settings::getInstance()->setBool("DebugImage",
                                          !Settings::getInstance()->getBool("DebugImage"));
     }
+    else if (config->getDeviceId() == DEVICE_KEYBOARD && input.value && input.id == SDLK_p &&
+             SDL_GetModState() & KMOD_LCTRL && Settings::getInstance()->getBool("Debug")) {
+        // Toggle the frame time profiler overlay with Ctrl-P.
+        Settings::getInstance()->setBool(
+            "DisplayFrameTimeProfiler",
+            !Settings::getInstance()->getBool("DisplayFrameTimeProfiler"));
+    }
+    else if (config->getDeviceId() == DEVICE_KEYBOARD && input.value && input.id == SDLK_e &&
+             SDL_GetModState() & KMOD_LCTRL && Settings::getInstance()->getBool("Debug")) {
+        // Export the recorded frames as a Chrome trace file with Ctrl-E.
+        if (Profiler::isEnabled())
+            Profiler::exportTrace(Profiler::getTracePath());
+    }
     else {
         if (peekGui())
             // This is where the majority of inputs will be consumed: the GuiComponent Stack.
@@ -350,6 +376,8 @@ void Window::update(int deltaTime)
     if (mInvalidateCacheTimer > 0)
         mInvalidateCacheTimer = glm::clamp(mInvalidateCacheTimer - deltaTime, 0, 500);
 
+    Profiler::setEnabled(Settings::getInstance()->getBool("DisplayFrameTimeProfiler"));
+
     if (mNormalizeNextUpdate) {
         mNormalizeNextUpdate = false;
         mTimeSinceLastInput = 0;
@@ -381,18 +409,37 @@ void Window::update(int deltaTime)
             float textureVramUsageMiB {TextureResource::getTotalMemUsage() / 1024.0f / 1024.0f};
             float textureTotalUsageMiB {TextureResource::getTotalTextureSize() / 1024.0f / 1024.0f};
             float fontVramUsageMiB {Font::getTotalMemUsage() / 1024.0f / 1024.0f};
+            float mappedFilesMiB {ResourceManager::getMappedSize() / 1024.0f / 1024.0f};
+            const TextureDataManager::Statistics textureStats {TextureResource::getStatistics()};
 
             ss << "\nFont VRAM: " << fontVramUsageMiB
                << " MiB\nTexture VRAM: " << textureVramUsageMiB
-               << " MiB\nMax Texture VRAM: " << textureTotalUsageMiB << " MiB";
+               << " MiB\nMax Texture VRAM: " << textureTotalUsageMiB
+               << " MiB\nPending textures: " << textureStats.pendingSize / 1024.0f / 1024.0f
+               << " MiB\nEvictions: " << textureStats.evictionsPerSecond << "/s ("
+               << textureStats.downscaledTextures << " downscaled)\nMapped files: "
+               << mappedFilesMiB << " MiB";
             mGPUStatisticsText->setText(ss.str());
         }
 
+        if (Profiler::isEnabled())
+            mProfilerText->setText(Profiler::getStatistics());
+
         mFrameTimeElapsed = 0;
         mFrameCountElapsed = 0;
     }
 
     mTimeSinceLastInput += deltaTime;
+    mIdleFrameTimer += deltaTime;
+
+    const unsigned int textureLoadedCount {TextureResource::getLoadedCount()};
+    if (textureLoadedCount != mTextureLoadedCount) {
+        mTextureLoadedCount = textureLoadedCount;
+        mTimeSinceTextureLoad = 0;
+    }
+    else if (mTimeSinceTextureLoad < IDLE_TEXTURE_DELAY) {
+        mTimeSinceTextureLoad += deltaTime;
+    }
 
     // If there is a popup notification queued, then display it.
     if (mInfoPopupQueue.size() > 0) {
@@ -442,6 +489,29 @@ void Window::update(int deltaTime)
 #endif
 }
 
+bool Window::shouldRenderFrame(int& waitTime)
+{
+    waitTime = 0;
+    const int idleFrameRate {Settings::getInstance()->getInt("IdleFrameRate")};
+
+    if (idleFrameRate <= 0 || !isIdle()) {
+        mIdleFrameTimer = 0;
+        return true;
+    }
+
+    // Frames are still rendered at the idle frame rate so that any changes which are not
+    // reported via GuiComponent::isAnimating() will eventually be displayed.
+    const int frameTime {1000 / std::min(idleFrameRate, 60)};
+
+    if (mIdleFrameTimer >= frameTime) {
+        mIdleFrameTimer = 0;
+        return true;
+    }
+
+    waitTime = frameTime - mIdleFrameTimer;
+    return false;
+}
+
 bool Window::isBackgroundDimmed()
 {
     return !mGuiStack.empty() && (mGuiStack.front() != mGuiStack.back() || mRenderLaunchScreen);
@@ -449,6 +519,8 @@ bool Window::isBackgroundDimmed()
 
 void Window::render()
 {
+    TextureResource::beginFrame();
+
     // Short 25 ms delay before invalidating the cached background which will give the various
     // components a chance to render so they don't get exclued from the new cached image.
     if (mInitiateCacheTimer) {
@@ -500,6 +572,7 @@ void Window::render()
 
         if (bottom != top || mRenderLaunchScreen) {
             if (!mCachedBackground && mInvalidateCacheTimer == 0) {
+                PROFILE_SCOPE("Menu background");
                 // Generate a cache texture of the shaded background when opening the menu, which
                 // will remain valid until the menu is closed. This is way faster than having to
                 // render the shaders for every frame.
@@ -664,6 +737,9 @@ void Window::render()
 
     if (Settings::getInstance()->getBool("DisplayGPUStatistics"))
         mGPUStatisticsText->render(mRenderer->getIdentity());
+
+    if (Profiler::isEnabled())
+        mProfilerText->render(mRenderer->getIdentity());
 }
 
 void Window::updateSplashScreenText()
@@ -951,3 +1027,30 @@ bool Window::isProcessing()
     return count_if(mGuiStack.cbegin(), mGuiStack.cend(),
                     [](GuiComponent* c) { return c->isProcessing(); }) > 0;
 }
+
+bool Window::isIdle()
+{
+    if (mTimeSinceLastInput < IDLE_INPUT_DELAY || mTimeSinceTextureLoad < IDLE_TEXTURE_DELAY)
+        return false;
+
+    // Menus, the media viewer, the PDF viewer and the launch screen always render at the full
+    // frame rate.
+    if (mGuiStack.size() != 1 || mRenderMediaViewer || mRenderPDFViewer || mRenderLaunchScreen)
+        return false;
+
+    if (mInitiateCacheTimer || mInvalidateCacheTimer > 0 || mListScrollOpacity != 0.0f)
+        return false;
+
+    if ((mInfoPopup != nullptr && mInfoPopup->isRunning()) || !mInfoPopupQueue.empty())
+        return false;
+
+    if (Settings::getInstance()->getBool("DisplayGPUStatistics") || Profiler::isEnabled() ||
+        isProcessing())
+        return false;
+
+    // Any animations in the views are stopped while the screensaver is running.
+    if (mRenderScreensaver)
+        return !mScreensaver->isAnimating();
+
+    return !mGuiStack.front()->isAnimating();
+}
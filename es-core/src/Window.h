@@ -45,6 +45,7 @@ public:
 
         virtual void renderScreensaver() = 0;
         virtual void update(int deltaTime) = 0;
+        virtual bool isAnimating() = 0;
 
         virtual FileData* getCurrentGame() = 0;
         virtual void triggerNextGame() = 0;
@@ -101,6 +102,9 @@ public:
     void logInput(InputConfig* config, Input input);
     void update(int deltaTime);
     void render();
+    // Returns false if nothing on screen has changed, in which case the previous frame can be
+    // kept and waitTime is set to the time in milliseconds that can be spent waiting for events.
+    bool shouldRenderFrame(int& waitTime);
 
     void setBlockInput(const bool state) { mBlockInput = state; }
     void normalizeNextUpdate() { mNormalizeNextUpdate = true; }
@@ -175,6 +179,8 @@ private:
 
     // Returns true if at least one component on the stack is processing.
     bool isProcessing();
+    // Returns true if there is no user input and nothing is animating.
+    bool isIdle();
 
     struct ProgressBarRectangle {
         float barWidth;
@@ -201,6 +207,7 @@ private:
     std::vector<GuiComponent*> mGuiStack;
     std::vector<std::shared_ptr<Font>> mDefaultFonts;
     std::unique_ptr<TextComponent> mGPUStatisticsText;
+    std::unique_ptr<TextComponent> mProfilerText;
 
     Screensaver* mScreensaver;
     MediaViewer* mMediaViewer;
@@ -219,6 +226,9 @@ private:
     int mFrameCountElapsed;
     int mAverageDeltaTime;
     unsigned int mTimeSinceLastInput;
+    unsigned int mTextureLoadedCount;
+    int mTimeSinceTextureLoad;
+    int mIdleFrameTimer;
 
     bool mBlockInput;
     bool mNormalizeNextUpdate;
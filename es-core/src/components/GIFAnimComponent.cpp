@@ -19,9 +19,17 @@
 #include "resources/ResourceManager.h"
 #include "utils/StringUtil.h"
 
+namespace
+{
+    // Animations up to this size have all their frames kept in memory after being decoded.
+    constexpr size_t MAX_FILE_CACHE {64 * 1024 * 1024};
+    constexpr size_t MAX_TOTAL_CACHE {512 * 1024 * 1024};
+} // namespace
+
 GIFAnimComponent::GIFAnimComponent()
     : mRenderer {Renderer::getInstance()}
     , mTargetSize {0.0f, 0.0f}
+    , mCacheSize {0}
     , mFrameSize {0}
     , mAnimFile {nullptr}
     , mAnimation {nullptr}
@@ -68,6 +76,10 @@ GIFAnimComponent::GIFAnimComponent()
 
 GIFAnimComponent::~GIFAnimComponent()
 {
+    // The frames are decoded from the animation file on the animation worker threads.
+    mFrameBuffer.clear();
+    mTotalFrameCache -= mCacheSize;
+
     if (mAnimFile != nullptr) {
         fclose(mAnimFile);
         mAnimFile = nullptr;
@@ -77,6 +89,9 @@ GIFAnimComponent::~GIFAnimComponent()
 void GIFAnimComponent::setAnimation(const std::string& path)
 {
     if (mAnimation != nullptr) {
+        mFrameBuffer.clear();
+        mTotalFrameCache -= mCacheSize;
+        mCacheSize = 0;
         FreeImage_CloseMultiBitmap(mAnimation, 0);
         mAnimation = nullptr;
         mPictureRGBA.clear();
@@ -237,6 +252,43 @@ void GIFAnimComponent::setAnimation(const std::string& path)
     mFrameSize = mFileWidth * mFileHeight * 4;
     mTargetPacing = static_cast<int>((1000.0 / mFrameRate) / static_cast<double>(mSpeedModifier));
 
+    // Keep all frames of short animations so that each frame only needs to be decoded once.
+    const size_t animationSize {mFrameSize * static_cast<size_t>(mTotalFrames)};
+    const bool cacheAllFrames {animationSize < MAX_FILE_CACHE &&
+                               mTotalFrameCache + animationSize < MAX_TOTAL_CACHE};
+    if (cacheAllFrames) {
+        mCacheSize = animationSize;
+        mTotalFrameCache += mCacheSize;
+    }
+
+    // The frames are decoded on the animation worker threads, the animation file is only
+    // accessed from there until the frame buffer is cleared.
+    mFrameBuffer.setAnimation(
+        [this](int frameNum, std::vector<uint8_t>& pictureRGBA) {
+            FIMULTIBITMAP* animation {FreeImage_OpenMultiBitmapFromHandle(
+                FIF_GIF, &mAnimIO, static_cast<fi_handle>(mAnimFile), GIF_PLAYBACK)};
+            if (animation == nullptr)
+                return false;
+
+            FIBITMAP* frame {FreeImage_LockPage(animation, frameNum)};
+            if (frame == nullptr) {
+                FreeImage_CloseMultiBitmap(animation, 0);
+                return false;
+            }
+
+            FreeImage_PreMultiplyWithAlpha(frame);
+            pictureRGBA.resize(mFrameSize);
+
+            FreeImage_ConvertToRawBits(reinterpret_cast<BYTE*>(&pictureRGBA.at(0)), frame,
+                                       FreeImage_GetPitch(frame), 32, FI_RGBA_RED, FI_RGBA_GREEN,
+                                       FI_RGBA_BLUE, 1);
+
+            FreeImage_UnlockPage(animation, frame, false);
+            FreeImage_CloseMultiBitmap(animation, 0);
+            return true;
+        },
+        mTotalFrames, cacheAllFrames);
+
     if (mDirection == "reverse")
         mFrameNum = mTotalFrames - 1;
 
@@ -272,8 +324,10 @@ void GIFAnimComponent::resetComponent()
     mDirection = mStartDirection;
     mFrameNum = mStartDirection == "reverse" ? mTotalFrames - 1 : 0;
 
-    if (mAnimation != nullptr)
+    if (mAnimation != nullptr) {
         mLastRenderedFrame = static_cast<int>(mFrameNum);
+        mFrameBuffer.requestFrames(mFrameNum, mDirection == "reverse" ? -1 : 1);
+    }
 }
 
 void GIFAnimComponent::onSizeChanged()
@@ -479,6 +533,14 @@ void GIFAnimComponent::update(int deltaTime)
     }
 }
 
+bool GIFAnimComponent::isAnimating()
+{
+    if (mAnimation == nullptr || !isVisible() || mOpacity == 0.0f || mThemeOpacity == 0.0f)
+        return false;
+
+    return (!mPause && !mExternalPause) || GuiComponent::isAnimating();
+}
+
 void GIFAnimComponent::render(const glm::mat4& parentTrans)
 {
     if (mAnimation == nullptr || !isVisible() || mOpacity == 0.0f || mThemeOpacity == 0.0f)
@@ -541,28 +603,18 @@ void GIFAnimComponent::render(const glm::mat4& parentTrans)
                 mAnimationStartTime = std::chrono::system_clock::now();
         }
 
-        if (!mHoldFrame) {
-            mAnimation = FreeImage_OpenMultiBitmapFromHandle(
-                FIF_GIF, &mAnimIO, static_cast<fi_handle>(mAnimFile), GIF_PLAYBACK);
-
-            mFrame = FreeImage_LockPage(mAnimation, mFrameNum);
-            FreeImage_PreMultiplyWithAlpha(mFrame);
-            mPictureRGBA.clear();
-            mPictureRGBA.resize(mFrameSize);
+        if (!mHoldFrame && !mExternalPause) {
+            if (mFrameBuffer.getFrame(mFrameNum, mPictureRGBA)) {
+                mTexture->initFromPixels(&mPictureRGBA.at(0), mFileWidth, mFileHeight);
 
-            FreeImage_ConvertToRawBits(reinterpret_cast<BYTE*>(&mPictureRGBA.at(0)), mFrame,
-                                       FreeImage_GetPitch(mFrame), 32, FI_RGBA_RED, FI_RGBA_GREEN,
-                                       FI_RGBA_BLUE, 1);
-
-            mTexture->initFromPixels(&mPictureRGBA.at(0), mFileWidth, mFileHeight);
-
-            FreeImage_UnlockPage(mAnimation, mFrame, false);
-            FreeImage_CloseMultiBitmap(mAnimation, 0);
+                if (mDirection == "reverse")
+                    --mFrameNum;
+                else
+                    ++mFrameNum;
+            }
 
-            if (mDirection == "reverse")
-                --mFrameNum;
-            else
-                ++mFrameNum;
+            // Make sure that the upcoming frames are getting decoded.
+            mFrameBuffer.requestFrames(mFrameNum, mDirection == "reverse" ? -1 : 1);
         }
     }
 
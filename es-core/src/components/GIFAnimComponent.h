@@ -9,6 +9,7 @@
 #ifndef ES_CORE_COMPONENTS_GIF_ANIM_COMPONENT_H
 #define ES_CORE_COMPONENTS_GIF_ANIM_COMPONENT_H
 
+#include "AnimationWorker.h"
 #include "GuiComponent.h"
 #include "ThemeData.h"
 #include "renderers/Renderer.h"
@@ -36,6 +37,7 @@ public:
                             unsigned int properties) override;
 
     void update(int deltaTime) override;
+    bool isAnimating() override;
 
 private:
     void render(const glm::mat4& parentTrans) override;
@@ -72,6 +74,9 @@ private:
     glm::vec2 mTargetSize;
     std::shared_ptr<TextureResource> mTexture;
     std::vector<uint8_t> mPictureRGBA;
+    AnimationFrameBuffer mFrameBuffer;
+    static inline size_t mTotalFrameCache;
+    size_t mCacheSize;
     size_t mFrameSize;
 
     std::chrono::time_point<std::chrono::system_clock> mAnimationStartTime;
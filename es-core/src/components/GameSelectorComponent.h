@@ -65,36 +65,10 @@ public:
                          Settings::getInstance()->getBool("ForceKid"))};
 
         if (mGameSelection == GameSelection::RANDOM) {
-            int tries {mSystem->getRootFolder()->getGameCount().first < 6 ? 12 : 8};
-            for (int i {0}; i < mGameCount; ++i) {
-                if (mSystem->getRootFolder()->getGameCount().first == 0)
-                    break;
-                if (!mAllowDuplicates &&
-                    mSystem->getRootFolder()->getGameCount().first == mGames.size())
-                    break;
-                FileData* randomGame {nullptr};
-
-                if (mGameCount > 1 || lastGame == nullptr ||
-                    mSystem->getRootFolder()->getGameCount().first == 1)
-                    randomGame = mSystem->getRandomGame(nullptr, true);
-                else
-                    randomGame = mSystem->getRandomGame(lastGame, true);
-
-                if (std::find(mGames.begin(), mGames.end(), randomGame) != mGames.end()) {
-                    if (tries > 0) {
-                        --i;
-                        --tries;
-                    }
-                    else if (mAllowDuplicates && randomGame != nullptr) {
-                        mGames.emplace_back(randomGame);
-                    }
-
-                    continue;
-                }
-
-                if (randomGame != nullptr)
-                    mGames.emplace_back(randomGame);
-            }
+            // The games are drawn without replacement from a cached list in SystemData, and if
+            // a single game is shown then it's replaced with a different game when possible.
+            if (mSystem->getRootFolder()->getGameCount().first != 0)
+                mGames = mSystem->getRandomGames(mGameCount, lastGame, mAllowDuplicates);
         }
         else if (mGameSelection == GameSelection::LAST_PLAYED) {
             for (auto& child : mSystem->getRootFolder()->getChildrenLastPlayed()) {
@@ -32,6 +32,8 @@ public:
         std::string name;
         UserData object;
         EntryData data;
+        // If set, the name is generated by the entry name function when it's first needed.
+        bool deferredName {false};
     };
 
 protected:
@@ -96,6 +98,8 @@ protected:
     float mTitleOverlayOpacity;
     unsigned int mTitleOverlayColor;
 
+    std::function<std::string(const UserData&)> mEntryNameFunction;
+
 public:
     IList(const ScrollTierList& tierList = LIST_SCROLL_STYLE_QUICK,
           const ListLoopType& loopType = ListLoopType::LIST_PAUSE_AT_END)
@@ -143,7 +147,25 @@ public:
     const std::string& getSelectedName()
     {
         assert(size() > 0);
-        return mEntries.at(mCursor).name;
+        return getEntryName(mCursor);
+    }
+
+    // Generating the names can be expensive for large lists, so entries can be added with
+    // deferredName set and their names are then generated and cached when first displayed.
+    void setEntryNameFunction(const std::function<std::string(const UserData&)>& func)
+    {
+        mEntryNameFunction = func;
+    }
+
+    const std::string& getEntryName(const int index)
+    {
+        Entry& entry {mEntries.at(index)};
+        if (entry.deferredName) {
+            if (mEntryNameFunction)
+                entry.name = mEntryNameFunction(entry.object);
+            entry.deferredName = false;
+        }
+        return entry.name;
     }
 
     const UserData& getSelected() const
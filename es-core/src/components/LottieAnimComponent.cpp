@@ -13,8 +13,50 @@
 #include "Log.h"
 #include "ThemeData.h"
 #include "Window.h"
+#include "resources/LottieCache.h"
 #include "resources/ResourceManager.h"
 
+namespace
+{
+    struct DiskCacheWrite {
+        std::string animationData;
+        std::unique_ptr<rlottie::Animation> animation;
+        std::unique_ptr<LottieCache::SequenceWriter> writer;
+        std::vector<uint8_t> pictureRGBA;
+        size_t width;
+        size_t height;
+    };
+
+    // Renders a single frame into the disk cache per low priority job, so that the worker
+    // threads remain available for the frames needed for playback. The jobs are removed by
+    // cancelJobs() for the owner, which also frees the partially written sequence.
+    void queueDiskCacheJob(const void* owner, const std::shared_ptr<DiskCacheWrite>& write)
+    {
+        AnimationWorker::getInstance().queueJob(
+            owner,
+            [owner, write] {
+                // A separate animation instance is used so that the playback is not held up.
+                if (write->animation == nullptr) {
+                    write->animation =
+                        rlottie::Animation::loadFromData(write->animationData, "", "", false);
+                    if (write->animation == nullptr)
+                        return;
+                }
+
+                write->pictureRGBA.resize(write->width * write->height * 4);
+                rlottie::Surface surface {reinterpret_cast<uint32_t*>(&write->pictureRGBA[0]),
+                                          write->width, write->height,
+                                          write->width * sizeof(uint32_t)};
+                write->animation->renderSync(
+                    static_cast<size_t>(write->writer->getNextFrame()), surface, false);
+
+                if (write->writer->addFrame(write->pictureRGBA))
+                    queueDiskCacheJob(owner, write);
+            },
+            true);
+    }
+} // namespace
+
 LottieAnimComponent::LottieAnimComponent()
     : mRenderer {Renderer::getInstance()}
     , mTargetSize {0.0f, 0.0f}
@@ -23,7 +65,6 @@ LottieAnimComponent::LottieAnimComponent()
     , mCacheSize {0}
     , mFrameSize {0}
     , mAnimation {nullptr}
-    , mSurface {nullptr}
     , mStartDirection {"normal"}
     , mTotalFrames {0}
     , mFrameNum {0}
@@ -31,7 +72,6 @@ LottieAnimComponent::LottieAnimComponent()
     , mSpeedModifier {1.0f}
     , mTargetPacing {0}
     , mTimeAccumulator {0}
-    , mLastRenderedFrame {-1}
     , mSkippedFrames {0}
     , mHoldFrame {true}
     , mPause {false}
@@ -69,22 +109,20 @@ LottieAnimComponent::LottieAnimComponent()
 LottieAnimComponent::~LottieAnimComponent()
 {
     // This is required as rlottie could otherwise crash on application shutdown.
-    if (mFuture.valid())
-        mFuture.get();
-
+    AnimationWorker::getInstance().cancelJobs(this);
+    mFrameBuffer.clear();
     mTotalFrameCache -= mCacheSize;
 }
 
 void LottieAnimComponent::setAnimation(const std::string& path)
 {
     if (mAnimation != nullptr) {
-        if (mFuture.valid())
-            mFuture.get();
-        mSurface.reset();
+        AnimationWorker::getInstance().cancelJobs(this);
+        mFrameBuffer.clear();
         mAnimation.reset();
         mPictureRGBA.clear();
+        mTotalFrameCache -= mCacheSize;
         mCacheSize = 0;
-        mLastRenderedFrame = -1;
     }
 
     mPath = path;
@@ -105,19 +143,15 @@ void LottieAnimComponent::setAnimation(const std::string& path)
     }
 
     ResourceData animData {ResourceManager::getInstance().getFileData(mPath)};
+    const std::string animationData {reinterpret_cast<char*>(animData.ptr.get()), animData.length};
     std::string cache;
 
     // If in debug mode, then disable the rlottie caching so that animations can be replaced on
     // the fly using Ctrl+r reloads.
-    if (Settings::getInstance()->getBool("Debug")) {
-        mAnimation = rlottie::Animation::loadFromData(
-            std::string(reinterpret_cast<char*>(animData.ptr.get()), animData.length), cache, "",
-            false);
-    }
-    else {
-        mAnimation = rlottie::Animation::loadFromData(
-            std::string(reinterpret_cast<char*>(animData.ptr.get()), animData.length), cache);
-    }
+    if (Settings::getInstance()->getBool("Debug"))
+        mAnimation = rlottie::Animation::loadFromData(animationData, cache, "", false);
+    else
+        mAnimation = rlottie::Animation::loadFromData(animationData, cache);
 
     if (mAnimation == nullptr) {
         LOG(LogError) << "Couldn't parse Lottie animation file \"" << mPath << "\"";
@@ -182,14 +216,6 @@ void LottieAnimComponent::setAnimation(const std::string& path)
         mTargetSize = mSize;
 
     mPictureRGBA.resize(width * height * 4);
-    mSurface = std::make_unique<rlottie::Surface>(reinterpret_cast<uint32_t*>(&mPictureRGBA[0]),
-                                                  width, height, width * sizeof(uint32_t));
-
-    if (mSurface == nullptr) {
-        LOG(LogError) << "Couldn't create Lottie surface for file \"" << mPath << "\"";
-        mAnimation.reset();
-        return;
-    }
 
     // Some statistics for the file.
     mTotalFrames = mAnimation->totalFrame();
@@ -197,6 +223,62 @@ void LottieAnimComponent::setAnimation(const std::string& path)
     mFrameSize = width * height * 4;
     mTargetPacing = static_cast<int>((1000.0 / mFrameRate) / static_cast<double>(mSpeedModifier));
 
+    // Keep all frames if caching is enabled and we're not exceeding either the per-file max
+    // cache size or the total cache size, otherwise only a few frames are rendered ahead of
+    // playback. Note that this is completely unrelated to the texture caching used for images.
+    const size_t animationSize {mFrameSize * mTotalFrames};
+    const bool cacheAllFrames {mCacheFrames && animationSize < mMaxCacheSize &&
+                               mTotalFrameCache + animationSize < mMaxTotalFrameCache};
+    if (cacheAllFrames) {
+        mCacheSize = animationSize;
+        mTotalFrameCache += mCacheSize;
+    }
+
+    // Play back from the disk cache if the animation has been rendered at this size before.
+    std::shared_ptr<LottieCache::FrameSequence> frameSequence;
+    std::string hash;
+    if (Settings::getInstance()->getBool("LottieDiskCache")) {
+        hash = Utils::Math::md5Hash(animationData, false);
+        if (hash != "")
+            frameSequence =
+                LottieCache::getInstance().getFrameSequence(hash, width, height, mTotalFrames);
+    }
+
+    // The frames are rendered on the animation worker threads.
+    if (frameSequence != nullptr) {
+        mFrameBuffer.setAnimation(
+            [frameSequence](int frameNum, std::vector<uint8_t>& pictureRGBA) {
+                return frameSequence->getFrame(frameNum, pictureRGBA);
+            },
+            static_cast<int>(mTotalFrames), cacheAllFrames);
+    }
+    else {
+        rlottie::Animation* animation {mAnimation.get()};
+        mFrameBuffer.setAnimation(
+            [animation, width, height](int frameNum, std::vector<uint8_t>& pictureRGBA) {
+                pictureRGBA.resize(width * height * 4);
+                rlottie::Surface surface {reinterpret_cast<uint32_t*>(&pictureRGBA[0]), width,
+                                          height, width * sizeof(uint32_t)};
+                animation->renderSync(static_cast<size_t>(frameNum), surface, false);
+                return true;
+            },
+            static_cast<int>(mTotalFrames), cacheAllFrames);
+    }
+
+    if (frameSequence == nullptr && hash != "") {
+        // Render the animation into the disk cache in the background.
+        std::unique_ptr<LottieCache::SequenceWriter> writer {
+            LottieCache::getInstance().getSequenceWriter(hash, width, height, mTotalFrames)};
+        if (writer != nullptr) {
+            std::shared_ptr<DiskCacheWrite> write {std::make_shared<DiskCacheWrite>()};
+            write->animationData = animationData;
+            write->writer = std::move(writer);
+            write->width = width;
+            write->height = height;
+            queueDiskCacheJob(this, write);
+        }
+    }
+
     mDirection = mStartDirection;
 
     if (mDirection == "reverse")
@@ -238,12 +320,8 @@ void LottieAnimComponent::resetComponent()
     mDirection = mStartDirection;
     mFrameNum = mStartDirection == "reverse" ? mTotalFrames - 1 : 0;
 
-    if (mAnimation != nullptr) {
-        if (mFuture.valid())
-            mFuture.get();
-        mFuture = mAnimation->render(mFrameNum, *mSurface, false);
-        mLastRenderedFrame = static_cast<int>(mFrameNum);
-    }
+    if (mAnimation != nullptr)
+        mFrameBuffer.requestFrames(static_cast<int>(mFrameNum), mDirection == "reverse" ? -1 : 1);
 }
 
 void LottieAnimComponent::onSizeChanged()
@@ -449,6 +527,14 @@ void LottieAnimComponent::update(int deltaTime)
     }
 }
 
+bool LottieAnimComponent::isAnimating()
+{
+    if (mAnimation == nullptr || !isVisible() || mOpacity == 0.0f || mThemeOpacity == 0.0f)
+        return false;
+
+    return (!mPause && !mExternalPause) || GuiComponent::isAnimating();
+}
+
 void LottieAnimComponent::render(const glm::mat4& parentTrans)
 {
     if (mAnimation == nullptr || !isVisible() || mOpacity == 0.0f || mThemeOpacity == 0.0f)
@@ -458,6 +544,7 @@ void LottieAnimComponent::render(const glm::mat4& parentTrans)
 
     // This is necessary as there may otherwise be no texture to render when paused.
     if ((mExternalPause || mPause) && mTexture->getSize().x == 0.0f) {
+        mFrameBuffer.getFrame(static_cast<int>(mFrameNum), mPictureRGBA);
         mTexture->initFromPixels(&mPictureRGBA.at(0), static_cast<size_t>(mSize.x),
                                  static_cast<size_t>(mSize.y));
     }
@@ -512,26 +599,8 @@ void LottieAnimComponent::render(const glm::mat4& parentTrans)
                 mAnimationStartTime = std::chrono::system_clock::now();
         }
 
-        bool renderNextFrame {false};
-
-        if (mFuture.valid()) {
-            if (mFuture.wait_for(std::chrono::milliseconds(1)) == std::future_status::ready) {
-                mFuture.get();
-                // Cache frame if caching is enabled and we're not exceeding either the per-file
-                // max cache size or the total cache size. Note that this is completely unrelated
-                // to the texture caching used for images.
-                if (mCacheFrames && mLastRenderedFrame != -1 &&
-                    mFrameCache.find(mLastRenderedFrame) == mFrameCache.end()) {
-                    size_t newCacheSize {mCacheSize + mFrameSize};
-                    if (newCacheSize < mMaxCacheSize &&
-                        mTotalFrameCache + mFrameSize < mMaxTotalFrameCache) {
-                        mFrameCache[mLastRenderedFrame] = mPictureRGBA;
-                        mCacheSize += mFrameSize;
-                        mTotalFrameCache += mFrameSize;
-                        mLastRenderedFrame = -1;
-                    }
-                }
-
+        if (!mHoldFrame && !mExternalPause) {
+            if (mFrameBuffer.getFrame(static_cast<int>(mFrameNum), mPictureRGBA)) {
                 mTexture->initFromPixels(&mPictureRGBA.at(0), static_cast<size_t>(mSize.x),
                                          static_cast<size_t>(mSize.y));
 
@@ -539,36 +608,11 @@ void LottieAnimComponent::render(const glm::mat4& parentTrans)
                     --mFrameNum;
                 else
                     ++mFrameNum;
-
-                if (mDirection == "reverse" && mFrameNum == 0)
-                    renderNextFrame = false;
-                else if (mFrameNum == mTotalFrames)
-                    renderNextFrame = false;
-                else
-                    renderNextFrame = true;
-            }
-        }
-        else {
-            if (mFrameCache.find(mFrameNum) != mFrameCache.end()) {
-                if (!mHoldFrame) {
-                    mTexture->initFromPixels(&mFrameCache[mFrameNum][0],
-                                             static_cast<size_t>(mSize.x),
-                                             static_cast<size_t>(mSize.y));
-
-                    if (mDirection == "reverse")
-                        --mFrameNum;
-                    else
-                        ++mFrameNum;
-                }
             }
-            else {
-                renderNextFrame = true;
-            }
-        }
 
-        if (renderNextFrame && !mHoldFrame) {
-            mFuture = mAnimation->render(mFrameNum, *mSurface, false);
-            mLastRenderedFrame = static_cast<int>(mFrameNum);
+            // Make sure that the upcoming frames are getting rendered.
+            mFrameBuffer.requestFrames(static_cast<int>(mFrameNum),
+                                       mDirection == "reverse" ? -1 : 1);
         }
     }
 
@@ -14,6 +14,7 @@
 #ifndef ES_CORE_COMPONENTS_LOTTIE_ANIM_COMPONENT_H
 #define ES_CORE_COMPONENTS_LOTTIE_ANIM_COMPONENT_H
 
+#include "AnimationWorker.h"
 #include "GuiComponent.h"
 #include "renderers/Renderer.h"
 #include "resources/TextureResource.h"
@@ -22,8 +23,6 @@
 #include "rlottie.h"
 
 #include <chrono>
-#include <future>
-#include <unordered_map>
 
 class LottieAnimComponent : public GuiComponent
 {
@@ -48,6 +47,7 @@ public:
                             unsigned int properties) override;
 
     void update(int deltaTime) override;
+    bool isAnimating() override;
 
 private:
     void render(const glm::mat4& parentTrans) override;
@@ -56,7 +56,7 @@ private:
     glm::vec2 mTargetSize;
     std::shared_ptr<TextureResource> mTexture;
     std::vector<uint8_t> mPictureRGBA;
-    std::unordered_map<size_t, std::vector<uint8_t>> mFrameCache;
+    AnimationFrameBuffer mFrameBuffer;
     // Set a 1024 MiB total Lottie animation cache as default.
     static inline size_t mMaxTotalFrameCache {1024 * 1024 * 1024};
     static inline size_t mTotalFrameCache;
@@ -67,8 +67,6 @@ private:
 
     std::chrono::time_point<std::chrono::system_clock> mAnimationStartTime;
     std::unique_ptr<rlottie::Animation> mAnimation;
-    std::unique_ptr<rlottie::Surface> mSurface;
-    std::future<rlottie::Surface> mFuture;
     std::string mPath;
     std::string mStartDirection;
     std::string mDirection;
@@ -79,7 +77,6 @@ private:
     float mSpeedModifier;
     int mTargetPacing;
     int mTimeAccumulator;
-    int mLastRenderedFrame;
     int mSkippedFrames;
 
     bool mHoldFrame;
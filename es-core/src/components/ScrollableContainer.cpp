@@ -250,6 +250,19 @@ void ScrollableContainer::update(int deltaTime)
     GuiComponent::update(deltaTime);
 }
 
+bool ScrollableContainer::isAnimating()
+{
+    if (GuiComponent::isAnimating())
+        return true;
+
+    // Automatic scrolling only takes place if the contents don't fit within the container.
+    if (!isVisible() || !mUpdatedSize || mScrollDir == glm::vec2 {0.0f, 0.0f} ||
+        !mWindow->getAllowTextScrolling())
+        return false;
+
+    return std::round(mChildren.front()->getSize().y) > mAdjustedHeight;
+}
+
 void ScrollableContainer::render(const glm::mat4& parentTrans)
 {
     if (!isVisible() || mThemeOpacity == 0.0f || mChildren.front()->getValue() == "")
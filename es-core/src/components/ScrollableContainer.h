@@ -43,6 +43,7 @@ public:
 
     void update(int deltaTime) override;
     void render(const glm::mat4& parentTrans) override;
+    bool isAnimating() override;
 
 private:
     Renderer* mRenderer;
@@ -458,6 +458,16 @@ void TextComponent::update(int deltaTime)
     updateSelf(deltaTime);
 }
 
+bool TextComponent::isAnimating()
+{
+    // Horizontal scrolling only takes place if the text doesn't fit within the component.
+    if (mHorizontalScrolling && mTextCache != nullptr &&
+        mTextCache->metrics.size.x > mSize.x * mRelativeScale && mWindow->getAllowTextScrolling())
+        return true;
+
+    return GuiComponent::isAnimating();
+}
+
 void TextComponent::onTextChanged()
 {
     mTextCache.reset();
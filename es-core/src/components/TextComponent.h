@@ -129,6 +129,7 @@ public:
     }
 
     void update(int deltaTime) override;
+    bool isAnimating() override;
 
 protected:
     virtual void onTextChanged();
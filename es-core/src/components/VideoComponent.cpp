@@ -397,6 +397,14 @@ std::vector<HelpPrompt> VideoComponent::getHelpPrompts()
     return ret;
 }
 
+bool VideoComponent::isAnimating()
+{
+    if (mHasVideo && mIsPlaying && !mPaused && isVisible())
+        return true;
+
+    return GuiComponent::isAnimating();
+}
+
 void VideoComponent::update(int deltaTime)
 {
     if (mIterationCount != 0 && mPlayCount == mIterationCount)
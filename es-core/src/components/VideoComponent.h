@@ -72,6 +72,7 @@ public:
     std::vector<HelpPrompt> getHelpPrompts() override;
 
     void update(int deltaTime) override;
+    bool isAnimating() override;
 
     // Resize the video to be as large as possible but fit within a box of this size.
     // This can be set before or after a video is loaded.
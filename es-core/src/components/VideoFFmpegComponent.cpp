@@ -9,6 +9,7 @@
 #include "components/VideoFFmpegComponent.h"
 
 #include "AudioManager.h"
+#include "Profiler.h"
 #include "Settings.h"
 #include "Window.h"
 #include "resources/TextureResource.h"
@@ -290,6 +291,7 @@ void VideoFFmpegComponent::render(const glm::mat4& parentTrans)
 
             if (pictureSize > 0) {
                 // Build a texture for the video frame.
+                PROFILE_SCOPE("Video frame upload");
                 mTexture->initFromPixels(&tempPictureRGBA.at(0), pictureWidth, pictureHeight);
             }
         }
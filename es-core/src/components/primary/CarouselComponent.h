@@ -93,6 +93,7 @@ public:
 
     bool input(InputConfig* config, Input input) override;
     void update(int deltaTime) override;
+    bool isAnimating() override;
     void render(const glm::mat4& parentTrans) override;
     void applyTheme(const std::shared_ptr<ThemeData>& theme,
                     const std::string& view,
@@ -100,7 +101,11 @@ public:
                     unsigned int properties) override;
 
 private:
-    void onShowPrimary() override { mEntries.at(mCursor).data.item->resetComponent(); }
+    void onShowPrimary() override
+    {
+        materializeEntry(mCursor);
+        mEntries.at(mCursor).data.item->resetComponent();
+    }
     void onCursorChanged(const CursorState& state) override;
     void onScroll() override
     {
@@ -127,11 +132,22 @@ private:
     bool setCursor(const T& obj) override { return List::setCursor(obj); }
     bool remove(const T& obj) override { return List::remove(obj); }
     int size() const override { return List::size(); }
+    void setEntryNameFunction(const std::function<std::string(const T&)>& func) override
+    {
+        List::setEntryNameFunction(func);
+    }
 
     int getCursor() override { return mCursor; }
     const size_t getNumEntries() override { return mEntries.size(); }
     const bool getFadeAbovePrimary() const override { return mFadeAbovePrimary; }
 
+    void prefetchTextures(const int firstEntry, const int lastEntry);
+
+    // Creates the text item for entries with deferred names once they are displayed.
+    void materializeEntry(const int index);
+    std::shared_ptr<TextComponent> createTextItem(const std::string& name);
+    void setItemPosition(Entry& entry);
+
     enum class ImageFit {
         CONTAIN,
         FILL,
@@ -378,24 +394,53 @@ void CarouselComponent<T>::addEntry(Entry& entry, const std::shared_ptr<ThemeDat
     }
 
     if (!entry.data.item) {
+        // If the entry name is deferred then the text item is created when the entry is first
+        // displayed, which avoids creating text components for all games in large gamelists.
+        if (entry.deferredName) {
+            List::add(entry);
+            return;
+        }
         // Always add the item text as fallback in case there is no image. This is also displayed
         // when quick-jumping as textures are not loaded in this case.
-        auto text = std::make_shared<TextComponent>(
-            entry.name, mFont, 0x000000FF, mItemHorizontalAlignment, mItemVerticalAlignment,
-            glm::ivec2 {0, 0}, glm::vec3 {0.0f, 0.0f, 0.0f},
-            glm::round(mItemSize * (mItemScale >= 1.0f ? mItemScale : 1.0f)), 0x00000000,
-            mLineSpacing, mTextRelativeScale, mTextHorizontalScrolling, mTextHorizontalScrollSpeed,
-            mTextHorizontalScrollDelay, mTextHorizontalScrollGap);
-        if (!mGamelistView)
-            text->setValue(entry.name);
-        text->setBackgroundCornerRadius(mTextBackgroundCornerRadius);
-        text->setColor(mTextColor);
-        text->setBackgroundColor(mTextBackgroundColor);
-        text->setRenderBackground(true);
-
-        entry.data.item = text;
+        entry.data.item = createTextItem(entry.name);
     }
 
+    setItemPosition(entry);
+    List::add(entry);
+}
+
+template <typename T> void CarouselComponent<T>::materializeEntry(const int index)
+{
+    Entry& entry {mEntries.at(index)};
+
+    if (entry.data.item != nullptr)
+        return;
+
+    entry.data.item = createTextItem(List::getEntryName(index));
+    setItemPosition(entry);
+}
+
+template <typename T>
+std::shared_ptr<TextComponent> CarouselComponent<T>::createTextItem(const std::string& name)
+{
+    auto text = std::make_shared<TextComponent>(
+        name, mFont, 0x000000FF, mItemHorizontalAlignment, mItemVerticalAlignment,
+        glm::ivec2 {0, 0}, glm::vec3 {0.0f, 0.0f, 0.0f},
+        glm::round(mItemSize * (mItemScale >= 1.0f ? mItemScale : 1.0f)), 0x00000000,
+        mLineSpacing, mTextRelativeScale, mTextHorizontalScrolling, mTextHorizontalScrollSpeed,
+        mTextHorizontalScrollDelay, mTextHorizontalScrollGap);
+    if (!mGamelistView)
+        text->setValue(name);
+    text->setBackgroundCornerRadius(mTextBackgroundCornerRadius);
+    text->setColor(mTextColor);
+    text->setBackgroundColor(mTextBackgroundColor);
+    text->setRenderBackground(true);
+
+    return text;
+}
+
+template <typename T> void CarouselComponent<T>::setItemPosition(Entry& entry)
+{
     // Set origin for the items based on their alignment so they line up properly.
     if (mItemHorizontalAlignment == ALIGN_LEFT)
         entry.data.item->setOrigin(0.0f, 0.5f);
@@ -413,8 +458,6 @@ void CarouselComponent<T>::addEntry(Entry& entry, const std::shared_ptr<ThemeDat
 
     glm::vec2 denormalized {glm::round(mItemSize * entry.data.item->getOrigin())};
     entry.data.item->setPosition(glm::vec3 {denormalized.x, denormalized.y, 0.0f});
-
-    List::add(entry);
 }
 
 template <typename T>
@@ -453,23 +496,7 @@ void CarouselComponent<T>::updateEntry(Entry& entry, const std::shared_ptr<Theme
         return;
     }
 
-    // Set origin for the items based on their alignment so they line up properly.
-    if (mItemHorizontalAlignment == ALIGN_LEFT)
-        entry.data.item->setOrigin(0.0f, 0.5f);
-    else if (mItemHorizontalAlignment == ALIGN_RIGHT)
-        entry.data.item->setOrigin(1.0f, 0.5f);
-    else
-        entry.data.item->setOrigin(0.5f, 0.5f);
-
-    if (mItemVerticalAlignment == ALIGN_TOP)
-        entry.data.item->setOrigin(entry.data.item->getOrigin().x, 0.0f);
-    else if (mItemVerticalAlignment == ALIGN_BOTTOM)
-        entry.data.item->setOrigin(entry.data.item->getOrigin().x, 1.0f);
-    else
-        entry.data.item->setOrigin(entry.data.item->getOrigin().x, 0.5f);
-
-    glm::vec2 denormalized {glm::round(mItemSize * entry.data.item->getOrigin())};
-    entry.data.item->setPosition(glm::vec3 {denormalized.x, denormalized.y, 0.0f});
+    setItemPosition(entry);
 }
 
 template <typename T> void CarouselComponent<T>::onDemandTextureLoad()
@@ -544,32 +571,7 @@ template <typename T> void CarouselComponent<T>::onDemandTextureLoad()
 
             if (entry.data.imagePath == "") {
                 FileData* game {entry.object};
-
-                for (auto& imageType : mImageTypes) {
-                    if (imageType == "marquee")
-                        entry.data.imagePath = game->getMarqueePath();
-                    else if (imageType == "cover")
-                        entry.data.imagePath = game->getCoverPath();
-                    else if (imageType == "backcover")
-                        entry.data.imagePath = game->getBackCoverPath();
-                    else if (imageType == "3dbox")
-                        entry.data.imagePath = game->get3DBoxPath();
-                    else if (imageType == "physicalmedia")
-                        entry.data.imagePath = game->getPhysicalMediaPath();
-                    else if (imageType == "screenshot")
-                        entry.data.imagePath = game->getScreenshotPath();
-                    else if (imageType == "titlescreen")
-                        entry.data.imagePath = game->getTitleScreenPath();
-                    else if (imageType == "miximage")
-                        entry.data.imagePath = game->getMiximagePath();
-                    else if (imageType == "fanart")
-                        entry.data.imagePath = game->getFanArtPath();
-                    else if (imageType == "none") // Display the game name as text.
-                        break;
-
-                    if (entry.data.imagePath != "")
-                        break;
-                }
+                entry.data.imagePath = PrimaryComponent<T>::getImagePath(game, mImageTypes);
 
                 if (entry.data.imagePath == "")
                     entry.data.imagePath = entry.data.defaultImagePath;
@@ -578,9 +580,25 @@ template <typename T> void CarouselComponent<T>::onDemandTextureLoad()
                 updateEntry(entry, theme);
             }
         }
+
+        prefetchTextures(center - itemInclusion - itemInclusionBefore,
+                         center + itemInclusion + itemInclusionAfter);
     }
 }
 
+template <typename T>
+void CarouselComponent<T>::prefetchTextures(const int firstEntry, const int lastEntry)
+{
+    PrimaryComponent<T>::prefetchTextures(
+        firstEntry, lastEntry, size(), List::isScrolling() ? (mScrollVelocity > 0 ? 1 : -1) : 0,
+        List::mScrollTier, true, [this](const int cursor) -> std::string {
+            const auto& entry = mEntries.at(cursor);
+            if (entry.data.imagePath != "")
+                return "";
+            return PrimaryComponent<T>::getImagePath(entry.object, mImageTypes);
+        });
+}
+
 template <typename T> bool CarouselComponent<T>::input(InputConfig* config, Input input)
 {
     if (input.value != 0) {
@@ -689,11 +707,22 @@ template <typename T> bool CarouselComponent<T>::input(InputConfig* config, Inpu
 
 template <typename T> void CarouselComponent<T>::update(int deltaTime)
 {
+    materializeEntry(mCursor);
     mEntries.at(mCursor).data.item->update(deltaTime);
     List::listUpdate(deltaTime);
     GuiComponent::update(deltaTime);
 }
 
+template <typename T> bool CarouselComponent<T>::isAnimating()
+{
+    if (List::isScrolling() || List::mTitleOverlayOpacity > 0.0f || GuiComponent::isAnimating())
+        return true;
+
+    // Only the selected entry is updated so that's the only one that can be animating.
+    return !mEntries.empty() && mEntries.at(mCursor).data.item != nullptr &&
+           mEntries.at(mCursor).data.item->isAnimating();
+}
+
 template <typename T> void CarouselComponent<T>::render(const glm::mat4& parentTrans)
 {
     const float camOffset {mInstantItemTransitions ? mEntryCamTarget : mEntryCamOffset};
@@ -1066,6 +1095,7 @@ template <typename T> void CarouselComponent<T>::render(const glm::mat4& parentT
     }
 
     for (auto& renderItem : renderItemsSorted) {
+        materializeEntry(renderItem.index);
         const std::shared_ptr<GuiComponent>& comp {mEntries.at(renderItem.index).data.item};
 
         if (comp == nullptr)
@@ -1852,7 +1882,8 @@ void CarouselComponent<T>::applyTheme(const std::shared_ptr<ThemeData>& theme,
 
 template <typename T> void CarouselComponent<T>::onCursorChanged(const CursorState& state)
 {
-    if (mEntries.size() > static_cast<size_t>(mLastCursor))
+    if (mEntries.size() > static_cast<size_t>(mLastCursor) &&
+        mEntries.at(mLastCursor).data.item != nullptr)
         mEntries.at(mLastCursor).data.item->resetComponent();
 
     float startPos {mEntryCamOffset};
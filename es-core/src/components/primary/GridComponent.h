@@ -77,6 +77,7 @@ public:
     void setDefaultFolderImage(std::string defaultImage) { mDefaultFolderImagePath = defaultImage; }
     bool input(InputConfig* config, Input input) override;
     void update(int deltaTime) override;
+    bool isAnimating() override;
     void render(const glm::mat4& parentTrans) override;
     void applyTheme(const std::shared_ptr<ThemeData>& theme,
                     const std::string& view,
@@ -84,7 +85,11 @@ public:
                     unsigned int properties) override;
 
 private:
-    void onShowPrimary() override { mEntries.at(mCursor).data.item->resetComponent(); }
+    void onShowPrimary() override
+    {
+        materializeEntry(mCursor);
+        mEntries.at(mCursor).data.item->resetComponent();
+    }
     void onScroll() override
     {
         if (mGamelistView)
@@ -115,6 +120,16 @@ private:
     }
     bool remove(const T& obj) override { return List::remove(obj); }
     int size() const override { return List::size(); }
+    void setEntryNameFunction(const std::function<std::string(const T&)>& func) override
+    {
+        List::setEntryNameFunction(func);
+    }
+
+    void prefetchTextures(const int firstEntry, const int lastEntry);
+
+    // Creates the text item for entries with deferred names once they are displayed.
+    void materializeEntry(const int index);
+    std::shared_ptr<TextComponent> createTextItem(const std::string& name);
 
     enum class ImageFit {
         CONTAIN,
@@ -382,26 +397,54 @@ void GridComponent<T>::addEntry(Entry& entry, const std::shared_ptr<ThemeData>&
         entry.data.imagePath = "";
     }
 
-    if (!entry.data.item) {
-        // Always add the item text as fallback in case there is no image. This is also displayed
-        // when quick-jumping as textures are not loaded in this case.
-        auto text = std::make_shared<TextComponent>(
-            entry.name, mFont, 0x000000FF, Alignment::ALIGN_CENTER, Alignment::ALIGN_CENTER,
-            glm::ivec2 {0, 0}, glm::vec3 {0.0f, 0.0f, 0.0f}, mItemSize * mTextRelativeScale,
-            0x00000000, mLineSpacing, 1.0f, mTextHorizontalScrolling, mTextHorizontalScrollSpeed,
-            mTextHorizontalScrollDelay, mTextHorizontalScrollGap);
-        text->setOrigin(0.5f, 0.5f);
-        text->setBackgroundCornerRadius(mTextBackgroundCornerRadius);
-        text->setColor(mTextColor);
-        text->setBackgroundColor(mTextBackgroundColor);
-        text->setRenderBackground(true);
-
-        entry.data.item = text;
-    }
+    // If the entry name is deferred then the text item is created when the entry is first
+    // displayed, which avoids creating text components for all games in large gamelists.
+    // Otherwise always add the item text as fallback in case there is no image. This is also
+    // displayed when quick-jumping as textures are not loaded in this case.
+    if (!entry.data.item && !entry.deferredName)
+        entry.data.item = createTextItem(entry.name);
 
     List::add(entry);
 }
 
+template <typename T> void GridComponent<T>::materializeEntry(const int index)
+{
+    Entry& entry {mEntries.at(index)};
+
+    if (entry.data.item != nullptr)
+        return;
+
+    entry.data.item = createTextItem(List::getEntryName(index));
+
+    // If the layout has not been calculated yet then the position is set by calculateLayout().
+    if (mLayoutValid) {
+        const int column {index % mColumns};
+        const int row {index / mColumns};
+        entry.data.item->setPosition(glm::vec3 {
+            mHorizontalMargin + (mItemSize.x * column) + (mItemSize.x * 0.5f) +
+                mItemSpacing.x * column,
+            mVerticalMargin + (mItemSize.y * row) + (mItemSize.y * 0.5f) + mItemSpacing.y * row,
+            0.0f});
+    }
+}
+
+template <typename T>
+std::shared_ptr<TextComponent> GridComponent<T>::createTextItem(const std::string& name)
+{
+    auto text = std::make_shared<TextComponent>(
+        name, mFont, 0x000000FF, Alignment::ALIGN_CENTER, Alignment::ALIGN_CENTER,
+        glm::ivec2 {0, 0}, glm::vec3 {0.0f, 0.0f, 0.0f}, mItemSize * mTextRelativeScale,
+        0x00000000, mLineSpacing, 1.0f, mTextHorizontalScrolling, mTextHorizontalScrollSpeed,
+        mTextHorizontalScrollDelay, mTextHorizontalScrollGap);
+    text->setOrigin(0.5f, 0.5f);
+    text->setBackgroundCornerRadius(mTextBackgroundCornerRadius);
+    text->setColor(mTextColor);
+    text->setBackgroundColor(mTextBackgroundColor);
+    text->setRenderBackground(true);
+
+    return text;
+}
+
 template <typename T>
 void GridComponent<T>::updateEntry(Entry& entry, const std::shared_ptr<ThemeData>& theme)
 {
@@ -486,36 +529,13 @@ template <typename T> void GridComponent<T>::onDemandTextureLoad()
             while (cursor >= numEntries)
                 cursor -= numEntries;
 
+            // The image item takes its position from the text item.
+            materializeEntry(cursor);
             auto& entry = mEntries.at(cursor);
 
             if (entry.data.imagePath == "") {
                 FileData* game {entry.object};
-
-                for (auto& imageType : mImageTypes) {
-                    if (imageType == "marquee")
-                        entry.data.imagePath = game->getMarqueePath();
-                    else if (imageType == "cover")
-                        entry.data.imagePath = game->getCoverPath();
-                    else if (imageType == "backcover")
-                        entry.data.imagePath = game->getBackCoverPath();
-                    else if (imageType == "3dbox")
-                        entry.data.imagePath = game->get3DBoxPath();
-                    else if (imageType == "physicalmedia")
-                        entry.data.imagePath = game->getPhysicalMediaPath();
-                    else if (imageType == "screenshot")
-                        entry.data.imagePath = game->getScreenshotPath();
-                    else if (imageType == "titlescreen")
-                        entry.data.imagePath = game->getTitleScreenPath();
-                    else if (imageType == "miximage")
-                        entry.data.imagePath = game->getMiximagePath();
-                    else if (imageType == "fanart")
-                        entry.data.imagePath = game->getFanArtPath();
-                    else if (imageType == "none") // Display the game name as text.
-                        break;
-
-                    if (entry.data.imagePath != "")
-                        break;
-                }
+                entry.data.imagePath = PrimaryComponent<T>::getImagePath(game, mImageTypes);
 
                 if (entry.data.imagePath == "")
                     entry.data.imagePath = entry.data.defaultImagePath;
@@ -524,9 +544,24 @@ template <typename T> void GridComponent<T>::onDemandTextureLoad()
                 updateEntry(entry, theme);
             }
         }
+
+        prefetchTextures(startPos, std::min(startPos + loadItems, numEntries));
     }
 }
 
+template <typename T>
+void GridComponent<T>::prefetchTextures(const int firstEntry, const int lastEntry)
+{
+    PrimaryComponent<T>::prefetchTextures(
+        firstEntry, lastEntry, size(), List::isScrolling() ? (mScrollVelocity > 0 ? 1 : -1) : 0,
+        List::mScrollTier, false, [this](const int cursor) -> std::string {
+            const auto& entry = mEntries.at(cursor);
+            if (entry.data.imagePath != "")
+                return "";
+            return PrimaryComponent<T>::getImagePath(entry.object, mImageTypes);
+        });
+}
+
 template <typename T> void GridComponent<T>::calculateLayout()
 {
     assert(!mEntries.empty());
@@ -561,11 +596,15 @@ template <typename T> void GridComponent<T>::calculateLayout()
         ++mColumns;
 
     for (auto& entry : mEntries) {
-        entry.data.item->setPosition(glm::vec3 {
-            mHorizontalMargin + (mItemSize.x * columnCount) + (mItemSize.x * 0.5f) +
-                mItemSpacing.x * columnCount,
-            mVerticalMargin + (mItemSize.y * mRows) + (mItemSize.y * 0.5f) + mItemSpacing.y * mRows,
-            0.0f});
+        // Entries with deferred names get their positions when their items are created.
+        if (entry.data.item != nullptr) {
+            entry.data.item->setPosition(glm::vec3 {
+                mHorizontalMargin + (mItemSize.x * columnCount) + (mItemSize.x * 0.5f) +
+                    mItemSpacing.x * columnCount,
+                mVerticalMargin + (mItemSize.y * mRows) + (mItemSize.y * 0.5f) +
+                    mItemSpacing.y * mRows,
+                0.0f});
+        }
         if (columnCount == mColumns - 1) {
             ++mRows;
             columnCount = 0;
@@ -654,11 +693,22 @@ template <typename T> bool GridComponent<T>::input(InputConfig* config, Input in
 
 template <typename T> void GridComponent<T>::update(int deltaTime)
 {
+    materializeEntry(mCursor);
     mEntries.at(mCursor).data.item->update(deltaTime);
     List::listUpdate(deltaTime);
     GuiComponent::update(deltaTime);
 }
 
+template <typename T> bool GridComponent<T>::isAnimating()
+{
+    if (List::isScrolling() || List::mTitleOverlayOpacity > 0.0f || GuiComponent::isAnimating())
+        return true;
+
+    // Only the selected entry is updated so that's the only one that can be animating.
+    return !mEntries.empty() && mEntries.at(mCursor).data.item != nullptr &&
+           mEntries.at(mCursor).data.item->isAnimating();
+}
+
 template <typename T> void GridComponent<T>::render(const glm::mat4& parentTrans)
 {
     if (mEntries.empty())
@@ -794,6 +844,8 @@ template <typename T> void GridComponent<T>::render(const glm::mat4& parentTrans
         float metadataOpacity {1.0f};
         bool cursorEntry {false};
 
+        materializeEntry(static_cast<int>(*it));
+
         if constexpr (std::is_same_v<T, FileData*>) {
             // If a game is marked as hidden, lower the opacity a lot.
             // If a game is marked to not be counted, lower the opacity a moderate amount.
@@ -1531,7 +1583,8 @@ void GridComponent<T>::applyTheme(const std::shared_ptr<ThemeData>& theme,
 
 template <typename T> void GridComponent<T>::onCursorChanged(const CursorState& state)
 {
-    if (mEntries.size() > static_cast<size_t>(mLastCursor))
+    if (mEntries.size() > static_cast<size_t>(mLastCursor) &&
+        mEntries.at(mLastCursor).data.item != nullptr)
         mEntries.at(mLastCursor).data.item->resetComponent();
 
     if (mColumns == 0)
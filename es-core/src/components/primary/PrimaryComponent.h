@@ -9,6 +9,11 @@
 #ifndef ES_CORE_COMPONENTS_PRIMARY_PRIMARY_COMPONENT_H
 #define ES_CORE_COMPONENTS_PRIMARY_PRIMARY_COMPONENT_H
 
+#include "resources/TextureResource.h"
+
+#include <functional>
+#include <set>
+
 template <typename T> class PrimaryComponent : public virtual GuiComponent
 {
 public:
@@ -37,6 +42,7 @@ public:
     virtual bool setCursor(const T& obj) = 0;
     virtual bool remove(const T& obj) = 0;
     virtual int size() const = 0;
+    virtual void setEntryNameFunction(const std::function<std::string(const T&)>& func) = 0;
 
     // Functions used by all primary components.
     virtual void onShowPrimary() = 0;
@@ -54,6 +60,115 @@ public:
     // Functions used by some primary components.
     virtual void onDemandTextureLoad() {}
     virtual void setAlignment(PrimaryAlignment align) {}
+
+protected:
+    PrimaryComponent()
+        : mPrefetchDirection {0}
+    {
+    }
+
+    // Returns the path to the first available image of the configured image types.
+    static std::string getImagePath(const T& game, const std::vector<std::string>& imageTypes);
+
+    // Used by the carousel and grid to prefetch the images for the entries ahead of the loaded
+    // range. The entryImagePath function should return an empty string for loaded entries.
+    void prefetchTextures(const int firstEntry,
+                          const int lastEntry,
+                          const int numEntries,
+                          const int direction,
+                          const int scrollTier,
+                          const bool wrapAround,
+                          const std::function<std::string(const int)>& entryImagePath);
+
+private:
+    int mPrefetchDirection;
+    std::set<int> mPrefetchedEntries;
 };
 
+template <typename T>
+std::string PrimaryComponent<T>::getImagePath(const T& game,
+                                              const std::vector<std::string>& imageTypes)
+{
+    for (auto& imageType : imageTypes) {
+        std::string imagePath;
+
+        if (imageType == "marquee")
+            imagePath = game->getMarqueePath();
+        else if (imageType == "cover")
+            imagePath = game->getCoverPath();
+        else if (imageType == "backcover")
+            imagePath = game->getBackCoverPath();
+        else if (imageType == "3dbox")
+            imagePath = game->get3DBoxPath();
+        else if (imageType == "physicalmedia")
+            imagePath = game->getPhysicalMediaPath();
+        else if (imageType == "screenshot")
+            imagePath = game->getScreenshotPath();
+        else if (imageType == "titlescreen")
+            imagePath = game->getTitleScreenPath();
+        else if (imageType == "miximage")
+            imagePath = game->getMiximagePath();
+        else if (imageType == "fanart")
+            imagePath = game->getFanArtPath();
+        else if (imageType == "none") // Display the game name as text.
+            break;
+
+        if (imagePath != "")
+            return imagePath;
+    }
+
+    return "";
+}
+
+template <typename T>
+void PrimaryComponent<T>::prefetchTextures(
+    const int firstEntry,
+    const int lastEntry,
+    const int numEntries,
+    const int direction,
+    const int scrollTier,
+    const bool wrapAround,
+    const std::function<std::string(const int)>& entryImagePath)
+{
+    // While scrolling, the images for the entries ahead of the loaded range are decoded in the
+    // background. The faster the scrolling the more pages ahead are prefetched, and the pending
+    // prefetches are cancelled if the scrolling direction changes or if scrolling stops.
+    if (direction != mPrefetchDirection) {
+        if (mPrefetchDirection != 0)
+            TextureResource::cancelPrefetch();
+        mPrefetchDirection = direction;
+        mPrefetchedEntries.clear();
+    }
+
+    if (direction == 0)
+        return;
+
+    const int pageSize {lastEntry - firstEntry};
+    const int prefetchEntries {std::min(pageSize * (scrollTier + 1), numEntries - pageSize)};
+    std::vector<std::string> paths;
+
+    for (int i {0}; i < prefetchEntries; ++i) {
+        int cursor {direction == 1 ? lastEntry + i : firstEntry - 1 - i};
+        if (wrapAround) {
+            while (cursor < 0)
+                cursor += numEntries;
+            while (cursor >= numEntries)
+                cursor -= numEntries;
+        }
+        else if (cursor < 0 || cursor >= numEntries) {
+            break;
+        }
+
+        if (!mPrefetchedEntries.insert(cursor).second)
+            continue;
+
+        const std::string imagePath {entryImagePath(cursor)};
+        if (imagePath != "")
+            paths.emplace_back(imagePath);
+    }
+
+    if (!paths.empty())
+        TextureResource::prefetch(paths);
+}
+
 #endif // ES_CORE_COMPONENTS_PRIMARY_PRIMARY_COMPONENT_H
@@ -50,6 +50,7 @@ public:
 
     bool input(InputConfig* config, Input input) override;
     void update(int deltaTime) override;
+    bool isAnimating() override;
     void render(const glm::mat4& parentTrans) override;
     void applyTheme(const std::shared_ptr<ThemeData>& theme,
                     const std::string& view,
@@ -85,7 +86,11 @@ public:
     }
 
 private:
-    void onShowPrimary() override { mEntries.at(mCursor).data.entryName->resetComponent(); }
+    void onShowPrimary() override
+    {
+        if (mEntries.at(mCursor).data.entryName != nullptr)
+            mEntries.at(mCursor).data.entryName->resetComponent();
+    }
     void onScroll() override
     {
         if (mGamelistView &&
@@ -101,26 +106,40 @@ private:
     bool isScrolling() const override { return List::isScrolling(); }
     void stopScrolling() override { List::stopScrolling(); }
     const int getScrollingVelocity() override { return List::getScrollingVelocity(); }
-    void clear() override { List::clear(); }
+    void clear() override
+    {
+        List::clear();
+        mMaterializedEntries.clear();
+    }
     const T& getSelected() const override { return List::getSelected(); }
     const T& getNext() const override { return List::getNext(); }
     const T& getPrevious() const override { return List::getPrevious(); }
     const T& getFirst() const override { return List::getFirst(); }
     const T& getLast() const override { return List::getLast(); }
     bool setCursor(const T& obj) override { return List::setCursor(obj); }
-    bool remove(const T& obj) override { return List::remove(obj); }
+    bool remove(const T& obj) override;
     int size() const override { return List::size(); }
+    void setEntryNameFunction(const std::function<std::string(const T&)>& func) override
+    {
+        List::setEntryNameFunction(func);
+    }
 
     int getCursor() override { return mCursor; }
     const size_t getNumEntries() override { return mEntries.size(); }
     const bool getFadeAbovePrimary() const override { return mFadeAbovePrimary; }
 
+    // The text components are only created for the entries that are actually displayed, and
+    // they are released again when they have been scrolled well out of view.
+    void materializeEntry(const int index);
+    void releaseEntries(const int startEntry, const int endEntry);
+
     Renderer* mRenderer;
     std::function<void()> mCancelTransitionsCallback;
     std::function<void(CursorState state)> mCursorChangedCallback;
     float mCamOffset;
     int mPreviousScrollVelocity;
     bool mGamelistView;
+    std::vector<int> mMaterializedEntries;
 
     std::shared_ptr<Font> mFont;
     float mSelectorWidth;
@@ -201,14 +220,55 @@ TextListComponent<T>::TextListComponent()
 template <typename T>
 void TextListComponent<T>::addEntry(Entry& entry, const std::shared_ptr<ThemeData>& theme)
 {
+    List::add(entry);
+}
+
+template <typename T> bool TextListComponent<T>::remove(const T& obj)
+{
+    for (auto it = mEntries.cbegin(); it != mEntries.cend(); ++it) {
+        if ((*it).object != obj)
+            continue;
+
+        const int index {static_cast<int>(it - mEntries.cbegin())};
+        List::remove(it);
+
+        // The materialized entries are tracked by index so the entries after the removed
+        // entry need to be shifted, otherwise the wrong text components would get released.
+        for (auto entryIt = mMaterializedEntries.begin();
+             entryIt != mMaterializedEntries.end();) {
+            if (*entryIt == index) {
+                entryIt = mMaterializedEntries.erase(entryIt);
+            }
+            else {
+                if (*entryIt > index)
+                    --(*entryIt);
+                ++entryIt;
+            }
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+template <typename T> void TextListComponent<T>::materializeEntry(const int index)
+{
+    Entry& entry {mEntries.at(index)};
+
+    if (entry.data.entryName != nullptr)
+        return;
+
+    const std::string& name {List::getEntryName(index)};
+
     if (mHorizontalScrolling) {
         entry.data.entryName = std::make_shared<TextComponent>(
-            entry.name, mFont, 0x000000FF, ALIGN_LEFT, ALIGN_CENTER, glm::ivec2 {1, 0},
+            name, mFont, 0x000000FF, ALIGN_LEFT, ALIGN_CENTER, glm::ivec2 {1, 0},
             glm::vec3 {0.0f, 0.0f, 0.0f}, glm::vec2 {0.0f, mFont->getSize() * 1.5f});
     }
     else {
         entry.data.entryName = std::make_shared<TextComponent>(
-            entry.name, mFont, 0x000000FF, ALIGN_LEFT, ALIGN_CENTER, glm::ivec2 {1, 0},
+            name, mFont, 0x000000FF, ALIGN_LEFT, ALIGN_CENTER, glm::ivec2 {1, 0},
             glm::vec3 {0.0f, 0.0f, 0.0f}, glm::vec2 {0.0f, mFont->getSize() * 1.5f}, 0x00000000,
             1.5f, 1.0f, false, 1.0f, 1500.0f, 1.5f, mSize.x - (mHorizontalMargin * 2.0f));
     }
@@ -226,7 +286,28 @@ void TextListComponent<T>::addEntry(Entry& entry, const std::shared_ptr<ThemeDat
         }
     }
 
-    List::add(entry);
+    mMaterializedEntries.emplace_back(index);
+}
+
+template <typename T>
+void TextListComponent<T>::releaseEntries(const int startEntry, const int endEntry)
+{
+    // A margin of one screen is kept in each direction so that regular scrolling doesn't
+    // continuously recreate the text components.
+    for (auto it = mMaterializedEntries.begin(); it != mMaterializedEntries.end();) {
+        const int index {*it};
+        if (index >= size()) {
+            it = mMaterializedEntries.erase(it);
+        }
+        else if ((index < startEntry || index >= endEntry) && index != mCursor &&
+                 index != mLastCursor) {
+            mEntries.at(index).data.entryName.reset();
+            it = mMaterializedEntries.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
 }
 
 template <typename T> bool TextListComponent<T>::input(InputConfig* config, Input input)
@@ -294,11 +375,22 @@ template <typename T> bool TextListComponent<T>::input(InputConfig* config, Inpu
 
 template <typename T> void TextListComponent<T>::update(int deltaTime)
 {
+    materializeEntry(mCursor);
     mEntries.at(mCursor).data.entryName->update(deltaTime);
     List::listUpdate(deltaTime);
     GuiComponent::update(deltaTime);
 }
 
+template <typename T> bool TextListComponent<T>::isAnimating()
+{
+    if (List::isScrolling() || List::mTitleOverlayOpacity > 0.0f || GuiComponent::isAnimating())
+        return true;
+
+    // Only the selected entry is updated so that's the only one that can be animating.
+    return !mEntries.empty() && mEntries.at(mCursor).data.entryName != nullptr &&
+           mEntries.at(mCursor).data.entryName->isAnimating();
+}
+
 template <typename T> void TextListComponent<T>::render(const glm::mat4& parentTrans)
 {
     if (size() == 0)
@@ -330,6 +422,8 @@ template <typename T> void TextListComponent<T>::render(const glm::mat4& parentT
     if (listCutoff > size())
         listCutoff = size();
 
+    releaseEntries(startEntry - screenCount, listCutoff + screenCount);
+
     // Draw selector bar.
     if (startEntry < listCutoff) {
         if (mSelectorImage.hasImage()) {
@@ -375,6 +469,7 @@ template <typename T> void TextListComponent<T>::render(const glm::mat4& parentT
                     static_cast<int>(std::round(dim.y))});
 
     for (int i {startEntry}; i < listCutoff; ++i) {
+        materializeEntry(i);
         Entry& entry {mEntries.at(i)};
         unsigned int color {0x00000000};
         unsigned int backgroundColor {0x00000000};
@@ -751,7 +846,8 @@ void TextListComponent<T>::applyTheme(const std::shared_ptr<ThemeData>& theme,
 
 template <typename T> void TextListComponent<T>::onCursorChanged(const CursorState& state)
 {
-    if (mEntries.size() > static_cast<size_t>(mLastCursor))
+    if (mEntries.size() > static_cast<size_t>(mLastCursor) &&
+        mEntries.at(mLastCursor).data.entryName != nullptr)
         mEntries.at(mLastCursor).data.entryName->resetComponent();
 
     if constexpr (std::is_same_v<T, SystemData*>) {
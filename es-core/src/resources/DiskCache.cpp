@@ -0,0 +1,116 @@
+//  SPDX-License-Identifier: MIT
+//
+//  ES-DE Frontend
+//  DiskCache.cpp
+//
+//  Size-limited directory of cache files, used by the SVG and Lottie caches.
+//  Files are written atomically via temporary files, and when the total size grows beyond
+//  the limit the least recently written files are removed.
+//
+
+#include "resources/DiskCache.h"
+
+#include "Log.h"
+#include "utils/FileSystemUtil.h"
+#include "utils/StringUtil.h"
+
+#include <algorithm>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+DiskCache::DiskCache(const std::string& directory, const size_t maxSize)
+    : mDirectory {directory}
+    , mMaxSize {maxSize}
+    , mSize {0}
+    , mDirectoryCreated {false}
+    , mDirectoryFailed {false}
+{
+    for (auto& file : Utils::FileSystem::getDirContent(mDirectory))
+        mSize += static_cast<size_t>(std::max(0L, Utils::FileSystem::getFileSize(file)));
+
+    mDirectoryCreated = Utils::FileSystem::exists(mDirectory);
+}
+
+bool DiskCache::createDirectory()
+{
+    std::unique_lock<std::mutex> lock {mMutex};
+
+    if (!mDirectoryCreated) {
+        if (!Utils::FileSystem::createDirectory(mDirectory)) {
+            LOG(LogWarning) << "DiskCache: Couldn't create cache directory \"" << mDirectory
+                            << "\"";
+            // Don't try again, the files will simply not be cached.
+            mDirectoryFailed = true;
+        }
+        mDirectoryCreated = true;
+    }
+
+    return !mDirectoryFailed;
+}
+
+bool DiskCache::writeFile(const std::string& path,
+                          const std::function<void(std::ostream& stream)>& writeFunction)
+{
+    if (!createDirectory())
+        return false;
+
+    const std::string tempPath {
+        path + "." + std::to_string(std::hash<std::thread::id> {}(std::this_thread::get_id())) +
+        ".tmp"};
+    std::streamoff fileSize {0};
+
+    {
+#if defined(_WIN64)
+        std::ofstream stream {Utils::String::stringToWideString(tempPath).c_str(),
+                              std::ios::binary | std::ios::trunc};
+#else
+        std::ofstream stream {tempPath, std::ios::binary | std::ios::trunc};
+#endif
+        writeFunction(stream);
+        fileSize = stream.tellp();
+        stream.close();
+
+        if (stream.fail()) {
+            Utils::FileSystem::removeFile(tempPath);
+            return false;
+        }
+    }
+
+    // Note that renameFile() returns true on failure.
+    if (Utils::FileSystem::renameFile(tempPath, path, true)) {
+        Utils::FileSystem::removeFile(tempPath);
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock {mMutex};
+    mSize += static_cast<size_t>(std::max(static_cast<std::streamoff>(0), fileSize));
+    if (mSize > mMaxSize)
+        pruneFiles();
+
+    return true;
+}
+
+void DiskCache::pruneFiles()
+{
+    // Remove the least recently written files until the cache is down to three quarters of
+    // the maximum size.
+    std::vector<std::pair<std::filesystem::file_time_type, std::string>> files;
+    for (auto& file : Utils::FileSystem::getDirContent(mDirectory))
+        files.emplace_back(Utils::FileSystem::getLastWriteTime(file), file);
+
+    std::sort(files.begin(), files.end());
+
+    for (auto& file : files) {
+        if (mSize <= mMaxSize / 4 * 3)
+            break;
+        // Files that are memory mapped can't be removed on Windows, these are simply skipped.
+        const long fileSize {Utils::FileSystem::getFileSize(file.second)};
+        if (!Utils::FileSystem::removeFile(file.second))
+            continue;
+        mSize -= std::min(mSize, static_cast<size_t>(std::max(0L, fileSize)));
+    }
+
+    LOG(LogDebug) << "DiskCache::pruneFiles(): Size of \"" << mDirectory << "\" is now "
+                  << mSize / 1024 / 1024 << " MiB";
+}
@@ -0,0 +1,49 @@
+//  SPDX-License-Identifier: MIT
+//
+//  ES-DE Frontend
+//  DiskCache.h
+//
+//  Size-limited directory of cache files, used by the SVG and Lottie caches.
+//  Files are written atomically via temporary files, and when the total size grows beyond
+//  the limit the least recently written files are removed.
+//
+
+#ifndef ES_CORE_RESOURCES_DISK_CACHE_H
+#define ES_CORE_RESOURCES_DISK_CACHE_H
+
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+class DiskCache
+{
+public:
+    // The directory is created on the first write.
+    DiskCache(const std::string& directory, const size_t maxSize);
+
+    std::string getFilePath(const std::string& fileName) const
+    {
+        return mDirectory + "/" + fileName;
+    }
+
+    // Returns false if the cache directory could not be created.
+    bool createDirectory();
+    // The file is written to a temporary file first so that an incomplete file is never read
+    // by another thread or if the application exits during the write. Returns false on failure.
+    bool writeFile(const std::string& path,
+                   const std::function<void(std::ostream& stream)>& writeFunction);
+
+private:
+    // The mutex needs to be locked by the caller.
+    void pruneFiles();
+
+    std::mutex mMutex;
+    const std::string mDirectory;
+    const size_t mMaxSize;
+    size_t mSize;
+    bool mDirectoryCreated;
+    bool mDirectoryFailed;
+};
+
+#endif // ES_CORE_RESOURCES_DISK_CACHE_H
@@ -9,6 +9,7 @@
 #include "resources/Font.h"
 
 #include "Log.h"
+#include "Profiler.h"
 #include "renderers/Renderer.h"
 #include "utils/FileSystemUtil.h"
 #include "utils/PlatformUtil.h"
@@ -285,6 +286,8 @@ TextCache* Font::buildTextCache(const std::string& text,
                                 bool multiLine,
                                 bool needGlyphsPos)
 {
+    PROFILE_SCOPE("Text shaping");
+
     if (maxLength == 0.0f)
         maxLength = length;
 
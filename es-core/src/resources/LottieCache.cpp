@@ -0,0 +1,289 @@
+//  SPDX-License-Identifier: MIT
+//
+//  ES-DE Frontend
+//  LottieCache.cpp
+//
+//  Disk cache of pre-rendered Lottie animations.
+//  Each combination of animation file and size is rendered once into a delta-encoded frame
+//  sequence which is stored on disk keyed by the MD5 hash of the file contents and the size.
+//  Playing back from such a sequence only requires applying the changed pixels to the
+//  previous frame, which is a lot cheaper than rasterizing the frame using rlottie.
+//
+
+#include "resources/LottieCache.h"
+
+#include "Log.h"
+#include "utils/FileSystemUtil.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    // Every keyframe is encoded on its own so that any frame can be decoded by applying at
+    // most this many frames, which is needed for reverse playback and frame skipping.
+    constexpr int KEYFRAME_INTERVAL {16};
+    // Animations that don't compress well enough to fit within this size are not cached.
+    constexpr size_t MAX_SEQUENCE_SIZE {64 * 1024 * 1024};
+    // When the disk cache grows beyond this size the least recently written sequences are
+    // removed until it's down to three quarters of the size.
+    constexpr size_t MAX_DISK_CACHE_SIZE {512 * 1024 * 1024};
+
+    const char SEQUENCE_MAGIC[8] {'E', 'S', 'L', 'O', 'T', '0', '0', '1'};
+    // Magic, width, height and the number of frames, followed by the frame offsets.
+    constexpr size_t SEQUENCE_HEADER_SIZE {sizeof(SEQUENCE_MAGIC) + 3 * sizeof(uint32_t)};
+
+    uint32_t readValue(const unsigned char* data)
+    {
+        // The data is not necessarily aligned.
+        uint32_t value {0};
+        memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    void appendValue(std::vector<unsigned char>& data, const uint32_t value)
+    {
+        const unsigned char* bytes {reinterpret_cast<const unsigned char*>(&value)};
+        data.insert(data.end(), bytes, bytes + sizeof(value));
+    }
+
+    // Each frame is stored as a series of runs, each consisting of the number of pixels that
+    // are unchanged from the previous frame followed by the number of changed pixels and
+    // their values. Keyframes are encoded against a fully transparent frame.
+    void encodeFrame(const std::vector<uint32_t>& previousPixels,
+                     const std::vector<uint32_t>& pixels,
+                     std::vector<unsigned char>& data)
+    {
+        const size_t pixelCount {pixels.size()};
+        size_t pos {0};
+
+        while (pos < pixelCount) {
+            size_t unchanged {0};
+            while (pos + unchanged < pixelCount &&
+                   pixels[pos + unchanged] == previousPixels[pos + unchanged])
+                ++unchanged;
+            pos += unchanged;
+
+            size_t changed {0};
+            while (pos + changed < pixelCount &&
+                   pixels[pos + changed] != previousPixels[pos + changed])
+                ++changed;
+
+            appendValue(data, static_cast<uint32_t>(unchanged));
+            appendValue(data, static_cast<uint32_t>(changed));
+            const unsigned char* changedPixels {
+                reinterpret_cast<const unsigned char*>(&pixels[pos])};
+            data.insert(data.end(), changedPixels, changedPixels + changed * sizeof(uint32_t));
+            pos += changed;
+        }
+    }
+
+} // namespace
+
+LottieCache::FrameSequence::FrameSequence(const ResourceData& data,
+                                          const size_t width,
+                                          const size_t height,
+                                          std::vector<uint32_t>&& frameOffsets)
+    : mData {data}
+    , mWidth {width}
+    , mHeight {height}
+    , mFrameOffsets {std::move(frameOffsets)}
+    , mFramePixels(width * height, 0)
+    , mLastFrame {-1}
+{
+}
+
+bool LottieCache::FrameSequence::getFrame(int frameNum, std::vector<uint8_t>& pictureRGBA)
+{
+    if (frameNum < 0 || frameNum >= static_cast<int>(mFrameOffsets.size()) - 1)
+        return false;
+
+    if (frameNum != mLastFrame) {
+        // Continue from the last decoded frame if possible, otherwise start over from the
+        // preceding keyframe.
+        const int keyframe {frameNum - frameNum % KEYFRAME_INTERVAL};
+        const int startFrame {mLastFrame >= keyframe && mLastFrame < frameNum ? mLastFrame + 1 :
+                                                                                keyframe};
+        for (int i {startFrame}; i <= frameNum; ++i) {
+            if (!applyDelta(i)) {
+                mLastFrame = -1;
+                return false;
+            }
+        }
+        mLastFrame = frameNum;
+    }
+
+    pictureRGBA.resize(mWidth * mHeight * 4);
+    memcpy(&pictureRGBA[0], &mFramePixels[0], pictureRGBA.size());
+    return true;
+}
+
+bool LottieCache::FrameSequence::applyDelta(const int frameNum)
+{
+    if (frameNum % KEYFRAME_INTERVAL == 0)
+        std::fill(mFramePixels.begin(), mFramePixels.end(), 0);
+
+    const unsigned char* data {mData.ptr.get() + mFrameOffsets[frameNum]};
+    const unsigned char* dataEnd {mData.ptr.get() + mFrameOffsets[frameNum + 1]};
+    const size_t pixelCount {mFramePixels.size()};
+    size_t pos {0};
+
+    while (data + 2 * sizeof(uint32_t) <= dataEnd) {
+        const size_t unchanged {readValue(data)};
+        const size_t changed {readValue(data + sizeof(uint32_t))};
+        data += 2 * sizeof(uint32_t);
+        pos += unchanged;
+
+        if (pos + changed > pixelCount ||
+            static_cast<size_t>(dataEnd - data) < changed * sizeof(uint32_t))
+            return false;
+
+        memcpy(&mFramePixels[pos], data, changed * sizeof(uint32_t));
+        data += changed * sizeof(uint32_t);
+        pos += changed;
+    }
+
+    return pos == pixelCount && data == dataEnd;
+}
+
+LottieCache::SequenceWriter::SequenceWriter(const std::string& path,
+                                            const size_t width,
+                                            const size_t height,
+                                            const size_t totalFrames)
+    : mPath {path}
+    , mWidth {width}
+    , mHeight {height}
+    , mTotalFrames {totalFrames}
+    , mPreviousPixels(width * height, 0)
+    , mPixels(width * height, 0)
+{
+}
+
+LottieCache::SequenceWriter::~SequenceWriter()
+{
+    LottieCache& cache {LottieCache::getInstance()};
+    std::unique_lock<std::mutex> lock {cache.mMutex};
+    cache.mPendingWrites.erase(mPath);
+}
+
+bool LottieCache::SequenceWriter::addFrame(const std::vector<uint8_t>& pictureRGBA)
+{
+    if (mFrameOffsets.size() >= mTotalFrames || mFrameData.size() > MAX_SEQUENCE_SIZE ||
+        pictureRGBA.size() != mPixels.size() * sizeof(uint32_t))
+        return false;
+
+    const size_t frameNum {mFrameOffsets.size()};
+    const size_t offsetsSize {(mTotalFrames + 1) * sizeof(uint32_t)};
+    memcpy(&mPixels[0], &pictureRGBA[0], mPixels.size() * sizeof(uint32_t));
+
+    if (frameNum % KEYFRAME_INTERVAL == 0)
+        std::fill(mPreviousPixels.begin(), mPreviousPixels.end(), 0);
+
+    mFrameOffsets.emplace_back(
+        static_cast<uint32_t>(SEQUENCE_HEADER_SIZE + offsetsSize + mFrameData.size()));
+    encodeFrame(mPreviousPixels, mPixels, mFrameData);
+    mPreviousPixels.swap(mPixels);
+
+    if (mFrameOffsets.size() < mTotalFrames)
+        return true;
+
+    mFrameOffsets.emplace_back(
+        static_cast<uint32_t>(SEQUENCE_HEADER_SIZE + offsetsSize + mFrameData.size()));
+    writeSequence();
+    return false;
+}
+
+void LottieCache::SequenceWriter::writeSequence()
+{
+    std::vector<unsigned char> header(SEQUENCE_MAGIC, SEQUENCE_MAGIC + sizeof(SEQUENCE_MAGIC));
+    appendValue(header, static_cast<uint32_t>(mWidth));
+    appendValue(header, static_cast<uint32_t>(mHeight));
+    appendValue(header, static_cast<uint32_t>(mTotalFrames));
+    for (auto offset : mFrameOffsets)
+        appendValue(header, offset);
+
+    const bool success {LottieCache::getInstance().mDiskCache.writeFile(
+        mPath, [this, &header](std::ostream& stream) {
+            stream.write(reinterpret_cast<const char*>(header.data()),
+                         static_cast<std::streamsize>(header.size()));
+            stream.write(reinterpret_cast<const char*>(mFrameData.data()),
+                         static_cast<std::streamsize>(mFrameData.size()));
+        })};
+
+    if (success) {
+        LOG(LogDebug) << "LottieCache::SequenceWriter::writeSequence(): Wrote \"" << mPath
+                      << "\" (" << (header.size() + mFrameData.size()) / 1024 << " KiB)";
+    }
+}
+
+LottieCache::LottieCache()
+    : mDiskCache {Utils::FileSystem::getAppDataDirectory() + "/cache/lottie",
+                  MAX_DISK_CACHE_SIZE}
+{
+}
+
+LottieCache& LottieCache::getInstance()
+{
+    static LottieCache instance;
+    return instance;
+}
+
+std::unique_ptr<LottieCache::FrameSequence> LottieCache::getFrameSequence(
+    const std::string& hash, const size_t width, const size_t height, const size_t totalFrames)
+{
+    const std::string path {getSequencePath(hash, width, height)};
+    if (!Utils::FileSystem::exists(path))
+        return nullptr;
+
+    // The file is memory mapped by the resource manager.
+    const ResourceData data {ResourceManager::getInstance().getFileData(path)};
+    const size_t offsetsSize {(totalFrames + 1) * sizeof(uint32_t)};
+
+    if (data.ptr == nullptr || data.length < SEQUENCE_HEADER_SIZE + offsetsSize ||
+        !std::equal(SEQUENCE_MAGIC, SEQUENCE_MAGIC + sizeof(SEQUENCE_MAGIC), data.ptr.get()) ||
+        readValue(data.ptr.get() + sizeof(SEQUENCE_MAGIC)) != width ||
+        readValue(data.ptr.get() + sizeof(SEQUENCE_MAGIC) + 4) != height ||
+        readValue(data.ptr.get() + sizeof(SEQUENCE_MAGIC) + 8) != totalFrames) {
+        LOG(LogWarning) << "LottieCache: Ignoring invalid cache file \"" << path << "\"";
+        return nullptr;
+    }
+
+    std::vector<uint32_t> frameOffsets;
+    for (size_t i {0}; i <= totalFrames; ++i) {
+        const uint32_t offset {
+            readValue(data.ptr.get() + SEQUENCE_HEADER_SIZE + i * sizeof(uint32_t))};
+        if (offset < SEQUENCE_HEADER_SIZE + offsetsSize || offset > data.length ||
+            (!frameOffsets.empty() && offset < frameOffsets.back())) {
+            LOG(LogWarning) << "LottieCache: Ignoring invalid cache file \"" << path << "\"";
+            return nullptr;
+        }
+        frameOffsets.emplace_back(offset);
+    }
+
+    return std::make_unique<FrameSequence>(data, width, height, std::move(frameOffsets));
+}
+
+std::unique_ptr<LottieCache::SequenceWriter> LottieCache::getSequenceWriter(
+    const std::string& hash, const size_t width, const size_t height, const size_t totalFrames)
+{
+    if (!mDiskCache.createDirectory())
+        return nullptr;
+
+    const std::string path {getSequencePath(hash, width, height)};
+
+    std::unique_lock<std::mutex> lock {mMutex};
+    // Another animation component may be writing the same sequence.
+    if (mPendingWrites.find(path) != mPendingWrites.cend() || Utils::FileSystem::exists(path))
+        return nullptr;
+
+    mPendingWrites.insert(path);
+    return std::make_unique<SequenceWriter>(path, width, height, totalFrames);
+}
+
+std::string LottieCache::getSequencePath(const std::string& hash,
+                                         const size_t width,
+                                         const size_t height)
+{
+    return mDiskCache.getFilePath(hash + "_" + std::to_string(width) + "x" +
+                                  std::to_string(height) + ".bin");
+}
@@ -0,0 +1,110 @@
+//  SPDX-License-Identifier: MIT
+//
+//  ES-DE Frontend
+//  LottieCache.h
+//
+//  Disk cache of pre-rendered Lottie animations.
+//  Each combination of animation file and size is rendered once into a delta-encoded frame
+//  sequence which is stored on disk keyed by the MD5 hash of the file contents and the size.
+//  Playing back from such a sequence only requires applying the changed pixels to the
+//  previous frame, which is a lot cheaper than rasterizing the frame using rlottie.
+//
+
+#ifndef ES_CORE_RESOURCES_LOTTIE_CACHE_H
+#define ES_CORE_RESOURCES_LOTTIE_CACHE_H
+
+#include "resources/DiskCache.h"
+#include "resources/ResourceManager.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+class LottieCache
+{
+public:
+    class FrameSequence
+    {
+    public:
+        FrameSequence(const ResourceData& data,
+                      const size_t width,
+                      const size_t height,
+                      std::vector<uint32_t>&& frameOffsets);
+
+        // Returns false if the frame data is corrupt. This is not thread safe, but each
+        // animation component has its own frame sequence.
+        bool getFrame(int frameNum, std::vector<uint8_t>& pictureRGBA);
+
+    private:
+        bool applyDelta(const int frameNum);
+
+        const ResourceData mData;
+        const size_t mWidth;
+        const size_t mHeight;
+        const std::vector<uint32_t> mFrameOffsets;
+
+        // The frames are decoded from the previous frame so the last one is kept.
+        std::vector<uint32_t> mFramePixels;
+        int mLastFrame;
+    };
+
+    // Encodes the frames one at a time so that the rendering can be split into small jobs,
+    // and writes the sequence to the disk cache once all frames have been added. This is not
+    // thread safe, but the frames for an animation are rendered by consecutive jobs.
+    class SequenceWriter
+    {
+    public:
+        SequenceWriter(const std::string& path,
+                       const size_t width,
+                       const size_t height,
+                       const size_t totalFrames);
+        ~SequenceWriter();
+
+        int getNextFrame() const { return static_cast<int>(mFrameOffsets.size()); }
+        // Returns false when no more frames should be added, either because the sequence has
+        // been written or because it doesn't compress well enough to be cached.
+        bool addFrame(const std::vector<uint8_t>& pictureRGBA);
+
+    private:
+        void writeSequence();
+
+        const std::string mPath;
+        const size_t mWidth;
+        const size_t mHeight;
+        const size_t mTotalFrames;
+        std::vector<uint32_t> mPreviousPixels;
+        std::vector<uint32_t> mPixels;
+        std::vector<unsigned char> mFrameData;
+        std::vector<uint32_t> mFrameOffsets;
+    };
+
+    static LottieCache& getInstance();
+
+    // Returns nullptr if the animation has not been cached at this size.
+    std::unique_ptr<FrameSequence> getFrameSequence(const std::string& hash,
+                                                    const size_t width,
+                                                    const size_t height,
+                                                    const size_t totalFrames);
+    // Returns nullptr if the sequence is already cached or is being written by another
+    // animation component, or if the cache directory could not be created.
+    std::unique_ptr<SequenceWriter> getSequenceWriter(const std::string& hash,
+                                                      const size_t width,
+                                                      const size_t height,
+                                                      const size_t totalFrames);
+
+private:
+    LottieCache();
+
+    std::string getSequencePath(const std::string& hash, const size_t width, const size_t height);
+
+    std::mutex mMutex;
+    // The sequences that are currently being written.
+    std::set<std::string> mPendingWrites;
+
+    DiskCache mDiskCache;
+};
+
+#endif // ES_CORE_RESOURCES_LOTTIE_CACHE_H
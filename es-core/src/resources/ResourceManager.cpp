@@ -5,6 +5,7 @@
 //
 //  Handles the application resources (fonts, graphics, sounds etc.).
 //  Loading and unloading of these files are done here.
+//  Files are memory mapped and shared between all callers requesting the same file.
 //
 
 #include "ResourceManager.h"
@@ -16,6 +17,21 @@
 
 #include <fstream>
 
+#if defined(_WIN64)
+#include <windows.h>
+#elif !defined(__ANDROID__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // Entries for files that are no longer in use are purged when the cache grows beyond this.
+    constexpr size_t FILE_CACHE_PURGE_SIZE {256};
+} // namespace
+
 ResourceManager& ResourceManager::getInstance()
 {
     static ResourceManager instance;
@@ -107,7 +123,35 @@ const ResourceData ResourceManager::getFileData(const std::string& path) const
     }
 #else
     if (Utils::FileSystem::exists(respath)) {
-        ResourceData data {loadFile(respath)};
+        const std::string canonicalPath {Utils::FileSystem::getCanonicalPath(respath)};
+        const std::filesystem::file_time_type lastWriteTime {
+            Utils::FileSystem::getLastWriteTime(canonicalPath)};
+
+        {
+            std::unique_lock<std::mutex> lock {mFileCacheMutex};
+            auto it = mFileCache.find(canonicalPath);
+            if (it != mFileCache.end() && it->second.lastWriteTime == lastWriteTime) {
+                std::shared_ptr<unsigned char> cachedData {it->second.data.lock()};
+                if (cachedData != nullptr)
+                    return ResourceData {cachedData, it->second.length};
+            }
+        }
+
+        ResourceData data {mapFile(canonicalPath)};
+        // Fall back to reading the file into memory, for instance for empty files.
+        if (data.ptr == nullptr)
+            return loadFile(respath);
+
+        std::unique_lock<std::mutex> lock {mFileCacheMutex};
+        if (mFileCache.size() >= FILE_CACHE_PURGE_SIZE) {
+            for (auto it = mFileCache.begin(); it != mFileCache.end();) {
+                if (it->second.data.expired())
+                    it = mFileCache.erase(it);
+                else
+                    ++it;
+            }
+        }
+        mFileCache[canonicalPath] = CachedFile {data.ptr, data.length, lastWriteTime};
         return data;
     }
 #endif
@@ -139,6 +183,73 @@ ResourceData ResourceManager::loadFile(const std::string& path) const
     return ret;
 }
 
+ResourceData ResourceManager::mapFile(const std::string& path) const
+{
+    // The mapping is released by the deleter once the last user of the data is gone.
+#if defined(_WIN64)
+    HANDLE fileHandle {CreateFileW(Utils::String::stringToWideString(path).c_str(), GENERIC_READ,
+                                   FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                   FILE_ATTRIBUTE_NORMAL, nullptr)};
+    if (fileHandle == INVALID_HANDLE_VALUE)
+        return ResourceData {nullptr, 0};
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(fileHandle);
+        return ResourceData {nullptr, 0};
+    }
+
+    HANDLE mappingHandle {
+        CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr)};
+    // The view keeps the file mapping open after the handles have been closed.
+    void* data {mappingHandle != nullptr ? MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0) :
+                                           nullptr};
+    if (mappingHandle != nullptr)
+        CloseHandle(mappingHandle);
+    CloseHandle(fileHandle);
+
+    if (data == nullptr)
+        return ResourceData {nullptr, 0};
+
+    const size_t size {static_cast<size_t>(fileSize.QuadPart)};
+    sMappedSize += size;
+    std::shared_ptr<unsigned char> mappedData {static_cast<unsigned char*>(data),
+                                               [size](unsigned char* p) {
+                                                   UnmapViewOfFile(p);
+                                                   sMappedSize -= size;
+                                               }};
+    return ResourceData {mappedData, size};
+#elif defined(__ANDROID__)
+    return ResourceData {nullptr, 0};
+#else
+    const int fileDescriptor {open(path.c_str(), O_RDONLY)};
+    if (fileDescriptor == -1)
+        return ResourceData {nullptr, 0};
+
+    struct stat fileInfo;
+    if (fstat(fileDescriptor, &fileInfo) != 0 || fileInfo.st_size == 0) {
+        close(fileDescriptor);
+        return ResourceData {nullptr, 0};
+    }
+
+    const size_t size {static_cast<size_t>(fileInfo.st_size)};
+    void* data {mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0)};
+    // The mapping stays valid after the file descriptor has been closed.
+    close(fileDescriptor);
+
+    if (data == MAP_FAILED)
+        return ResourceData {nullptr, 0};
+
+    sMappedSize += size;
+    std::shared_ptr<unsigned char> mappedData {static_cast<unsigned char*>(data),
+                                               [size](unsigned char* p) {
+                                                   munmap(p, size);
+                                                   sMappedSize -= size;
+                                               }};
+    return ResourceData {mappedData, size};
+#endif
+}
+
 ResourceData ResourceManager::loadFile(SDL_RWops* resFile) const
 {
     const size_t size {static_cast<size_t>(SDL_RWsize(resFile))};
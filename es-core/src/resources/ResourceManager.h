@@ -5,13 +5,18 @@
 //
 //  Handles the application resources (fonts, graphics, sounds etc.).
 //  Loading and unloading of these files are done here.
+//  Files are memory mapped and shared between all callers requesting the same file.
 //
 
 #ifndef ES_CORE_RESOURCES_RESOURCE_MANAGER_H
 #define ES_CORE_RESOURCES_RESOURCE_MANAGER_H
 
+#include <atomic>
+#include <filesystem>
 #include <list>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include <SDL2/SDL_rwops.h>
@@ -45,16 +50,32 @@ public:
     void reloadAll();
 
     std::string getResourcePath(const std::string& path, bool terminateOnFailure = true) const;
+    // The returned data is read-only and is shared with any other callers that requested the
+    // same file, as long as the file has not been modified in between.
     const ResourceData getFileData(const std::string& path) const;
     bool fileExists(const std::string& path) const;
 
+    // Returns the total size of all files that are currently memory mapped (in bytes).
+    static size_t getMappedSize() { return sMappedSize; }
+
 private:
     ResourceManager() noexcept {}
 
+    struct CachedFile {
+        std::weak_ptr<unsigned char> data;
+        size_t length;
+        std::filesystem::file_time_type lastWriteTime;
+    };
+
     ResourceData loadFile(const std::string& path) const;
     ResourceData loadFile(SDL_RWops* resFile) const;
+    ResourceData mapFile(const std::string& path) const;
 
     std::list<std::weak_ptr<IReloadable>> mReloadables;
+
+    mutable std::mutex mFileCacheMutex;
+    mutable std::map<std::string, CachedFile> mFileCache;
+    static inline std::atomic<size_t> sMappedSize {0};
 };
 
 #endif // ES_CORE_RESOURCES_RESOURCE_MANAGER_H
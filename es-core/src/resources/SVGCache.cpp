@@ -0,0 +1,182 @@
+//  SPDX-License-Identifier: MIT
+//
+//  ES-DE Frontend
+//  SVGCache.cpp
+//
+//  Caching of parsed SVG documents and rasterized SVG bitmaps.
+//  The parsed documents are kept in memory keyed by the MD5 hash of the file contents, and
+//  the rasterized bitmaps are stored on disk keyed by the file hash and the bitmap size so
+//  that the same image doesn't need to be rasterized again, not even across restarts.
+//
+
+#include "resources/SVGCache.h"
+
+#include "ImageIO.h"
+#include "Log.h"
+#include "utils/FileSystemUtil.h"
+#include "utils/MathUtil.h"
+#include "utils/StringUtil.h"
+
+#include "lunasvg.h"
+
+#include <algorithm>
+#include <fstream>
+
+namespace
+{
+    // The number of parsed documents kept in memory.
+    constexpr size_t MAX_DOCUMENTS {256};
+    // Small bitmaps are quicker to rasterize than to read from disk so these are not cached.
+    constexpr size_t MIN_DISK_CACHE_PIXELS {128 * 128};
+    // When the disk cache grows beyond this size the least recently written bitmaps are
+    // removed until it's down to three quarters of the size.
+    constexpr size_t MAX_DISK_CACHE_SIZE {256 * 1024 * 1024};
+
+    const char BITMAP_MAGIC[8] {'E', 'S', 'S', 'V', 'G', '0', '0', '1'};
+
+} // namespace
+
+SVGCache::Document::~Document() {}
+
+SVGCache::SVGCache()
+    : mDiskCache {Utils::FileSystem::getAppDataDirectory() + "/cache/svg", MAX_DISK_CACHE_SIZE}
+{
+}
+
+SVGCache& SVGCache::getInstance()
+{
+    static SVGCache instance;
+    return instance;
+}
+
+std::shared_ptr<SVGCache::Document> SVGCache::getDocument(const std::string& fileData)
+{
+    const std::string hash {Utils::Math::md5Hash(fileData, false)};
+    if (hash == "")
+        return nullptr;
+
+    {
+        std::unique_lock<std::mutex> lock {mMutex};
+        auto it = mDocuments.find(hash);
+        if (it != mDocuments.end()) {
+            mDocumentOrder.erase(
+                std::find(mDocumentOrder.begin(), mDocumentOrder.end(), hash));
+            mDocumentOrder.emplace_back(hash);
+            return it->second;
+        }
+    }
+
+    std::unique_ptr<lunasvg::Document> svgDocument {lunasvg::Document::loadFromData(fileData)};
+    if (svgDocument == nullptr)
+        return nullptr;
+
+    std::shared_ptr<Document> document {std::make_shared<Document>()};
+    document->hash = hash;
+    document->width = static_cast<float>(svgDocument->width());
+    document->height = static_cast<float>(svgDocument->height());
+    document->document = std::move(svgDocument);
+
+    std::unique_lock<std::mutex> lock {mMutex};
+    // Another thread may have parsed the same document in the meantime.
+    auto it = mDocuments.find(hash);
+    if (it != mDocuments.end())
+        return it->second;
+
+    mDocuments[hash] = document;
+    mDocumentOrder.emplace_back(hash);
+
+    if (mDocumentOrder.size() > MAX_DOCUMENTS) {
+        mDocuments.erase(mDocumentOrder.front());
+        mDocumentOrder.pop_front();
+    }
+
+    return document;
+}
+
+std::vector<unsigned char> SVGCache::rasterize(const std::shared_ptr<Document>& document,
+                                               const size_t width,
+                                               const size_t height)
+{
+    std::vector<unsigned char> dataRGBA;
+    std::string bitmapPath;
+
+    if (width * height >= MIN_DISK_CACHE_PIXELS) {
+        bitmapPath = getBitmapPath(document->hash, width, height);
+        if (readBitmap(bitmapPath, width, height, dataRGBA))
+            return dataRGBA;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock {document->mutex};
+        auto bitmap = document->document->renderToBitmap(width, height);
+        dataRGBA.insert(dataRGBA.begin(), bitmap.data(), bitmap.data() + width * height * 4);
+    }
+
+    ImageIO::flipPixelsVert(dataRGBA.data(), width, height);
+
+    if (bitmapPath != "")
+        writeBitmap(bitmapPath, width, height, dataRGBA);
+
+    return dataRGBA;
+}
+
+std::string SVGCache::getBitmapPath(const std::string& hash,
+                                    const size_t width,
+                                    const size_t height)
+{
+    return mDiskCache.getFilePath(hash + "_" + std::to_string(width) + "x" +
+                                  std::to_string(height) + ".bin");
+}
+
+bool SVGCache::readBitmap(const std::string& path,
+                          const size_t width,
+                          const size_t height,
+                          std::vector<unsigned char>& dataRGBA)
+{
+#if defined(_WIN64)
+    std::ifstream stream {Utils::String::stringToWideString(path).c_str(), std::ios::binary};
+#else
+    std::ifstream stream {path, std::ios::binary};
+#endif
+    if (!stream.good())
+        return false;
+
+    char magic[sizeof(BITMAP_MAGIC)];
+    uint32_t bitmapWidth {0};
+    uint32_t bitmapHeight {0};
+    stream.read(magic, sizeof(magic));
+    stream.read(reinterpret_cast<char*>(&bitmapWidth), sizeof(bitmapWidth));
+    stream.read(reinterpret_cast<char*>(&bitmapHeight), sizeof(bitmapHeight));
+
+    if (stream.fail() || !std::equal(magic, magic + sizeof(magic), BITMAP_MAGIC) ||
+        bitmapWidth != width || bitmapHeight != height)
+        return false;
+
+    dataRGBA.resize(width * height * 4);
+    stream.read(reinterpret_cast<char*>(dataRGBA.data()),
+                static_cast<std::streamsize>(dataRGBA.size()));
+
+    if (stream.gcount() != static_cast<std::streamsize>(dataRGBA.size())) {
+        dataRGBA.clear();
+        return false;
+    }
+
+    return true;
+}
+
+void SVGCache::writeBitmap(const std::string& path,
+                           const size_t width,
+                           const size_t height,
+                           const std::vector<unsigned char>& dataRGBA)
+{
+    const uint32_t bitmapWidth {static_cast<uint32_t>(width)};
+    const uint32_t bitmapHeight {static_cast<uint32_t>(height)};
+
+    mDiskCache.writeFile(path, [&](std::ostream& stream) {
+        stream.write(BITMAP_MAGIC, sizeof(BITMAP_MAGIC));
+        stream.write(reinterpret_cast<const char*>(&bitmapWidth), sizeof(bitmapWidth));
+        stream.write(reinterpret_cast<const char*>(&bitmapHeight), sizeof(bitmapHeight));
+        stream.write(reinterpret_cast<const char*>(dataRGBA.data()),
+                     static_cast<std::streamsize>(dataRGBA.size()));
+    });
+}
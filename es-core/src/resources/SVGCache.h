@@ -0,0 +1,73 @@
+//  SPDX-License-Identifier: MIT
+//
+//  ES-DE Frontend
+//  SVGCache.h
+//
+//  Caching of parsed SVG documents and rasterized SVG bitmaps.
+//  The parsed documents are kept in memory keyed by the MD5 hash of the file contents, and
+//  the rasterized bitmaps are stored on disk keyed by the file hash and the bitmap size so
+//  that the same image doesn't need to be rasterized again, not even across restarts.
+//
+
+#ifndef ES_CORE_RESOURCES_SVG_CACHE_H
+#define ES_CORE_RESOURCES_SVG_CACHE_H
+
+#include "resources/DiskCache.h"
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace lunasvg
+{
+    class Document;
+}
+
+class SVGCache
+{
+public:
+    struct Document {
+        ~Document();
+
+        std::string hash;
+        std::unique_ptr<lunasvg::Document> document;
+        float width;
+        float height;
+        // Rendering is serialized per document as lunasvg documents are not thread safe.
+        std::mutex mutex;
+    };
+
+    static SVGCache& getInstance();
+
+    // Returns nullptr if the SVG data could not be parsed.
+    std::shared_ptr<Document> getDocument(const std::string& fileData);
+    // Returns the bitmap flipped vertically and ready for uploading to the GPU.
+    std::vector<unsigned char> rasterize(const std::shared_ptr<Document>& document,
+                                         const size_t width,
+                                         const size_t height);
+
+private:
+    SVGCache();
+
+    std::string getBitmapPath(const std::string& hash, const size_t width, const size_t height);
+    bool readBitmap(const std::string& path,
+                    const size_t width,
+                    const size_t height,
+                    std::vector<unsigned char>& dataRGBA);
+    void writeBitmap(const std::string& path,
+                     const size_t width,
+                     const size_t height,
+                     const std::vector<unsigned char>& dataRGBA);
+
+    std::mutex mMutex;
+    std::map<std::string, std::shared_ptr<Document>> mDocuments;
+    // The hashes of the parsed documents with the most recently used last.
+    std::list<std::string> mDocumentOrder;
+
+    DiskCache mDiskCache;
+};
+
+#endif // ES_CORE_RESOURCES_SVG_CACHE_H
@@ -10,13 +10,45 @@
 
 #include "ImageIO.h"
 #include "Log.h"
+#include "Profiler.h"
 #include "resources/ResourceManager.h"
+#include "resources/SVGCache.h"
 #include "utils/StringUtil.h"
 
-#include "lunasvg.h"
-
 #include <string.h>
 
+namespace
+{
+    // Halves the image size for each level using a box filter.
+    void downscaleImage(std::vector<unsigned char>& imageRGBA,
+                        size_t& width,
+                        size_t& height,
+                        int level)
+    {
+        for (; level > 0 && width > 1 && height > 1; --level) {
+            const size_t newWidth {width / 2};
+            const size_t newHeight {height / 2};
+            std::vector<unsigned char> scaledRGBA(newWidth * newHeight * 4);
+
+            for (size_t y {0}; y < newHeight; ++y) {
+                const unsigned char* row0 {&imageRGBA[(y * 2) * width * 4]};
+                const unsigned char* row1 {&imageRGBA[(y * 2 + 1) * width * 4]};
+                unsigned char* target {&scaledRGBA[y * newWidth * 4]};
+                for (size_t x {0}; x < newWidth * 4; ++x) {
+                    const size_t source {(x / 4) * 8 + (x % 4)};
+                    target[x] = static_cast<unsigned char>(
+                        (row0[source] + row0[source + 4] + row1[source] + row1[source + 4] + 2) /
+                        4);
+                }
+            }
+
+            imageRGBA.swap(scaledRGBA);
+            width = newWidth;
+            height = newHeight;
+        }
+    }
+} // namespace
+
 TextureData::TextureData(bool tile)
     : mRenderer {Renderer::getInstance()}
     , mTile {tile}
@@ -32,7 +64,9 @@ TextureData::TextureData(bool tile)
     , mPendingRasterization {false}
     , mMipmapping {false}
     , mInvalidSVGFile {false}
+    , mDownscaleLevel {0}
     , mLinearMagnify {false}
+    , mVRAMUsage {0}
 {
 }
 
@@ -40,6 +74,7 @@ TextureData::~TextureData()
 {
     releaseVRAM();
     releaseRAM();
+    sTotalVRAMUsage -= mVRAMUsage;
 }
 
 void TextureData::initFromPath(const std::string& path)
@@ -58,7 +93,7 @@ bool TextureData::initSVGFromMemory(const std::string& fileData)
     if (!mDataRGBA.empty() && !mPendingRasterization)
         return true;
 
-    auto svgImage = lunasvg::Document::loadFromData(fileData);
+    std::shared_ptr<SVGCache::Document> svgImage {SVGCache::getInstance().getDocument(fileData)};
 
     if (svgImage == nullptr) {
         LOG(LogError) << "TextureData::initSVGFromMemory(): Couldn't parse SVG image \"" << mPath
@@ -67,8 +102,8 @@ bool TextureData::initSVGFromMemory(const std::string& fileData)
         return false;
     }
 
-    float svgWidth {static_cast<float>(svgImage->width())};
-    float svgHeight {static_cast<float>(svgImage->height())};
+    float svgWidth {svgImage->width};
+    float svgHeight {svgImage->height};
     bool rasterize {true};
 
     if (mTile) {
@@ -106,11 +141,7 @@ bool TextureData::initSVGFromMemory(const std::string& fileData)
     }
 
     if (rasterize) {
-        auto bitmap = svgImage->renderToBitmap(mWidth, mHeight);
-        mDataRGBA.insert(mDataRGBA.begin(), std::move(bitmap.data()),
-                         std::move(bitmap.data() + mWidth * mHeight * 4));
-
-        ImageIO::flipPixelsVert(mDataRGBA.data(), mWidth, mHeight);
+        mDataRGBA = SVGCache::getInstance().rasterize(svgImage, mWidth, mHeight);
         mPendingRasterization = false;
         mHasRGBAData = true;
     }
@@ -120,6 +151,7 @@ bool TextureData::initSVGFromMemory(const std::string& fileData)
         mPendingRasterization = true;
     }
 
+    updateVRAMUsage();
     return true;
 }
 
@@ -150,6 +182,9 @@ bool TextureData::initImageFromMemory(const unsigned char* fileData, size_t leng
     mSourceHeight = static_cast<float>(height);
     mScalable = false;
 
+    if (mDownscaleLevel > 0 && !mTile)
+        downscaleImage(imageRGBA, width, height, mDownscaleLevel);
+
     return initFromRGBA(imageRGBA.data(), width, height);
 }
 
@@ -167,6 +202,27 @@ bool TextureData::initFromRGBA(const unsigned char* dataRGBA, size_t width, size
     mWidth = static_cast<int>(width);
     mHeight = static_cast<int>(height);
     mHasRGBAData = true;
+    updateVRAMUsage();
+
+    return true;
+}
+
+bool TextureData::initFromDecodedImage(std::vector<unsigned char>& dataRGBA,
+                                       size_t width,
+                                       size_t height)
+{
+    std::unique_lock<std::mutex> lock {mMutex};
+    if (!mDataRGBA.empty())
+        return true;
+
+    mDataRGBA.swap(dataRGBA);
+    mWidth = static_cast<int>(width);
+    mHeight = static_cast<int>(height);
+    mSourceWidth = static_cast<float>(width);
+    mSourceHeight = static_cast<float>(height);
+    mScalable = false;
+    mHasRGBAData = true;
+    updateVRAMUsage();
 
     return true;
 }
@@ -219,10 +275,12 @@ bool TextureData::uploadAndBind(const unsigned int texUnit)
             return false;
 
         // Upload texture.
+        PROFILE_SCOPE("Texture upload");
         mTextureID =
             mRenderer->createTexture(texUnit, Renderer::TextureType::BGRA, true, mLinearMagnify,
                                      mMipmapping, mTile, static_cast<const unsigned int>(mWidth),
                                      static_cast<const unsigned int>(mHeight), mDataRGBA.data());
+        updateVRAMUsage();
     }
     return true;
 }
@@ -233,6 +291,7 @@ void TextureData::releaseVRAM()
     if (mTextureID != 0) {
         mRenderer->destroyTexture(mTextureID);
         mTextureID = 0;
+        updateVRAMUsage();
     }
 }
 
@@ -244,6 +303,7 @@ void TextureData::releaseRAM()
         mDataRGBA.clear();
         mDataRGBA.swap(swapVector);
         mHasRGBAData = false;
+        updateVRAMUsage();
     }
 }
 
@@ -293,6 +353,13 @@ void TextureData::setSourceSize(float width, float height)
     }
 }
 
+void TextureData::setMipmapping(bool state)
+{
+    std::unique_lock<std::mutex> lock {mMutex};
+    mMipmapping = state;
+    updateVRAMUsage();
+}
+
 size_t TextureData::getVRAMUsage()
 {
     if (mHasRGBAData || mTextureID != 0) {
@@ -306,3 +373,16 @@ size_t TextureData::getVRAMUsage()
         return 0;
     }
 }
+
+void TextureData::updateVRAMUsage()
+{
+    const size_t usage {getVRAMUsage()};
+    if (usage == mVRAMUsage)
+        return;
+
+    if (usage > mVRAMUsage)
+        sTotalVRAMUsage += usage - mVRAMUsage;
+    else
+        sTotalVRAMUsage -= mVRAMUsage - usage;
+    mVRAMUsage = usage;
+}
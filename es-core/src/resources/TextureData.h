@@ -33,6 +33,8 @@ public:
     bool initSVGFromMemory(const std::string& fileData);
     bool initImageFromMemory(const unsigned char* fileData, size_t length);
     bool initFromRGBA(const unsigned char* dataRGBA, size_t width, size_t height);
+    // Takes over image data that has already been decoded by the texture prefetcher.
+    bool initFromDecodedImage(std::vector<unsigned char>& dataRGBA, size_t width, size_t height);
 
     // Read the data into memory if necessary.
     bool load();
@@ -51,6 +53,8 @@ public:
 
     // Get the amount of VRAM currenty used by this texture.
     size_t getVRAMUsage();
+    // The combined VRAM usage of all textures, this is updated whenever a texture changes state.
+    static size_t getTotalVRAMUsage() { return sTotalVRAMUsage; }
 
     size_t width();
     size_t height();
@@ -67,7 +71,11 @@ public:
     // Whether to use linear filtering when magnifying the texture.
     void setLinearMagnify(bool state) { mLinearMagnify = state; }
     // Whether to use mipmapping and trilinear filtering.
-    void setMipmapping(bool state) { mMipmapping = state; }
+    void setMipmapping(bool state);
+    // Raster images are downscaled by a factor of two per level when loaded, which is used
+    // to reduce the VRAM usage when running out of texture memory.
+    void setDownscaleLevel(int level) { mDownscaleLevel = level; }
+    const int getDownscaleLevel() { return mDownscaleLevel; }
 
     // Has the image been loaded but not yet been rasterized as the size was not known?
     const bool getPendingRasterization() { return mPendingRasterization; }
@@ -79,6 +87,9 @@ public:
     const bool getIsInvalidSVGFile() { return mInvalidSVGFile; }
 
 private:
+    // Needs to be called with the mutex locked whenever the VRAM usage may have changed.
+    void updateVRAMUsage();
+
     Renderer* mRenderer;
     std::mutex mMutex;
 
@@ -97,8 +108,12 @@ private:
     std::atomic<bool> mPendingRasterization;
     std::atomic<bool> mMipmapping;
     std::atomic<bool> mInvalidSVGFile;
+    std::atomic<int> mDownscaleLevel;
     bool mLinearMagnify;
     bool mReloadable;
+    size_t mVRAMUsage;
+
+    static inline std::atomic<size_t> sTotalVRAMUsage {0};
 };
 
 #endif // ES_CORE_RESOURCES_TEXTURE_DATA_H
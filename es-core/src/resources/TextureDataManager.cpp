@@ -8,12 +8,24 @@
 
 #include "resources/TextureDataManager.h"
 
+#include "ImageIO.h"
 #include "Log.h"
 #include "Settings.h"
 #include "resources/TextureData.h"
 #include "resources/TextureResource.h"
 
+#include <algorithm>
+
+namespace
+{
+    // Textures that have been bound during this many frames are considered to be on screen.
+    constexpr unsigned int PINNED_FRAMES {2};
+    // Textures are never downscaled to less than a quarter of their width and height.
+    constexpr int MAX_DOWNSCALE_LEVEL {2};
+} // namespace
+
 TextureDataManager::TextureDataManager()
+    : mFrameCount {PINNED_FRAMES}
 {
     // This blank texture will be used temporarily when there is not yet any data loaded for
     // the requested texture (i.e. it can't be uploaded to the GPU VRAM yet).
@@ -28,8 +40,8 @@ std::shared_ptr<TextureData> TextureDataManager::add(const TextureResource* key,
 {
     remove(key);
     std::shared_ptr<TextureData> data {std::make_shared<TextureData>(tiled)};
-    mTextures.push_front(data);
-    mTextureLookup[key] = mTextures.cbegin();
+    mTextures.push_front(TextureEntry {data, 0});
+    mTextureLookup[key] = mTextures.begin();
     return data;
 }
 
@@ -47,18 +59,13 @@ void TextureDataManager::remove(const TextureResource* key)
 
 std::shared_ptr<TextureData> TextureDataManager::get(const TextureResource* key)
 {
-    // If it's in the cache then we want to remove it from it's current location and
-    // move it to the top.
+    // If it's in the cache then we want to move it to the top.
     std::shared_ptr<TextureData> tex;
     auto it = mTextureLookup.find(key);
     if (it != mTextureLookup.cend()) {
-        tex = *(*it).second;
-        // Remove the list entry.
-        mTextures.erase((*it).second);
-        // Put it at the top.
-        mTextures.push_front(tex);
-        // Store it back in the lookup.
-        mTextureLookup[key] = mTextures.cbegin();
+        // Splicing keeps the iterator in the lookup valid.
+        mTextures.splice(mTextures.begin(), mTextures, (*it).second);
+        tex = (*it).second->data;
 
         // Make sure it's loaded or queued for loading.
         load(tex);
@@ -70,8 +77,10 @@ bool TextureDataManager::bind(const TextureResource* key, const unsigned int tex
 {
     std::shared_ptr<TextureData> tex {get(key)};
     bool bound {false};
-    if (tex != nullptr)
+    if (tex != nullptr) {
+        mTextureLookup[key]->lastBoundFrame = mFrameCount;
         bound = tex->uploadAndBind(texUnit);
+    }
     if (!bound)
         mBlank->uploadAndBind(texUnit);
     return bound;
@@ -80,16 +89,8 @@ bool TextureDataManager::bind(const TextureResource* key, const unsigned int tex
 size_t TextureDataManager::getTotalSize()
 {
     size_t total {0};
-    for (auto tex : mTextures)
-        total += tex->width() * tex->height() * 4;
-    return total;
-}
-
-size_t TextureDataManager::getCommittedSize()
-{
-    size_t total {0};
-    for (auto tex : mTextures)
-        total += tex->getVRAMUsage();
+    for (auto& entry : mTextures)
+        total += entry.data->width() * entry.data->height() * 4;
     return total;
 }
 
@@ -99,13 +100,96 @@ size_t TextureDataManager::getQueueSize()
     return mLoader->getQueueSize();
 }
 
+TextureDataManager::Statistics TextureDataManager::getStatistics()
+{
+    const auto now = std::chrono::steady_clock::now();
+    while (!mEvictionTimes.empty() && now - mEvictionTimes.front() > std::chrono::seconds(1))
+        mEvictionTimes.pop_front();
+
+    size_t downscaledTextures {0};
+    for (auto& entry : mTextures) {
+        if (entry.data->getDownscaleLevel() > 0 && entry.data->getVRAMUsage() > 0)
+            ++downscaledTextures;
+    }
+
+    return Statistics {TextureData::getTotalVRAMUsage(), mLoader->getQueueSize(),
+                       mLoader->getPrefetchedSize(), mEvictionTimes.size(), downscaledTextures};
+}
+
 void TextureDataManager::load(std::shared_ptr<TextureData> tex, bool block)
 {
     // See if it's already loaded.
     if (tex->isLoaded())
         return;
-    // Not loaded. Make sure there is room.
-    size_t size {TextureResource::getTotalMemUsage()};
+    // Use the image data if it has already been decoded by the prefetcher.
+    const bool prefetched {mLoader->loadPrefetched(tex)};
+    // Make sure there is room.
+    const size_t max_texture {getMaxVRAM()};
+    size_t size {TextureResource::getTotalMemUsage() + mLoader->getPrefetchedSize()};
+
+    // The prefetched images are released before any textures are evicted.
+    if (size >= max_texture && mLoader->getPrefetchedSize() > 0) {
+        mLoader->clearPrefetched();
+        size = TextureResource::getTotalMemUsage();
+    }
+
+    // The texture size is from the last time it was loaded, possibly while downscaled. For
+    // textures that have not been loaded yet this is zero.
+    const glm::vec2 textureSize {tex->getSize()};
+    size_t required {prefetched ? 0 :
+                                  static_cast<size_t>(textureSize.x * textureSize.y * 4.0f)
+                                      << (tex->getDownscaleLevel() * 2)};
+
+    for (auto it = mTextures.rbegin(); it != mTextures.rend(); ++it) {
+        if (size + required < max_texture)
+            break;
+        // Don't evict textures that are on screen.
+        if ((*it).data == tex || (*it).lastBoundFrame + PINNED_FRAMES > mFrameCount)
+            continue;
+        const bool resident {(*it).data->getVRAMUsage() > 0};
+        (*it).data->releaseVRAM();
+        (*it).data->releaseRAM();
+        // It may be already in the loader queue. In this case it wouldn't have been using
+        // any VRAM yet but it will be. Remove it from the loader queue.
+        mLoader->remove((*it).data);
+        if (resident)
+            mEvictionTimes.emplace_back(std::chrono::steady_clock::now());
+        size = TextureResource::getTotalMemUsage();
+    }
+
+    if (prefetched)
+        return;
+
+    // If there is still not enough room as the remaining textures are on screen, then load the
+    // texture at a reduced resolution. This is not done for blocking loads as these are used
+    // to determine the texture size.
+    int downscaleLevel {0};
+    if (!block && !tex->getTiled() && !tex->getScalable()) {
+        while (downscaleLevel < MAX_DOWNSCALE_LEVEL && size + required >= max_texture) {
+            ++downscaleLevel;
+            required /= 4;
+        }
+    }
+    tex->setDownscaleLevel(downscaleLevel);
+
+    if (!block)
+        mLoader->load(tex);
+    else
+        tex->load();
+}
+
+void TextureDataManager::prefetch(const std::vector<std::string>& paths)
+{
+    const size_t maxVRAM {getMaxVRAM()};
+    const size_t size {TextureResource::getTotalMemUsage()};
+    mLoader->setPrefetchBudget(size < maxVRAM ? std::min(maxVRAM / 4, maxVRAM - size) : 0);
+
+    for (auto& path : paths)
+        mLoader->prefetch(path);
+}
+
+size_t TextureDataManager::getMaxVRAM()
+{
     size_t settingVRAM {static_cast<size_t>(Settings::getInstance()->getInt("MaxVRAM"))};
 
     if (settingVRAM < 128) {
@@ -121,27 +205,15 @@ void TextureDataManager::load(std::shared_ptr<TextureData> tex, bool block)
         settingVRAM = 1024;
     }
 
-    size_t max_texture {settingVRAM * 1024 * 1024};
-
-    for (auto it = mTextures.crbegin(); it != mTextures.crend(); ++it) {
-        if (size < max_texture)
-            break;
-        (*it)->releaseVRAM();
-        (*it)->releaseRAM();
-        // It may be already in the loader queue. In this case it wouldn't have been using
-        // any VRAM yet but it will be. Remove it from the loader queue.
-        mLoader->remove(*it);
-        size = TextureResource::getTotalMemUsage();
-    }
-
-    if (!block)
-        mLoader->load(tex);
-    else
-        tex->load();
+    return settingVRAM * 1024 * 1024;
 }
 
 TextureLoader::TextureLoader()
-    : mExit(false)
+    : mQueueSize {0}
+    , mPrefetchedSize {0}
+    , mPrefetchBudget {0}
+    , mExit(false)
+    , mLoadedCount {0}
 {
     mThread = std::make_unique<std::thread>(&TextureLoader::threadProc, this);
 }
@@ -152,6 +224,8 @@ TextureLoader::~TextureLoader()
     std::unique_lock<std::mutex> lock(mMutex);
     mTextureDataQ.clear();
     mTextureDataLookup.clear();
+    mQueueSize = 0;
+    mPrefetchQ.clear();
     lock.unlock();
 
     // Exit the thread.
@@ -165,28 +239,39 @@ TextureLoader::~TextureLoader()
 void TextureLoader::threadProc()
 {
     while (!mExit) {
-        std::shared_ptr<TextureData> textureData;
         {
             // Wait for an event to say there is something in the queue.
             std::unique_lock<std::mutex> lock {mMutex};
-            mEvent.wait(lock);
-            if (!mTextureDataQ.empty()) {
-                textureData = mTextureDataQ.front();
-                mTextureDataQ.pop_front();
-                mTextureDataLookup.erase(mTextureDataLookup.find(textureData.get()));
-            }
+            if (mTextureDataQ.empty() && mPrefetchQ.empty())
+                mEvent.wait(lock);
         }
-        // Queue has been released here but we might have a texture to process.
-        while (!mExit && textureData) {
-            textureData->load();
-
-            // See if there is another item in the queue.
-            textureData = nullptr;
-            std::unique_lock<std::mutex> lock {mMutex};
-            if (!mTextureDataQ.empty()) {
-                textureData = mTextureDataQ.front();
-                mTextureDataQ.pop_front();
-                mTextureDataLookup.erase(mTextureDataLookup.find(textureData.get()));
+        // Process the queue, the regular loads always take priority over the prefetches.
+        while (!mExit) {
+            std::shared_ptr<TextureData> textureData;
+            std::string prefetchPath;
+            {
+                std::unique_lock<std::mutex> lock {mMutex};
+                if (!mTextureDataQ.empty()) {
+                    textureData = mTextureDataQ.front();
+                    mTextureDataQ.pop_front();
+                    auto td = mTextureDataLookup.find(textureData.get());
+                    mQueueSize -= (*td).second.size;
+                    mTextureDataLookup.erase(td);
+                }
+                else if (!mPrefetchQ.empty()) {
+                    prefetchPath = mPrefetchQ.front();
+                    mPrefetchQ.pop_front();
+                }
+                else {
+                    break;
+                }
+            }
+            if (textureData) {
+                textureData->load();
+                ++mLoadedCount;
+            }
+            else {
+                prefetchImage(prefetchPath);
             }
         }
     }
@@ -200,13 +285,19 @@ void TextureLoader::load(std::shared_ptr<TextureData> textureData)
         // Remove it from the queue if it is already there.
         auto td = mTextureDataLookup.find(textureData.get());
         if (td != mTextureDataLookup.cend()) {
-            mTextureDataQ.erase((*td).second);
+            mTextureDataQ.erase((*td).second.position);
+            mQueueSize -= (*td).second.size;
             mTextureDataLookup.erase(td);
         }
 
+        // The size is from the last time the texture was loaded so it's only an estimate.
+        const glm::vec2 textureSize {textureData->getSize()};
+        const size_t size {static_cast<size_t>(textureSize.x * textureSize.y * 4.0f)};
+
         // Put it on the start of the queue as we want the newly requested textures to load first.
         mTextureDataQ.push_front(textureData);
-        mTextureDataLookup[textureData.get()] = mTextureDataQ.cbegin();
+        mTextureDataLookup[textureData.get()] = QueueEntry {mTextureDataQ.cbegin(), size};
+        mQueueSize += size;
         mEvent.notify_one();
     }
 }
@@ -217,7 +308,8 @@ void TextureLoader::remove(std::shared_ptr<TextureData> textureData)
     std::unique_lock<std::mutex> lock {mMutex};
     auto td = mTextureDataLookup.find(textureData.get());
     if (td != mTextureDataLookup.cend()) {
-        mTextureDataQ.erase((*td).second);
+        mTextureDataQ.erase((*td).second.position);
+        mQueueSize -= (*td).second.size;
         mTextureDataLookup.erase(td);
     }
 }
@@ -226,10 +318,103 @@ size_t TextureLoader::getQueueSize()
 {
     // Get the amount of video memory that will be used once all textures in
     // the queue are loaded.
-    size_t mem {0};
     std::unique_lock<std::mutex> lock {mMutex};
-    for (auto tex : mTextureDataQ)
-        mem += tex->width() * tex->height() * 4;
+    return mQueueSize;
+}
+
+void TextureLoader::prefetch(const std::string& path)
+{
+    std::unique_lock<std::mutex> lock {mMutex};
+    if (mPrefetched.find(path) != mPrefetched.cend() ||
+        std::find(mPrefetchQ.cbegin(), mPrefetchQ.cend(), path) != mPrefetchQ.cend())
+        return;
+
+    mPrefetchQ.push_back(path);
+    mEvent.notify_one();
+}
+
+void TextureLoader::cancelPrefetch()
+{
+    // Images that have already been decoded are kept as they may still be needed.
+    std::unique_lock<std::mutex> lock {mMutex};
+    mPrefetchQ.clear();
+}
+
+void TextureLoader::clearPrefetched()
+{
+    std::unique_lock<std::mutex> lock {mMutex};
+    mPrefetchQ.clear();
+    mPrefetched.clear();
+    mPrefetchedOrder.clear();
+    mPrefetchedSize = 0;
+}
+
+void TextureLoader::setPrefetchBudget(size_t budget)
+{
+    std::unique_lock<std::mutex> lock {mMutex};
+    mPrefetchBudget = budget;
+}
+
+bool TextureLoader::loadPrefetched(std::shared_ptr<TextureData> textureData)
+{
+    std::unique_lock<std::mutex> lock {mMutex};
+    auto it = mPrefetched.find(textureData->getTextureFilePath());
+    if (it == mPrefetched.end())
+        return false;
+
+    PrefetchedImage& image {it->second};
+    const bool loaded {
+        textureData->initFromDecodedImage(image.dataRGBA, image.width, image.height)};
+    releasePrefetched(it->first);
+    return loaded;
+}
+
+size_t TextureLoader::getPrefetchedSize()
+{
+    std::unique_lock<std::mutex> lock {mMutex};
+    return mPrefetchedSize;
+}
+
+void TextureLoader::prefetchImage(const std::string& path)
+{
+    {
+        std::unique_lock<std::mutex> lock {mMutex};
+        if (mPrefetchBudget == 0 || mPrefetched.find(path) != mPrefetched.cend())
+            return;
+    }
+
+    const ResourceData& data {ResourceManager::getInstance().getFileData(path)};
+    if (data.length == 0)
+        return;
+
+    PrefetchedImage image {};
+    image.dataRGBA = ImageIO::loadFromMemoryRGBA32(
+        static_cast<const unsigned char*>(data.ptr.get()), data.length, image.width,
+        image.height);
+
+    const size_t imageSize {image.dataRGBA.size()};
+    std::unique_lock<std::mutex> lock {mMutex};
+    if (imageSize == 0 || imageSize > mPrefetchBudget)
+        return;
+
+    // Make room by releasing the images that were prefetched the longest time ago.
+    while (!mPrefetchedOrder.empty() && mPrefetchedSize + imageSize > mPrefetchBudget)
+        releasePrefetched(mPrefetchedOrder.front());
+
+    mPrefetchedSize += imageSize;
+    mPrefetchedOrder.push_back(path);
+    mPrefetched[path] = std::move(image);
+}
+
+void TextureLoader::releasePrefetched(const std::string& path)
+{
+    // The mutex needs to be locked by the caller.
+    auto it = mPrefetched.find(path);
+    if (it == mPrefetched.end())
+        return;
 
-    return mem;
+    mPrefetchedSize -= it->second.dataRGBA.size();
+    mPrefetchedOrder.erase(
+        std::find(mPrefetchedOrder.begin(), mPrefetchedOrder.end(), path));
+    mPrefetched.erase(it);
 }
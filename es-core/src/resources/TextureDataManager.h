@@ -10,12 +10,16 @@
 #define ES_CORE_RESOURCES_TEXTURE_DATA_MANAGER_H
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <deque>
 #include <list>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
+#include <vector>
 
 class TextureData;
 class TextureResource;
@@ -29,21 +33,55 @@ public:
     void load(std::shared_ptr<TextureData> textureData);
     void remove(std::shared_ptr<TextureData> textureData);
 
+    // Prefetch requests have lower priority than regular loads, the images are only decoded
+    // into memory and are kept until the texture is loaded or until the budget runs out.
+    void prefetch(const std::string& path);
+    void cancelPrefetch();
+    void clearPrefetched();
+    void setPrefetchBudget(size_t budget);
+    // Returns true if the image data for the texture had been prefetched.
+    bool loadPrefetched(std::shared_ptr<TextureData> textureData);
+
     void setExit() { mExit = true; }
     size_t getQueueSize();
+    size_t getPrefetchedSize();
+    // Incremented every time a texture has finished loading in the background.
+    unsigned int getLoadedCount() { return mLoadedCount; }
 
 private:
+    struct PrefetchedImage {
+        std::vector<unsigned char> dataRGBA;
+        size_t width;
+        size_t height;
+    };
+
     void processQueue();
     void threadProc();
+    void prefetchImage(const std::string& path);
+    void releasePrefetched(const std::string& path);
+
+    struct QueueEntry {
+        std::list<std::shared_ptr<TextureData>>::const_iterator position;
+        size_t size;
+    };
 
     std::list<std::shared_ptr<TextureData>> mTextureDataQ;
-    std::map<TextureData*, std::list<std::shared_ptr<TextureData>>::const_iterator>
-        mTextureDataLookup;
+    std::map<TextureData*, QueueEntry> mTextureDataLookup;
+    // The combined size of the textures in the queue.
+    size_t mQueueSize;
+
+    std::list<std::string> mPrefetchQ;
+    std::map<std::string, PrefetchedImage> mPrefetched;
+    // The prefetched images in the order they were decoded, the oldest are released first.
+    std::list<std::string> mPrefetchedOrder;
+    size_t mPrefetchedSize;
+    size_t mPrefetchBudget;
 
     std::unique_ptr<std::thread> mThread;
     std::mutex mMutex;
     std::condition_variable mEvent;
     std::atomic<bool> mExit;
+    std::atomic<unsigned int> mLoadedCount;
 };
 
 //
@@ -60,9 +98,28 @@ private:
 // to releaseRAM() which frees the memory buffer if the texture can be reloaded from
 // disk if needed again.
 //
+// If the MaxVRAM limit is reached, the least recently used textures are evicted, except
+// for those that have been bound during the current or the previous frame as these are
+// on screen. If there is still not enough room then textures are loaded at a reduced
+// resolution instead of evicting textures that are on screen, which would only lead to
+// them being loaded again right away.
+//
 class TextureDataManager
 {
 public:
+    struct Statistics {
+        // Textures in VRAM or in RAM waiting to be uploaded.
+        size_t residentSize;
+        // Textures in the loader queue.
+        size_t pendingSize;
+        // Images that have been decoded by the prefetcher.
+        size_t prefetchedSize;
+        // Evicted textures during the last second.
+        size_t evictionsPerSecond;
+        // Loaded textures that have been downscaled because of the VRAM limit.
+        size_t downscaledTextures;
+    };
+
     TextureDataManager();
 
     std::shared_ptr<TextureData> add(const TextureResource* key, bool tiled);
@@ -75,15 +132,24 @@ public:
     std::shared_ptr<TextureData> get(const TextureResource* key);
     bool bind(const TextureResource* key, const unsigned int texUnit);
 
+    // Should be called at the start of each frame, used to determine which textures are on screen.
+    void beginFrame() { ++mFrameCount; }
+
     // Get the total size of all textures managed by this object, loaded and unloaded in bytes.
     size_t getTotalSize();
-    // Get the total size of all committed textures (in VRAM) in bytes.
-    size_t getCommittedSize();
     // Get the total size of all load-pending textures in the queue - these will
     // be committed to VRAM as the queue is processed.
     size_t getQueueSize();
+    Statistics getStatistics();
+    // The number of textures that have been loaded in the background, this is used to
+    // determine whether a new frame needs to be rendered.
+    unsigned int getLoadedCount() { return mLoader ? mLoader->getLoadedCount() : 0; }
     // Load a texture, freeing resources as necessary to make space.
     void load(std::shared_ptr<TextureData> tex, bool block = false);
+    // Decode images in the background ahead of them being needed. Only the memory that is
+    // left within the VRAM limit is used for this, and never more than a quarter of it.
+    void prefetch(const std::vector<std::string>& paths);
+    void cancelPrefetch() { mLoader->cancelPrefetch(); }
     // Make sure that threadProc() does not continue to run during application shutdown.
     void setExit()
     {
@@ -92,11 +158,22 @@ public:
     }
 
 private:
-    std::list<std::shared_ptr<TextureData>> mTextures;
-    std::map<const TextureResource*, std::list<std::shared_ptr<TextureData>>::const_iterator>
-        mTextureLookup;
+    struct TextureEntry {
+        std::shared_ptr<TextureData> data;
+        unsigned int lastBoundFrame;
+    };
+
+    // Returns the MaxVRAM setting in bytes.
+    size_t getMaxVRAM();
+
+    // Ordered with the most recently used textures first.
+    std::list<TextureEntry> mTextures;
+    std::map<const TextureResource*, std::list<TextureEntry>::iterator> mTextureLookup;
     std::shared_ptr<TextureData> mBlank;
     std::unique_ptr<TextureLoader> mLoader;
+
+    std::deque<std::chrono::steady_clock::time_point> mEvictionTimes;
+    unsigned int mFrameCount;
 };
 
 #endif // ES_CORE_RESOURCES_TEXTURE_DATA_MANAGER_H
@@ -241,6 +241,30 @@ std::shared_ptr<TextureResource> TextureResource::get(const std::string& path,
     return tex;
 }
 
+void TextureResource::prefetch(const std::vector<std::string>& paths)
+{
+    std::vector<std::string> prefetchPaths;
+
+    for (auto& path : paths) {
+        const std::string canonicalPath {Utils::FileSystem::getCanonicalPath(path)};
+        // SVG images are not prefetched as they are rasterized at the size they are shown at.
+        if (canonicalPath.empty() ||
+            Utils::String::toLower(canonicalPath.substr(canonicalPath.size() - 4)) == ".svg")
+            continue;
+
+        // Skip the image if there is already a texture for it.
+        auto it = sTextureMap.lower_bound({canonicalPath, false, false, false, false, 0, 0});
+        if (it != sTextureMap.cend() && std::get<0>(it->first) == canonicalPath &&
+            !it->second.expired())
+            continue;
+
+        prefetchPaths.emplace_back(canonicalPath);
+    }
+
+    if (!prefetchPaths.empty())
+        sTextureDataManager.prefetch(prefetchPaths);
+}
+
 void TextureResource::rasterizeAt(float width, float height)
 {
     if (mTextureData != nullptr) {
@@ -265,17 +289,9 @@ void TextureResource::rasterizeAt(float width, float height)
 
 size_t TextureResource::getTotalMemUsage()
 {
-    size_t total {0};
-    // Count up all textures that manage their own texture data.
-    for (auto tex : sAllTextures) {
-        if (tex->mTextureData != nullptr)
-            total += tex->mTextureData->getVRAMUsage();
-    }
-    // Now get the committed memory from the manager.
-    total += sTextureDataManager.getCommittedSize();
-    // And the size of the loading queue.
-    total += sTextureDataManager.getQueueSize();
-    return total;
+    // The VRAM usage is tracked by the texture data objects themselves, so this includes both
+    // the textures that manage their own texture data and those handled by the manager.
+    return TextureData::getTotalVRAMUsage() + sTextureDataManager.getQueueSize();
 }
 
 size_t TextureResource::getTotalTextureSize()
@@ -40,6 +40,9 @@ public:
     virtual void initFromMemory(const char* data, size_t length);
     static void manualUnload(const std::string& path, bool tile);
     static void manualUnloadAll() { sTextureMap.clear(); }
+    // Decode the images in the background so they're ready by the time they are needed.
+    static void prefetch(const std::vector<std::string>& paths);
+    static void cancelPrefetch() { sTextureDataManager.cancelPrefetch(); }
 
     // Returns the raw pixel values.
     std::vector<unsigned char> getRawRGBAData();
@@ -79,6 +82,14 @@ public:
     static size_t getTotalMemUsage();
     // Returns the number of bytes that would be used if all textures were in memory.
     static size_t getTotalTextureSize();
+    // Returns a counter which is increased whenever a texture has been loaded in the background.
+    static unsigned int getLoadedCount() { return sTextureDataManager.getLoadedCount(); }
+    // Should be called at the start of each frame so that textures on screen are not evicted.
+    static void beginFrame() { sTextureDataManager.beginFrame(); }
+    static TextureDataManager::Statistics getStatistics()
+    {
+        return sTextureDataManager.getStatistics();
+    }
 
     static void setExit() { sTextureDataManager.setExit(); }
 
@@ -5,9 +5,479 @@
 //
 //  Utility functions using the CImg image processing library.
 //
+//  CImg stores images in planar format, i.e. one full plane per channel. The conversion,
+//  scanning, blur and compositing kernels below work directly on these planes and use
+//  SSE2/AVX2 or NEON when available, with scalar fallbacks for all other targets.
+//
 
 #include "utils/CImgUtil.h"
 
+#include <algorithm>
+#include <cstring>
+
+#if defined(__AVX2__)
+#define CIMG_UTIL_AVX2
+#include <immintrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CIMG_UTIL_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define CIMG_UTIL_NEON
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+    // Returns true if all bytes in the range are zero.
+    bool isZero(const unsigned char* data, const size_t length)
+    {
+        size_t i {0};
+#if defined(CIMG_UTIL_AVX2)
+        for (; i + 32 <= length; i += 32) {
+            const __m256i block {
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i))};
+            if (!_mm256_testz_si256(block, block))
+                return false;
+        }
+#endif
+#if defined(CIMG_UTIL_SSE2)
+        const __m128i zero {_mm_setzero_si128()};
+        for (; i + 16 <= length; i += 16) {
+            const __m128i block {_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i))};
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(block, zero)) != 0xFFFF)
+                return false;
+        }
+#elif defined(CIMG_UTIL_NEON)
+        for (; i + 16 <= length; i += 16) {
+            const uint8x16_t block {vld1q_u8(data + i)};
+            const uint64x2_t halves {vreinterpretq_u64_u8(block)};
+            if ((vgetq_lane_u64(halves, 0) | vgetq_lane_u64(halves, 1)) != 0)
+                return false;
+        }
+#endif
+        for (; i < length; ++i) {
+            if (data[i] != 0)
+                return false;
+        }
+        return true;
+    }
+
+    // Bitwise OR of the source bytes into the destination bytes.
+    void accumulateOr(unsigned char* dst, const unsigned char* src, const size_t length)
+    {
+        size_t i {0};
+#if defined(CIMG_UTIL_AVX2)
+        for (; i + 32 <= length; i += 32) {
+            __m256i* dstBlock {reinterpret_cast<__m256i*>(dst + i)};
+            _mm256_storeu_si256(
+                dstBlock,
+                _mm256_or_si256(_mm256_loadu_si256(dstBlock),
+                                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i))));
+        }
+#endif
+#if defined(CIMG_UTIL_SSE2)
+        for (; i + 16 <= length; i += 16) {
+            __m128i* dstBlock {reinterpret_cast<__m128i*>(dst + i)};
+            const __m128i srcBlock {_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i))};
+            _mm_storeu_si128(dstBlock, _mm_or_si128(_mm_loadu_si128(dstBlock), srcBlock));
+        }
+#elif defined(CIMG_UTIL_NEON)
+        for (; i + 16 <= length; i += 16)
+            vst1q_u8(dst + i, vorrq_u8(vld1q_u8(dst + i), vld1q_u8(src + i)));
+#endif
+        for (; i < length; ++i)
+            dst[i] |= src[i];
+    }
+
+    // Splits interleaved 4-channel pixels into four planes.
+    void deinterleave4(const unsigned char* src,
+                       unsigned char* dst0,
+                       unsigned char* dst1,
+                       unsigned char* dst2,
+                       unsigned char* dst3,
+                       const size_t pixels)
+    {
+        size_t i {0};
+#if defined(CIMG_UTIL_SSE2)
+        for (; i + 16 <= pixels; i += 16) {
+            const __m128i* block {reinterpret_cast<const __m128i*>(src + i * 4)};
+            const __m128i a {_mm_loadu_si128(block)};
+            const __m128i b {_mm_loadu_si128(block + 1)};
+            const __m128i c {_mm_loadu_si128(block + 2)};
+            const __m128i d {_mm_loadu_si128(block + 3)};
+            // Three rounds of byte unpacking followed by a 64-bit unpack transposes the
+            // 16x4 byte matrix into four 16-byte channel rows.
+            const __m128i t0 {_mm_unpacklo_epi8(a, b)};
+            const __m128i t1 {_mm_unpackhi_epi8(a, b)};
+            const __m128i t2 {_mm_unpacklo_epi8(c, d)};
+            const __m128i t3 {_mm_unpackhi_epi8(c, d)};
+            const __m128i u0 {_mm_unpacklo_epi8(t0, t1)};
+            const __m128i u1 {_mm_unpackhi_epi8(t0, t1)};
+            const __m128i u2 {_mm_unpacklo_epi8(t2, t3)};
+            const __m128i u3 {_mm_unpackhi_epi8(t2, t3)};
+            const __m128i v0 {_mm_unpacklo_epi8(u0, u1)};
+            const __m128i v1 {_mm_unpackhi_epi8(u0, u1)};
+            const __m128i v2 {_mm_unpacklo_epi8(u2, u3)};
+            const __m128i v3 {_mm_unpackhi_epi8(u2, u3)};
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst0 + i), _mm_unpacklo_epi64(v0, v2));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst1 + i), _mm_unpackhi_epi64(v0, v2));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst2 + i), _mm_unpacklo_epi64(v1, v3));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst3 + i), _mm_unpackhi_epi64(v1, v3));
+        }
+#elif defined(CIMG_UTIL_NEON)
+        for (; i + 16 <= pixels; i += 16) {
+            const uint8x16x4_t block {vld4q_u8(src + i * 4)};
+            vst1q_u8(dst0 + i, block.val[0]);
+            vst1q_u8(dst1 + i, block.val[1]);
+            vst1q_u8(dst2 + i, block.val[2]);
+            vst1q_u8(dst3 + i, block.val[3]);
+        }
+#endif
+        for (; i < pixels; ++i) {
+            dst0[i] = src[i * 4 + 0];
+            dst1[i] = src[i * 4 + 1];
+            dst2[i] = src[i * 4 + 2];
+            dst3[i] = src[i * 4 + 3];
+        }
+    }
+
+    // Merges four planes into interleaved 4-channel pixels.
+    void interleave4(const unsigned char* src0,
+                     const unsigned char* src1,
+                     const unsigned char* src2,
+                     const unsigned char* src3,
+                     unsigned char* dst,
+                     const size_t pixels)
+    {
+        size_t i {0};
+#if defined(CIMG_UTIL_SSE2)
+        for (; i + 16 <= pixels; i += 16) {
+            const __m128i c0 {_mm_loadu_si128(reinterpret_cast<const __m128i*>(src0 + i))};
+            const __m128i c1 {_mm_loadu_si128(reinterpret_cast<const __m128i*>(src1 + i))};
+            const __m128i c2 {_mm_loadu_si128(reinterpret_cast<const __m128i*>(src2 + i))};
+            const __m128i c3 {_mm_loadu_si128(reinterpret_cast<const __m128i*>(src3 + i))};
+            const __m128i c01Lo {_mm_unpacklo_epi8(c0, c1)};
+            const __m128i c01Hi {_mm_unpackhi_epi8(c0, c1)};
+            const __m128i c23Lo {_mm_unpacklo_epi8(c2, c3)};
+            const __m128i c23Hi {_mm_unpackhi_epi8(c2, c3)};
+            __m128i* block {reinterpret_cast<__m128i*>(dst + i * 4)};
+            _mm_storeu_si128(block, _mm_unpacklo_epi16(c01Lo, c23Lo));
+            _mm_storeu_si128(block + 1, _mm_unpackhi_epi16(c01Lo, c23Lo));
+            _mm_storeu_si128(block + 2, _mm_unpacklo_epi16(c01Hi, c23Hi));
+            _mm_storeu_si128(block + 3, _mm_unpackhi_epi16(c01Hi, c23Hi));
+        }
+#elif defined(CIMG_UTIL_NEON)
+        for (; i + 16 <= pixels; i += 16) {
+            uint8x16x4_t block;
+            block.val[0] = vld1q_u8(src0 + i);
+            block.val[1] = vld1q_u8(src1 + i);
+            block.val[2] = vld1q_u8(src2 + i);
+            block.val[3] = vld1q_u8(src3 + i);
+            vst4q_u8(dst + i * 4, block);
+        }
+#endif
+        for (; i < pixels; ++i) {
+            dst[i * 4 + 0] = src0[i];
+            dst[i * 4 + 1] = src1[i];
+            dst[i * 4 + 2] = src2[i];
+            dst[i * 4 + 3] = src3[i];
+        }
+    }
+
+#if defined(CIMG_UTIL_SSE2)
+    // Exact division by 255 of 16-bit lanes holding values up to 255 * 255.
+    inline __m128i divideBy255(const __m128i value)
+    {
+        return _mm_srli_epi16(
+            _mm_add_epi16(_mm_add_epi16(value, _mm_set1_epi16(1)), _mm_srli_epi16(value, 8)), 8);
+    }
+#endif
+
+    // Composites the source onto the destination using the mask as alpha. Equivalent to
+    // CImg::draw_image() with an opacity of 1 and a mask max value of 255.
+    void blendRow(unsigned char* dst,
+                  const unsigned char* src,
+                  const unsigned char* mask,
+                  const size_t length)
+    {
+        size_t i {0};
+#if defined(CIMG_UTIL_SSE2)
+        const __m128i zero {_mm_setzero_si128()};
+        const __m128i max {_mm_set1_epi16(255)};
+        for (; i + 16 <= length; i += 16) {
+            const __m128i d {_mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i))};
+            const __m128i s {_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i))};
+            const __m128i m {_mm_loadu_si128(reinterpret_cast<const __m128i*>(mask + i))};
+            const __m128i mLo {_mm_unpacklo_epi8(m, zero)};
+            const __m128i mHi {_mm_unpackhi_epi8(m, zero)};
+            const __m128i mInvLo {_mm_sub_epi16(max, mLo)};
+            const __m128i mInvHi {_mm_sub_epi16(max, mHi)};
+            const __m128i lo {
+                divideBy255(_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), mLo),
+                                          _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), mInvLo)))};
+            const __m128i hi {
+                divideBy255(_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), mHi),
+                                          _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), mInvHi)))};
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+        }
+#elif defined(CIMG_UTIL_NEON)
+        for (; i + 16 <= length; i += 16) {
+            const uint8x16_t d {vld1q_u8(dst + i)};
+            const uint8x16_t s {vld1q_u8(src + i)};
+            const uint8x16_t m {vld1q_u8(mask + i)};
+            const uint8x16_t mInv {vmvnq_u8(m)};
+            uint16x8_t lo {vmlal_u8(vmull_u8(vget_low_u8(s), vget_low_u8(m)), vget_low_u8(d),
+                                    vget_low_u8(mInv))};
+            uint16x8_t hi {vmlal_u8(vmull_u8(vget_high_u8(s), vget_high_u8(m)), vget_high_u8(d),
+                                    vget_high_u8(mInv))};
+            // Exact division by 255: (x + 1 + (x >> 8)) >> 8.
+            lo = vshrq_n_u16(vaddq_u16(vaddq_u16(lo, vdupq_n_u16(1)), vshrq_n_u16(lo, 8)), 8);
+            hi = vshrq_n_u16(vaddq_u16(vaddq_u16(hi, vdupq_n_u16(1)), vshrq_n_u16(hi, 8)), 8);
+            vst1q_u8(dst + i, vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+        }
+#endif
+        for (; i < length; ++i) {
+            dst[i] =
+                static_cast<unsigned char>((src[i] * mask[i] + dst[i] * (255 - mask[i])) / 255);
+        }
+    }
+
+    // Applies a box filter along one axis of a single plane. This gives identical results to
+    // CImg::boxfilter() with Neumann boundary conditions for integer box sizes, but uses
+    // integer running sums. If the box size is even, CImg weights the two pixels just outside
+    // the window by half, which is why the sums are kept at twice their actual value.
+    void boxBlurLine(unsigned char* line,
+                     unsigned char* original,
+                     const int length,
+                     const int stride,
+                     const int boxSize)
+    {
+        const int halfWindow {(boxSize - 1) / 2};
+        const bool evenBoxSize {2 * halfWindow + 1 < boxSize};
+        const unsigned int divisor {2u * static_cast<unsigned int>(boxSize)};
+        const int last {length - 1};
+
+        for (int i {0}; i < length; ++i)
+            original[i] = line[i * stride];
+
+        unsigned int sum {0};
+        for (int i {-halfWindow}; i <= halfWindow; ++i)
+            sum += original[std::clamp(i, 0, last)];
+
+        for (int i {0}; i < length; ++i) {
+            unsigned int numerator {sum * 2};
+            if (evenBoxSize) {
+                numerator += original[std::clamp(i - halfWindow - 1, 0, last)] +
+                             original[std::clamp(i + halfWindow + 1, 0, last)];
+            }
+            line[i * stride] = static_cast<unsigned char>(numerator / divisor);
+            sum += original[std::clamp(i + halfWindow + 1, 0, last)];
+            sum -= original[std::clamp(i - halfWindow, 0, last)];
+        }
+    }
+
+    // Vertical box filter, processing all columns of a row at once so the work can be
+    // vectorized across the row. The results are identical to boxBlurLine().
+    void boxBlurColumns(unsigned char* plane,
+                        std::vector<unsigned char>& original,
+                        std::vector<float>& sums,
+                        const int width,
+                        const int height,
+                        const int boxSize)
+    {
+        const int halfWindow {(boxSize - 1) / 2};
+        const bool evenBoxSize {2 * halfWindow + 1 < boxSize};
+        const float divisor {2.0f * static_cast<float>(boxSize)};
+        const int last {height - 1};
+
+        std::memcpy(&original[0], plane, original.size());
+        std::fill(sums.begin(), sums.end(), 0.0f);
+
+        auto rowPtr = [&](const int row) {
+            return &original[static_cast<size_t>(std::clamp(row, 0, last)) * width];
+        };
+
+        for (int i {-halfWindow}; i <= halfWindow; ++i) {
+            const unsigned char* row {rowPtr(i)};
+            for (int x {0}; x < width; ++x)
+                sums[x] += row[x];
+        }
+
+        for (int y {0}; y < height; ++y) {
+            unsigned char* dst {plane + static_cast<size_t>(y) * width};
+            const unsigned char* prev {rowPtr(y - halfWindow - 1)};
+            const unsigned char* next {rowPtr(y + halfWindow + 1)};
+            const unsigned char* leaving {rowPtr(y - halfWindow)};
+            int x {0};
+#if defined(CIMG_UTIL_SSE2)
+            const __m128i zero {_mm_setzero_si128()};
+            const __m128 divisorVec {_mm_set1_ps(divisor)};
+            const __m128 reciprocal {_mm_set1_ps(1.0f / divisor)};
+            const __m128 one {_mm_set1_ps(1.0f)};
+            auto loadFloats = [&zero](const unsigned char* src) {
+                int packed;
+                std::memcpy(&packed, src, sizeof(packed));
+                return _mm_cvtepi32_ps(_mm_unpacklo_epi16(
+                    _mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero), zero));
+            };
+            for (; x + 4 <= width; x += 4) {
+                const __m128 sum {_mm_loadu_ps(&sums[x])};
+                const __m128 nextValues {loadFloats(next + x)};
+                __m128 numerator {_mm_add_ps(sum, sum)};
+                if (evenBoxSize)
+                    numerator = _mm_add_ps(numerator, _mm_add_ps(loadFloats(prev + x), nextValues));
+                // All values are integers below 2^24 so the float arithmetic is exact, apart
+                // from the reciprocal which is compensated for by checking the remainder.
+                __m128 quotient {
+                    _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(numerator, reciprocal)))};
+                const __m128 remainder {_mm_sub_ps(numerator, _mm_mul_ps(quotient, divisorVec))};
+                quotient =
+                    _mm_add_ps(quotient, _mm_and_ps(_mm_cmpge_ps(remainder, divisorVec), one));
+                quotient = _mm_sub_ps(
+                    quotient, _mm_and_ps(_mm_cmplt_ps(remainder, _mm_setzero_ps()), one));
+                const __m128i result {_mm_cvttps_epi32(quotient)};
+                const __m128i packed {_mm_packus_epi16(_mm_packs_epi32(result, zero), zero)};
+                const int resultBytes {_mm_cvtsi128_si32(packed)};
+                std::memcpy(dst + x, &resultBytes, sizeof(resultBytes));
+                _mm_storeu_ps(&sums[x],
+                              _mm_sub_ps(_mm_add_ps(sum, nextValues), loadFloats(leaving + x)));
+            }
+#elif defined(CIMG_UTIL_NEON)
+            const float32x4_t divisorVec {vdupq_n_f32(divisor)};
+            const float32x4_t reciprocal {vdupq_n_f32(1.0f / divisor)};
+            const float32x4_t one {vdupq_n_f32(1.0f)};
+            auto loadFloats = [](const unsigned char* src) {
+                uint32_t packed;
+                std::memcpy(&packed, src, sizeof(packed));
+                const uint16x4_t widened {
+                    vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(packed))))};
+                return vcvtq_f32_u32(vmovl_u16(widened));
+            };
+            for (; x + 4 <= width; x += 4) {
+                const float32x4_t sum {vld1q_f32(&sums[x])};
+                const float32x4_t nextValues {loadFloats(next + x)};
+                float32x4_t numerator {vaddq_f32(sum, sum)};
+                if (evenBoxSize)
+                    numerator = vaddq_f32(numerator, vaddq_f32(loadFloats(prev + x), nextValues));
+                float32x4_t quotient {
+                    vcvtq_f32_u32(vcvtq_u32_f32(vmulq_f32(numerator, reciprocal)))};
+                const float32x4_t remainder {vmlsq_f32(numerator, quotient, divisorVec)};
+                quotient = vaddq_f32(quotient, vreinterpretq_f32_u32(vandq_u32(
+                                                   vcgeq_f32(remainder, divisorVec),
+                                                   vreinterpretq_u32_f32(one))));
+                quotient = vsubq_f32(quotient, vreinterpretq_f32_u32(vandq_u32(
+                                                   vcltq_f32(remainder, vdupq_n_f32(0.0f)),
+                                                   vreinterpretq_u32_f32(one))));
+                const uint16x4_t narrowed {vmovn_u32(vcvtq_u32_f32(quotient))};
+                const uint8x8_t bytes {vmovn_u16(vcombine_u16(narrowed, narrowed))};
+                const uint32_t resultBytes {vget_lane_u32(vreinterpret_u32_u8(bytes), 0)};
+                std::memcpy(dst + x, &resultBytes, sizeof(resultBytes));
+                vst1q_f32(&sums[x], vsubq_f32(vaddq_f32(sum, nextValues), loadFloats(leaving + x)));
+            }
+#endif
+            for (; x < width; ++x) {
+                const unsigned int sum {static_cast<unsigned int>(sums[x])};
+                unsigned int numerator {sum * 2};
+                if (evenBoxSize)
+                    numerator += prev[x] + next[x];
+                dst[x] = static_cast<unsigned char>(numerator /
+                                                    static_cast<unsigned int>(divisor));
+                sums[x] = static_cast<float>(sum + next[x] - leaving[x]);
+            }
+        }
+    }
+
+    // Blurs a single plane, equivalent to CImg::blur_box() for the same box size.
+    void boxBlurPlane(unsigned char* plane,
+                      const int width,
+                      const int height,
+                      const int boxSize,
+                      const unsigned int iterations)
+    {
+        if (boxSize <= 1 || iterations == 0)
+            return;
+
+        // As for CImg, all horizontal iterations are applied before the vertical ones.
+        if (width > 1) {
+            std::vector<unsigned char> original(width);
+            for (unsigned int i {0}; i < iterations; ++i) {
+                for (int y {0}; y < height; ++y)
+                    boxBlurLine(plane + static_cast<size_t>(y) * width, &original[0], width, 1,
+                                boxSize);
+            }
+        }
+
+        if (height > 1) {
+            std::vector<unsigned char> original(static_cast<size_t>(width) * height);
+            std::vector<float> sums(width);
+            for (unsigned int i {0}; i < iterations; ++i)
+                boxBlurColumns(plane, original, sums, width, height, boxSize);
+        }
+    }
+
+    // Counts the number of leading and trailing zero bytes, using the same scan ranges as
+    // the original per-row and per-column summing (the trailing scan never reaches index 0).
+    void countZeroEdges(const std::vector<unsigned char>& values, int& leading, int& trailing)
+    {
+        const int size {static_cast<int>(values.size())};
+        leading = 0;
+        trailing = 0;
+        for (int i {0}; i < size && values[i] == 0; ++i)
+            ++leading;
+        for (int i {size - 1}; i > 0 && values[i] == 0; --i)
+            ++trailing;
+    }
+
+    // Finds the number of rows and columns along each edge where the selected channels are
+    // all zero. Rows are checked directly while columns are checked by OR'ing all rows into
+    // a single accumulator row, as scanning columns in a planar image is very cache unfriendly.
+    void getZeroEdges(const cimg_library::CImg<unsigned char>& image,
+                      const int firstChannel,
+                      const int lastChannel,
+                      const bool checkColumns,
+                      int& rowsUpper,
+                      int& rowsLower,
+                      int& columnsLeft,
+                      int& columnsRight)
+    {
+        const int width {image.width()};
+        const int height {image.height()};
+
+        auto isZeroRow = [&](const int row) {
+            for (int c {firstChannel}; c <= lastChannel; ++c) {
+                if (!isZero(image.data(0, row, 0, c), width))
+                    return false;
+            }
+            return true;
+        };
+
+        rowsUpper = 0;
+        rowsLower = 0;
+        columnsLeft = 0;
+        columnsRight = 0;
+
+        for (int i {height - 1}; i > 0 && isZeroRow(i); --i)
+            ++rowsUpper;
+        for (int i {0}; i < height && isZeroRow(i); ++i)
+            ++rowsLower;
+
+        if (!checkColumns)
+            return;
+
+        std::vector<unsigned char> columns(width, 0);
+        // Rows that are completely zero can't affect the accumulated result.
+        for (int i {rowsLower}; i < height - rowsUpper; ++i) {
+            for (int c {firstChannel}; c <= lastChannel; ++c)
+                accumulateOr(&columns[0], image.data(0, i, 0, c), width);
+        }
+
+        countZeroEdges(columns, columnsLeft, columnsRight);
+    }
+
+} // namespace
+
 namespace Utils
 {
     namespace CImg
@@ -16,28 +486,26 @@ namespace Utils
                                cimg_library::CImg<unsigned char>& image)
         {
             // CImg does not interleave pixels as in BGRABGRABGRA so a conversion is required.
-            int counter {0};
+            const size_t width {static_cast<size_t>(image.width())};
             for (int r {0}; r < image.height(); ++r) {
-                for (int c {0}; c < image.width(); ++c) {
-                    image(c, r, 0, 0) = imageBGRA[counter + 0];
-                    image(c, r, 0, 1) = imageBGRA[counter + 1];
-                    image(c, r, 0, 2) = imageBGRA[counter + 2];
-                    image(c, r, 0, 3) = imageBGRA[counter + 3];
-                    counter += 4;
-                }
+                deinterleave4(&imageBGRA[r * width * 4], image.data(0, r, 0, 0),
+                              image.data(0, r, 0, 1), image.data(0, r, 0, 2),
+                              image.data(0, r, 0, 3), width);
             }
         }
 
         void convertCImgToBGRA(const cimg_library::CImg<unsigned char>& image,
                                std::vector<unsigned char>& imageBGRA)
         {
+            const size_t width {static_cast<size_t>(image.width())};
+            size_t offset {imageBGRA.size()};
+            imageBGRA.resize(offset + width * image.height() * 4);
+
             for (int r {image.height() - 1}; r >= 0; --r) {
-                for (int c {0}; c < image.width(); ++c) {
-                    imageBGRA.emplace_back((unsigned char)image(c, r, 0, 0));
-                    imageBGRA.emplace_back((unsigned char)image(c, r, 0, 1));
-                    imageBGRA.emplace_back((unsigned char)image(c, r, 0, 2));
-                    imageBGRA.emplace_back((unsigned char)image(c, r, 0, 3));
-                }
+                interleave4(image.data(0, r, 0, 0), image.data(0, r, 0, 1),
+                            image.data(0, r, 0, 2), image.data(0, r, 0, 3), &imageBGRA[offset],
+                            width);
+                offset += width * 4;
             }
         }
 
@@ -45,28 +513,26 @@ namespace Utils
                                cimg_library::CImg<unsigned char>& image)
         {
             // CImg does not interleave pixels as in RGBARGBARGBA so a conversion is required.
-            int counter {0};
+            const size_t width {static_cast<size_t>(image.width())};
             for (int r {0}; r < image.height(); ++r) {
-                for (int c {0}; c < image.width(); ++c) {
-                    image(c, r, 0, 0) = imageRGBA[counter + 2];
-                    image(c, r, 0, 1) = imageRGBA[counter + 1];
-                    image(c, r, 0, 2) = imageRGBA[counter + 0];
-                    image(c, r, 0, 3) = imageRGBA[counter + 3];
-                    counter += 4;
-                }
+                deinterleave4(&imageRGBA[r * width * 4], image.data(0, r, 0, 2),
+                              image.data(0, r, 0, 1), image.data(0, r, 0, 0),
+                              image.data(0, r, 0, 3), width);
             }
         }
 
         void convertCImgToRGBA(const cimg_library::CImg<unsigned char>& image,
                                std::vector<unsigned char>& imageRGBA)
         {
+            const size_t width {static_cast<size_t>(image.width())};
+            size_t offset {imageRGBA.size()};
+            imageRGBA.resize(offset + width * image.height() * 4);
+
             for (int r {image.height() - 1}; r >= 0; --r) {
-                for (int c {0}; c < image.width(); ++c) {
-                    imageRGBA.emplace_back((unsigned char)image(c, r, 0, 2));
-                    imageRGBA.emplace_back((unsigned char)image(c, r, 0, 1));
-                    imageRGBA.emplace_back((unsigned char)image(c, r, 0, 0));
-                    imageRGBA.emplace_back((unsigned char)image(c, r, 0, 3));
-                }
+                interleave4(image.data(0, r, 0, 2), image.data(0, r, 0, 1),
+                            image.data(0, r, 0, 0), image.data(0, r, 0, 3), &imageRGBA[offset],
+                            width);
+                offset += width * 4;
             }
         }
 
@@ -77,48 +543,14 @@ namespace Utils
             if (image.spectrum() != 4)
                 return;
 
-            double pixelValueSum {0.0};
             int rowCounterTop {0};
             int rowCounterBottom {0};
-            unsigned int columnCounterLeft {0};
-            unsigned int columnCounterRight {0};
+            int columnCounterLeft {0};
+            int columnCounterRight {0};
 
             // Count the number of rows and columns that are completely transparent.
-            for (int i {image.height() - 1}; i > 0; --i) {
-                cimg_library::CImg<unsigned char> imageRow = image.get_rows(i, i);
-                pixelValueSum = imageRow.get_shared_channel(3).sum();
-                if (pixelValueSum == 0.0)
-                    ++rowCounterTop;
-                else
-                    break;
-            }
-
-            for (int i {0}; i < image.height(); ++i) {
-                cimg_library::CImg<unsigned char> imageRow = image.get_rows(i, i);
-                pixelValueSum = imageRow.get_shared_channel(3).sum();
-                if (pixelValueSum == 0.0)
-                    ++rowCounterBottom;
-                else
-                    break;
-            }
-
-            for (int i {0}; i < image.width(); ++i) {
-                cimg_library::CImg<unsigned char> imageColumn = image.get_columns(i, i);
-                pixelValueSum = imageColumn.get_shared_channel(3).sum();
-                if (pixelValueSum == 0.0)
-                    ++columnCounterLeft;
-                else
-                    break;
-            }
-
-            for (int i {image.width() - 1}; i > 0; --i) {
-                cimg_library::CImg<unsigned char> imageColumn = image.get_columns(i, i);
-                pixelValueSum = imageColumn.get_shared_channel(3).sum();
-                if (pixelValueSum == 0.0)
-                    ++columnCounterRight;
-                else
-                    break;
-            }
+            getZeroEdges(image, 3, 3, true, rowCounterTop, rowCounterBottom, columnCounterLeft,
+                         columnCounterRight);
 
             imageCoords[0] = columnCounterLeft;
             imageCoords[1] = rowCounterTop;
@@ -132,48 +564,13 @@ namespace Utils
             if (image.spectrum() != 4)
                 return;
 
-            double pixelValueSum {0.0};
-            int rowCounterTop {0};
-            int rowCounterBottom {0};
-            unsigned int columnCounterLeft {0};
-            unsigned int columnCounterRight {0};
-
-            // Count the number of rows and columns that are completely transparent.
-            for (int i {image.height() - 1}; i > 0; --i) {
-                cimg_library::CImg<unsigned char> imageRow = image.get_rows(i, i);
-                pixelValueSum = imageRow.get_shared_channel(3).sum();
-                if (pixelValueSum == 0.0)
-                    ++rowCounterTop;
-                else
-                    break;
-            }
-
-            for (int i {0}; i < image.height(); ++i) {
-                cimg_library::CImg<unsigned char> imageRow = image.get_rows(i, i);
-                pixelValueSum = imageRow.get_shared_channel(3).sum();
-                if (pixelValueSum == 0.0)
-                    ++rowCounterBottom;
-                else
-                    break;
-            }
-
-            for (int i {0}; i < image.width(); ++i) {
-                cimg_library::CImg<unsigned char> imageColumn = image.get_columns(i, i);
-                pixelValueSum = imageColumn.get_shared_channel(3).sum();
-                if (pixelValueSum == 0.0)
-                    ++columnCounterLeft;
-                else
-                    break;
-            }
+            int imageCoords[4] {};
+            getTransparentPaddingCoords(image, imageCoords);
 
-            for (int i {image.width() - 1}; i > 0; --i) {
-                cimg_library::CImg<unsigned char> imageColumn = image.get_columns(i, i);
-                pixelValueSum = imageColumn.get_shared_channel(3).sum();
-                if (pixelValueSum == 0.0)
-                    ++columnCounterRight;
-                else
-                    break;
-            }
+            const int columnCounterLeft {imageCoords[0]};
+            const int rowCounterTop {imageCoords[1]};
+            const int columnCounterRight {imageCoords[2]};
+            const int rowCounterBottom {imageCoords[3]};
 
             if (rowCounterTop > 0)
                 image.crop(0, 0, 0, 3, image.width() - 1, image.height() - 1 - rowCounterTop, 0, 0);
@@ -191,31 +588,13 @@ namespace Utils
 
         void cropLetterboxes(cimg_library::CImg<unsigned char>& image)
         {
-            double pixelValueSum {0.0};
             int rowCounterUpper {0};
             int rowCounterLower {0};
+            int unused {0};
 
-            // Count the number of rows that are pure black.
-            for (int i {image.height() - 1}; i > 0; --i) {
-                cimg_library::CImg<unsigned char> imageRow = image.get_rows(i, i);
-                // Ignore the alpha channel.
-                imageRow.channels(0, 2);
-                pixelValueSum = imageRow.sum();
-                if (pixelValueSum == 0.0)
-                    ++rowCounterUpper;
-                else
-                    break;
-            }
-
-            for (int i {0}; i < image.height(); ++i) {
-                cimg_library::CImg<unsigned char> imageRow = image.get_rows(i, i);
-                imageRow.channels(0, 2);
-                pixelValueSum = imageRow.sum();
-                if (pixelValueSum == 0.0)
-                    ++rowCounterLower;
-                else
-                    break;
-            }
+            // Count the number of rows that are pure black, ignoring the alpha channel.
+            getZeroEdges(image, 0, std::min(image.spectrum(), 3) - 1, false, rowCounterUpper,
+                         rowCounterLower, unused, unused);
 
             if (rowCounterUpper > 0)
                 image.crop(0, 0, 0, 3, image.width() - 1, image.height() - 1 - rowCounterUpper, 0,
@@ -227,32 +606,20 @@ namespace Utils
 
         void cropPillarboxes(cimg_library::CImg<unsigned char>& image)
         {
-            double pixelValueSum {0.0};
-            unsigned int columnCounterLeft {0};
-            unsigned int columnCounterRight {0};
-
-            // Count the number of columns that are pure black.
-            for (int i {0}; i < image.width(); ++i) {
-                cimg_library::CImg<unsigned char> imageColumn = image.get_columns(i, i);
-                // Ignore the alpha channel.
-                imageColumn.channels(0, 2);
-                pixelValueSum = imageColumn.sum();
-                if (pixelValueSum == 0.0)
-                    ++columnCounterLeft;
-                else
-                    break;
-            }
+            const int width {image.width()};
+            const int lastChannel {std::min(image.spectrum(), 3) - 1};
+            int columnCounterLeft {0};
+            int columnCounterRight {0};
 
-            for (int i {image.width() - 1}; i > 0; --i) {
-                cimg_library::CImg<unsigned char> imageColumn = image.get_columns(i, i);
-                imageColumn.channels(0, 2);
-                pixelValueSum = imageColumn.sum();
-                if (pixelValueSum == 0.0)
-                    ++columnCounterRight;
-                else
-                    break;
+            // Count the number of columns that are pure black, ignoring the alpha channel.
+            std::vector<unsigned char> columns(width, 0);
+            for (int i {0}; i < image.height(); ++i) {
+                for (int c {0}; c <= lastChannel; ++c)
+                    accumulateOr(&columns[0], image.data(0, i, 0, c), width);
             }
 
+            countZeroEdges(columns, columnCounterLeft, columnCounterRight);
+
             if (columnCounterLeft > 0)
                 image.crop(columnCounterLeft, 0, 0, 3, image.width() - 1, image.height() - 1, 0, 0);
 
@@ -275,32 +642,61 @@ namespace Utils
             cimg_library::CImg<unsigned char> shadowImage(
                 image.width() + shadowDistance * 3, image.height() + shadowDistance * 3, 1, 4, 0);
 
-            // Create a mask image.
-            cimg_library::CImg<unsigned char> maskImage(image.width(), image.height(), 1, 4, 0);
-            maskImage.draw_image(0, 0, image);
-            // Fill the RGB channels with white so we end up with a simple mask.
-            maskImage.get_shared_channels(0, 2).fill(255);
-
-            // Make a black outline of the source image as a basis for the shadow.
-            shadowImage.draw_image(shadowDistance, shadowDistance, image);
-            shadowImage.get_shared_channels(0, 2).fill(0);
+            // Make a black outline of the source image as a basis for the shadow. The RGB
+            // channels are all zero so only the alpha channel needs to be populated and blurred.
+            cimg_library::CImg<unsigned char> shadowImageAlpha(shadowImage.get_shared_channel(3));
+            shadowImageAlpha.draw_image(shadowDistance, shadowDistance,
+                                        image.get_shared_channel(3));
             // Lower the transparency and apply the blur.
-            shadowImage.get_shared_channel(3) /= transparency;
-            shadowImage.blur_box(static_cast<const float>(shadowDistance),
-                                 static_cast<const float>(shadowDistance), 1, true, iterations);
-
-            // Add the mask to the alpha channel of the shadow image.
-            shadowImage.get_shared_channel(3).draw_image(0, 0, maskImage.get_shared_channels(0, 0),
-                                                         maskImage.get_shared_channel(3), 1, 255);
-            // Draw the source image on top of the shadow image.
-            shadowImage.draw_image(0, 0, image.get_shared_channels(0, 2),
-                                   image.get_shared_channel(3), 1, 255);
+            shadowImageAlpha /= transparency;
+            boxBlurPlane(shadowImageAlpha.data(), shadowImageAlpha.width(),
+                         shadowImageAlpha.height(), static_cast<int>(shadowDistance), iterations);
+
+            // Add the source image alpha channel as a mask to the alpha channel of the shadow
+            // image, and then draw the source image on top of the shadow image.
+            const cimg_library::CImg<unsigned char> maskImage(image.width(), image.height(), 1, 1,
+                                                              255);
+            alphaBlend(shadowImageAlpha, maskImage, image.get_shared_channel(3), 0, 0);
+            alphaBlend(shadowImage, image.get_shared_channels(0, 2), image.get_shared_channel(3), 0,
+                       0);
+
             // Remove the any unused space that we added to leave room for the shadow.
             removeTransparentPadding(shadowImage);
 
             image = shadowImage;
         }
 
+        void alphaBlend(cimg_library::CImg<unsigned char>& image,
+                        const cimg_library::CImg<unsigned char>& sprite,
+                        const cimg_library::CImg<unsigned char>& mask,
+                        int xPos,
+                        int yPos)
+        {
+            if (image.is_empty() || sprite.is_empty() || mask.width() != sprite.width() ||
+                mask.height() != sprite.height())
+                return;
+
+            // Clip the sprite against the image boundaries.
+            const int spriteX {std::max(0, -xPos)};
+            const int spriteY {std::max(0, -yPos)};
+            const int imageX {std::max(0, xPos)};
+            const int imageY {std::max(0, yPos)};
+            const int width {std::min(sprite.width() - spriteX, image.width() - imageX)};
+            const int height {std::min(sprite.height() - spriteY, image.height() - imageY)};
+            const int channels {std::min(sprite.spectrum(), image.spectrum())};
+
+            if (width <= 0 || height <= 0)
+                return;
+
+            for (int c {0}; c < channels; ++c) {
+                for (int y {0}; y < height; ++y) {
+                    blendRow(image.data(imageX, imageY + y, 0, c),
+                             sprite.data(spriteX, spriteY + y, 0, c),
+                             mask.data(spriteX, spriteY + y, 0, 0), width);
+                }
+            }
+        }
+
     } // namespace CImg
 
 } // namespace Utils
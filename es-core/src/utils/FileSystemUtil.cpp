@@ -660,6 +660,22 @@ namespace Utils
             }
         }
 
+        std::filesystem::file_time_type getLastWriteTime(const std::string& path)
+        {
+            std::error_code errorCode;
+#if defined(_WIN64)
+            const std::filesystem::file_time_type writeTime {std::filesystem::last_write_time(
+                Utils::String::stringToWideString(path), errorCode)};
+#else
+            const std::filesystem::file_time_type writeTime {
+                std::filesystem::last_write_time(path, errorCode)};
+#endif
+            if (errorCode)
+                return std::filesystem::file_time_type::min();
+
+            return writeTime;
+        }
+
         std::string expandHomePath(const std::string& path)
         {
             // Expand home path if ~ is used.
@@ -52,6 +52,8 @@ namespace Utils
         std::string getStem(const std::string& path);
         std::string getExtension(const std::string& path);
         long getFileSize(const std::filesystem::path& path);
+        // Returns file_time_type::min() if the file does not exist or can't be accessed.
+        std::filesystem::file_time_type getLastWriteTime(const std::string& path);
         std::string expandHomePath(const std::string& path);
         std::string resolveRelativePath(const std::string& path,
                                         const std::string& relativeTo,
@@ -5,6 +5,9 @@
 //
 //  Low-level string functions.
 //
+//  The case conversions use a fast path for ASCII input which processes 16 bytes at a time
+//  using SSE2 or NEON when available, and only use ICU for strings with non-ASCII characters.
+//
 
 // Suppress codecvt deprecation warnings.
 #if defined(_MSC_VER) // MSVC compiler.
@@ -23,6 +26,124 @@
 #include <algorithm>
 #include <cstdarg>
 #include <locale>
+#include <mutex>
+#include <unordered_map>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STRING_UTIL_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define STRING_UTIL_NEON
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+    // The number of converted strings to cache for input that contains non-ASCII characters.
+    constexpr size_t MAX_CASE_CACHE_ENTRIES {1024};
+
+    struct CaseCache {
+        std::mutex mutex;
+        std::unordered_map<std::string, std::string> strings;
+    };
+
+    // Turkish and Azerbaijani have dotted and dotless variants of the letter I which ICU
+    // handles when using the default locale, so the ASCII fast path can't be used for these.
+    bool useASCIICaseMap()
+    {
+        static const bool useASCII {[] {
+            const std::string language {icu::Locale::getDefault().getLanguage()};
+            return language != "tr" && language != "az";
+        }()};
+        return useASCII;
+    }
+
+    // Converts the ASCII letters in place, to uppercase if upper is set and otherwise to
+    // lowercase. Returns false if a non-ASCII byte is found, in which case the string has
+    // only been partially converted.
+    bool asciiCaseMap(std::string& stringArg, const bool upper)
+    {
+        char* data {&stringArg[0]};
+        const size_t length {stringArg.length()};
+        const char first {upper ? 'a' : 'A'};
+        const char last {upper ? 'z' : 'Z'};
+        size_t i {0};
+
+#if defined(STRING_UTIL_SSE2)
+        const __m128i lowerBound {_mm_set1_epi8(first - 1)};
+        const __m128i upperBound {_mm_set1_epi8(last + 1)};
+        const __m128i caseBit {_mm_set1_epi8(0x20)};
+        for (; i + 16 <= length; i += 16) {
+            __m128i block {_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i))};
+            if (_mm_movemask_epi8(block) != 0)
+                return false;
+            const __m128i letters {_mm_and_si128(_mm_cmpgt_epi8(block, lowerBound),
+                                                 _mm_cmplt_epi8(block, upperBound))};
+            block = _mm_xor_si128(block, _mm_and_si128(letters, caseBit));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), block);
+        }
+#elif defined(STRING_UTIL_NEON)
+        const uint8x16_t lowerBound {vdupq_n_u8(static_cast<uint8_t>(first))};
+        const uint8x16_t upperBound {vdupq_n_u8(static_cast<uint8_t>(last))};
+        const uint8x16_t caseBit {vdupq_n_u8(0x20)};
+        for (; i + 16 <= length; i += 16) {
+            uint8_t* block {reinterpret_cast<uint8_t*>(data + i)};
+            uint8x16_t chars {vld1q_u8(block)};
+            const uint64x2_t highBits {vreinterpretq_u64_u8(vshrq_n_u8(chars, 7))};
+            if ((vgetq_lane_u64(highBits, 0) | vgetq_lane_u64(highBits, 1)) != 0)
+                return false;
+            const uint8x16_t letters {
+                vandq_u8(vcgeq_u8(chars, lowerBound), vcleq_u8(chars, upperBound))};
+            chars = veorq_u8(chars, vandq_u8(letters, caseBit));
+            vst1q_u8(block, chars);
+        }
+#endif
+        for (; i < length; ++i) {
+            if (static_cast<unsigned char>(data[i]) > 0x7F)
+                return false;
+            if (data[i] >= first && data[i] <= last)
+                data[i] ^= 0x20;
+        }
+
+        return true;
+    }
+
+    // Converts the string using ICU. As the same names are often converted over and over,
+    // for example when sorting, the results are cached.
+    std::string icuCaseMap(const std::string& stringArg, const bool upper)
+    {
+        static CaseCache caches[2];
+        CaseCache& cache {caches[upper ? 1 : 0]};
+
+        {
+            std::unique_lock<std::mutex> lock {cache.mutex};
+            auto it = cache.strings.find(stringArg);
+            if (it != cache.strings.end())
+                return (*it).second;
+        }
+
+        // IMPORTANT: On Windows specifically the StringPiece constructor which is implicitly
+        // called by fromUTF8() crashes the application if a std::string is passed as the
+        // argument. It's therefore necessary to use c_str() to work around this issue.
+        // This behavior has been observed with ICU 75.1.
+        icu::UnicodeString convert {icu::UnicodeString::fromUTF8(stringArg.c_str())};
+        std::string result;
+
+        if (upper)
+            convert.toUpper();
+        else
+            convert.toLower();
+        convert.toUTF8String(result);
+
+        std::unique_lock<std::mutex> lock {cache.mutex};
+        if (cache.strings.size() >= MAX_CASE_CACHE_ENTRIES)
+            cache.strings.clear();
+        cache.strings.emplace(stringArg, result);
+
+        return result;
+    }
+
+} // namespace
 
 namespace Utils
 {
@@ -183,24 +304,22 @@ namespace Utils
 
         std::string toLower(const std::string& stringArg)
         {
-            // IMPORTANT: On Windows specifically the StringPiece constructor which is implicitly
-            // called by fromUTF8() crashes the application if a std::string is passed as the
-            // argument. It's therefore necessary to use c_str() to work around this issue.
-            // This behavior has been observed with ICU 75.1.
-            icu::UnicodeString convert {icu::UnicodeString::fromUTF8(stringArg.c_str())};
-            std::string stringLower;
+            std::string stringLower {stringArg};
 
-            convert.toLower();
-            return convert.toUTF8String(stringLower);
+            if (useASCIICaseMap() && asciiCaseMap(stringLower, false))
+                return stringLower;
+
+            return icuCaseMap(stringArg, false);
         }
 
         std::string toUpper(const std::string& stringArg)
         {
-            icu::UnicodeString convert {icu::UnicodeString::fromUTF8(stringArg.c_str())};
-            std::string stringUpper;
+            std::string stringUpper {stringArg};
 
-            convert.toUpper();
-            return convert.toUTF8String(stringUpper);
+            if (useASCIICaseMap() && asciiCaseMap(stringUpper, true))
+                return stringUpper;
+
+            return icuCaseMap(stringArg, true);
         }
 
         std::string toCapitalized(const std::string& stringArg)
@@ -296,6 +415,31 @@ namespace Utils
             return result;
         }
 
+        std::string escapeJSON(const std::string& stringArg)
+        {
+            std::string escaped;
+            escaped.reserve(stringArg.size());
+
+            for (const char character : stringArg) {
+                if (character == '"' || character == '\\') {
+                    escaped.push_back('\\');
+                    escaped.push_back(character);
+                }
+                else if (static_cast<unsigned char>(character) < 0x20) {
+                    // Control characters are not allowed in JSON strings.
+                    static const char hexDigits[] {"0123456789abcdef"};
+                    escaped.append("\\u00");
+                    escaped.push_back(hexDigits[(character >> 4) & 0x0F]);
+                    escaped.push_back(hexDigits[character & 0x0F]);
+                }
+                else {
+                    escaped.push_back(character);
+                }
+            }
+
+            return escaped;
+        }
+
         std::string format(const std::string stringArg, ...)
         {
             if (stringArg.empty())
@@ -35,6 +35,8 @@ namespace Utils
         std::string replace(const std::string& stringArg,
                             const std::string& from,
                             const std::string& to);
+        // Escapes the string for use as a JSON string value.
+        std::string escapeJSON(const std::string& stringArg);
         std::string format(const std::string stringArg, ...);
         std::wstring stringToWideString(const std::string& stringArg);
         std::string wideStringToString(const std::wstring& stringArg);
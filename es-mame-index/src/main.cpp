@@ -0,0 +1,30 @@
+//  SPDX-License-Identifier: MIT
+//
+//  ES-DE Frontend
+//  main.cpp
+//
+//  Build utility that compiles the MAME XML data files into the binary index file which is
+//  memory mapped by MameNames at runtime.
+//
+
+#include "MameNames.h"
+
+#include <iostream>
+
+int main(int argc, char* argv[])
+{
+    if (argc != 5) {
+        std::cout << "Usage: es-mame-index <names file> <BIOSes file> <devices file> <index file>"
+                  << std::endl;
+        return 1;
+    }
+
+    std::string errorMessage;
+
+    if (!MameNames::compileIndex(argv[1], argv[2], argv[3], argv[4], errorMessage)) {
+        std::cerr << "Error: " << errorMessage << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -6,6 +6,7 @@
 #
 #  As input, this script takes the MAME driver information XML file from the official
 #  MAME release and generates the files mamebioses.xml, mamedevices.xml and mamenames.xml.
+#  These are compiled into the binary index file mameindex.bin by es-mame-index at build time.
 #
 #  There is not much error checking going on here, this script is not intended to be run
 #  by the end user.